@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file AdaptiveDopri.h
+ * @brief Adaptive-step Dormand-Prince 5(4) for first-order systems of fixed size.
+ *
+ * Uses the embedded 4th-order solution for error control (the capability noted as planned
+ * for the real-time integrator) and the first-same-as-last property, so each accepted step
+ * costs six derivative evaluations.
+ */
+
+/** Difference between the 5th- and embedded 4th-order weights. */
+inline constexpr double e_dp[7] = {
+    35. / 384 - 5179. / 57600,
+    0,
+    500. / 1113 - 7571. / 16695,
+    125. / 192 - 393. / 640,
+    -2187. / 6784 + 92097. / 339200,
+    11. / 84 - 187. / 2100,
+    -1. / 40};
+
+/**
+ * @brief Integrates x' = f(t, x) from t0 to t1 with adaptive steps.
+ *
+ * @tparam N State dimension.
+ * @param x State (input/output).
+ * @param t0 Start time.
+ * @param t1 End time (may be less than t0 for backward propagation).
+ * @param rtol Relative tolerance.
+ * @param atol Absolute tolerance.
+ * @param nErr Number of leading components included in the error norm (e.g. 6 to skip an STM).
+ * @param f Callable f(t, const double *x, double *dx).
+ * @param onStep Callable onStep(ta, xa, dxa, tb, xb, dxb) invoked after every accepted step;
+ *               return false to stop integrating.
+ * @return Time reached (t1 unless stopped early or the step size collapsed).
+ */
+template <int N, typename Deriv, typename StepObserver>
+double DormandPrinceAdaptive(double *x, double t0, double t1, double rtol, double atol, int nErr,
+                             Deriv f, StepObserver onStep)
+{
+    double dir = t1 >= t0 ? 1.0 : -1.0;
+    double span = std::fabs(t1 - t0);
+    if (span == 0.0)
+        return t0;
+
+    double k[7][N];
+    double xs[N], xn[N];
+    double t = t0;
+    double h = std::min(span, 1e-2 * std::max(span, 1e-6));
+
+    f(t, x, k[0]);
+    for (int guard = 0; guard < 10000000; ++guard)
+    {
+        double remaining = std::fabs(t1 - t);
+        if (remaining <= 1e-14 * std::max(1.0, std::fabs(t1)))
+            break;
+        h = std::min(h, remaining);
+        double hs = dir * h;
+
+        for (int i = 1; i < 7; ++i)
+        {
+            for (int n = 0; n < N; ++n)
+            {
+                double s = x[n];
+                for (int j = 0; j < i; ++j)
+                    s += hs * a_dp[i][j] * k[j][n];
+                xs[n] = s;
+            }
+            f(t + c_dp[i] * hs, xs, k[i]);
+        }
+
+        // Stage 7 is evaluated at the 5th-order solution, so xs already holds x(t + h).
+        for (int n = 0; n < N; ++n)
+            xn[n] = xs[n];
+
+        double err = 0.0;
+        for (int n = 0; n < nErr; ++n)
+        {
+            double e = 0.0;
+            for (int i = 0; i < 7; ++i)
+                e += e_dp[i] * k[i][n];
+            e *= hs;
+            double sc = atol + rtol * std::max(std::fabs(x[n]), std::fabs(xn[n]));
+            err = std::max(err, std::fabs(e) / sc);
+        }
+
+        if (err <= 1.0)
+        {
+            double tn = t + hs;
+            bool keepGoing = onStep(t, (const double *)x, (const double *)k[0], tn, (const double *)xn, (const double *)k[6]);
+            for (int n = 0; n < N; ++n)
+            {
+                x[n] = xn[n];
+                k[0][n] = k[6][n];
+            }
+            t = tn;
+            if (!keepGoing)
+                return t;
+        }
+
+        double factor = err > 0.0 ? 0.9 * std::pow(err, -0.2) : 5.0;
+        factor = std::min(5.0, std::max(0.2, factor));
+        h *= factor;
+        if (h < 1e-14 * std::max(1.0, std::fabs(t)))
+            return t;
+    }
+    return t;
+}
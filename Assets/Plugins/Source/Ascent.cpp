@@ -0,0 +1,484 @@
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include <vector>
+
+#include "Catalog.h"
+#include "EventDetection.h"
+#include "Frames.h"
+#include "Geodesy.h"
+#include "ThreadPool.h"
+
+/**
+ * @file Ascent.cpp
+ * @brief 3-DOF launch ascent from a launch site to orbit insertion.
+ *
+ * The vehicle is a point mass in the inertial frame, under central gravity with J2, thrust,
+ * and drag against the co-rotating atmosphere. Density comes from the ComputeAtmosphericDensity
+ * profile without its low-altitude cap (ComputeAtmosphericDensityUncapped). Stages burn at a
+ * constant mass flow. Thrust goes from sea-level to vacuum Isp, scaled by density as a proxy
+ * for ambient pressure. Spent stages are dropped at burnout, and the next stage lights after
+ * its ignition delay. The flight has three phases:
+ * - Ascent: the caller's pitch program (pitch from vertical against time, in the launch-azimuth
+ *   plane), then a gravity turn with thrust along the air-relative velocity (inertial velocity
+ *   above ASCENT_INERTIAL_TURN_KM). Cut-off when the apogee reaches the target.
+ * - Coast to apogee.
+ * - Circularisation: thrust along the local horizontal, tilted up or down just enough to hold
+ *   the radial velocity near zero against gravity, until the perigee reaches the target.
+ * Cut-off, apogee and insertion times are refined on the integrator step with LocateEvent. The
+ * inserted state can be handed to the catalog, whose propagators take over from there.
+ */
+
+const double ASCENT_STEP = 0.5;               ///< Integration step while thrusting (s).
+const double ASCENT_COAST_STEP = 5.0;         ///< Integration step while coasting (s).
+const double ASCENT_MAX_TIME = 12 * 3600.0;   ///< Flight time after which an ascent is abandoned (s).
+const double ASCENT_INERTIAL_TURN_KM = 80.0;  ///< Altitude above which the gravity turn follows the inertial velocity.
+const double ASCENT_IMPACT_MARGIN_KM = 0.5;   ///< Depth below the pad altitude treated as impact.
+const double ASCENT_TRACK_INTERVAL = 2.0;     ///< Spacing of the returned track samples (s).
+const double ASCENT_EVENT_TOLERANCE = 1e-4;   ///< Time tolerance of cut-off and insertion events (s).
+const double ASCENT_RADIAL_DAMPING = 20.0;    ///< Time constant of the radial-velocity hold while circularising (s).
+const double ASCENT_MAX_CLIMB_ANGLE = 0.7;    ///< Limit on the sine of the thrust angle to the horizon while circularising.
+const double STANDARD_GRAVITY = 9.80665;      ///< g0 for Isp (m/s²).
+
+extern "C"
+{
+    /**
+     * @struct AscentStage
+     * @brief One stage of a launch vehicle; layout must match NativePhysics.AscentStage.
+     */
+    struct AscentStage
+    {
+        double dryMass;        ///< Mass dropped at burnout (kg).
+        double propellantMass; ///< (kg)
+        double thrustVacuum;   ///< Vacuum thrust (N).
+        double ispVacuum;      ///< Vacuum specific impulse (s).
+        double ispSeaLevel;    ///< Sea-level specific impulse (s).
+        double ignitionDelay;  ///< Coast between the previous burnout and ignition (s).
+    };
+
+    /**
+     * @struct AscentVehicle
+     * @brief Launch site, vehicle and target; layout must match NativePhysics.AscentVehicle.
+     */
+    struct AscentVehicle
+    {
+        double payloadMass;     ///< Mass above the last stage (kg).
+        double referenceArea;   ///< Drag reference area (m²).
+        double dragCoefficient;
+        double latitude;        ///< Geodetic latitude of the pad (rad).
+        double longitude;       ///< East longitude of the pad (rad).
+        double altitudeKm;      ///< Pad height above the ellipsoid (km).
+        double launchAzimuth;   ///< Heading of the pitch plane, clockwise from north (rad).
+        double targetApogeeKm;  ///< Apogee altitude at cut-off (km).
+        double targetPerigeeKm; ///< Perigee altitude that completes insertion (km).
+    };
+
+    /**
+     * @struct AscentResult
+     * @brief Outcome of one ascent; layout must match NativePhysics.AscentResult.
+     */
+    struct AscentResult
+    {
+        int status;                 ///< AscentStatus.
+        int stage;                  ///< Stage burning or next to burn at the end.
+        double endTime;             ///< Simulation time of insertion or failure (s).
+        double3 position;           ///< Inertial position at the end (units).
+        double3 velocity;           ///< Inertial velocity at the end (units/s).
+        double apogeeKm, perigeeKm; ///< Osculating altitudes at the end (km); apogee is infinite if unbound.
+        double inclination;         ///< (rad)
+        double raan;                ///< (rad)
+        double propellantRemaining; ///< Propellant left in all stages (kg).
+        double maxDynamicPressure;  ///< Peak ½ρv² against the atmosphere (Pa).
+    };
+}
+
+/** Final state of an ascent. */
+enum AscentStatus
+{
+    ASCENT_INVALID = 0,
+    ASCENT_INSERTED = 1,
+    ASCENT_PROPELLANT_EXHAUSTED = 2, ///< Ran out of propellant before insertion.
+    ASCENT_IMPACT = 3,
+    ASCENT_TIMEOUT = 4,
+};
+
+namespace
+{
+    enum AscentPhase
+    {
+        PHASE_ASCENT,
+        PHASE_COAST,
+        PHASE_CIRCULARIZE,
+    };
+
+    /** Launch geometry and guidance shared by every step of one flight. */
+    struct Flight
+    {
+        const double *pitchProgram; ///< (time since liftoff, pitch from vertical) pairs.
+        int pitchCount;
+        Vector3d pole;    ///< Earth's rotation axis in the inertial frame.
+        Vector3d omega;   ///< Earth's angular velocity in the inertial frame (rad/s).
+        Vector3d heading; ///< Launch-azimuth direction at the pad, inertial.
+    };
+
+    /** Height above an ellipsoid of Earth's shape, without the cost of a full geodetic conversion (km). */
+    double AltitudeKm(const Vector3d &r, const Vector3d &pole)
+    {
+        double rn = Norm(r);
+        double s = Dot(r, pole) / rn;
+        return rn * UNIT_TO_KM - WGS84_A_KM * (1 - WGS84_F * s * s);
+    }
+
+    Vector3d Gravity(const Vector3d &r, const Vector3d &pole)
+    {
+        double r2 = Dot(r, r), rn = std::sqrt(r2);
+        double z = Dot(r, pole);
+        double f = 1.5 * EARTH_J2 * EARTH_MU * EARTH_RADIUS * EARTH_RADIUS / (r2 * r2 * rn);
+        return (-EARTH_MU / (r2 * rn)) * r - f * ((1 - 5 * z * z / r2) * r + (2 * z) * pole);
+    }
+
+    /** Apogee and perigee altitudes of the osculating orbit (km); apogee is infinite if unbound. */
+    void Apsides(const Vector3d &r, const Vector3d &v, double &apogeeKm, double &perigeeKm)
+    {
+        double rn = Norm(r);
+        double energy = 0.5 * Dot(v, v) - EARTH_MU / rn;
+        Vector3d h = Cross(r, v);
+        double p = Dot(h, h) / EARTH_MU;
+        double e = std::sqrt(std::max(0.0, 1 + 2 * energy * Dot(h, h) / (EARTH_MU * EARTH_MU)));
+        perigeeKm = (p / (1 + e) - EARTH_RADIUS) * UNIT_TO_KM;
+        apogeeKm = e < 1 ? (p / (1 - e) - EARTH_RADIUS) * UNIT_TO_KM : INFINITY;
+    }
+
+    double PitchAt(const Flight &f, double sinceLiftoff)
+    {
+        const double *p = f.pitchProgram;
+        if (sinceLiftoff <= p[0])
+            return p[1];
+        for (int k = 1; k < f.pitchCount; ++k)
+            if (sinceLiftoff <= p[2 * k])
+            {
+                double w = (sinceLiftoff - p[2 * k - 2]) / (p[2 * k] - p[2 * k - 2]);
+                return p[2 * k - 1] + w * (p[2 * k + 1] - p[2 * k - 1]);
+            }
+        return p[2 * f.pitchCount - 1];
+    }
+
+    Vector3d Unit(const Vector3d &a)
+    {
+        return a * (1.0 / Norm(a));
+    }
+
+    /**
+     * Thrust direction for the phase. thrustAccel is the thrust acceleration (units/s²), which
+     * the circularisation needs to tilt the thrust so it holds altitude.
+     */
+    Vector3d ThrustDirection(const Flight &f, AscentPhase phase, double sinceLiftoff, const Vector3d &r,
+                             const Vector3d &v, double thrustAccel)
+    {
+        Vector3d up = Unit(r);
+        if (phase == PHASE_CIRCULARIZE)
+        {
+            double radial = Dot(v, up);
+            Vector3d horizontal = v - radial * up;
+            double rn = Norm(r);
+            double needed = EARTH_MU / (rn * rn) - Dot(horizontal, horizontal) / rn - radial / ASCENT_RADIAL_DAMPING;
+            double s = std::clamp(needed / thrustAccel, -ASCENT_MAX_CLIMB_ANGLE, ASCENT_MAX_CLIMB_ANGLE);
+            return s * up + std::sqrt(1 - s * s) * Unit(horizontal);
+        }
+        if (f.pitchCount > 0 && sinceLiftoff <= f.pitchProgram[2 * (f.pitchCount - 1)])
+        {
+            Vector3d downrange = Unit(f.heading - Dot(f.heading, up) * up);
+            double pitch = PitchAt(f, sinceLiftoff);
+            return std::cos(pitch) * up + std::sin(pitch) * downrange;
+        }
+        Vector3d airRelative = v - Cross(f.omega, r);
+        bool inAir = AltitudeKm(r, f.pole) < ASCENT_INERTIAL_TURN_KM && Norm(airRelative) > 1e-9;
+        return Unit(inAir ? airRelative : v);
+    }
+
+    /** Vacuum-to-sea-level thrust factor, with density standing in for ambient pressure. */
+    double IspAt(const AscentStage &s, double densityRatio)
+    {
+        return s.ispVacuum + (s.ispSeaLevel - s.ispVacuum) * std::min(1.0, densityRatio);
+    }
+
+    bool ValidInput(const AscentVehicle &vehicle, const AscentStage *stages, int stageCount, const double *pitchProgram,
+                    int pitchCount)
+    {
+        if (stageCount <= 0 || vehicle.payloadMass < 0 || vehicle.targetPerigeeKm > vehicle.targetApogeeKm ||
+            vehicle.targetPerigeeKm <= 0 || (pitchCount > 0 && !pitchProgram))
+            return false;
+        for (int k = 0; k < stageCount; ++k)
+            if (stages[k].thrustVacuum <= 0 || stages[k].ispVacuum <= 0 || stages[k].ispSeaLevel <= 0 ||
+                stages[k].propellantMass <= 0 || stages[k].dryMass < 0 || stages[k].ignitionDelay < 0)
+                return false;
+        for (int k = 1; k < pitchCount; ++k)
+            if (pitchProgram[2 * k] <= pitchProgram[2 * k - 2])
+                return false;
+        return true;
+    }
+
+    /**
+     * Flies one ascent from launchTime. Track samples (inertial positions) are written up to
+     * maxTrack; the return value is the number written.
+     */
+    int Fly(const AscentVehicle &vehicle, const AscentStage *stages, int stageCount, const double *pitchProgram,
+            int pitchCount, double launchTime, AscentResult &result, double3 *track, int maxTrack)
+    {
+        // Pad position and launch direction, rotated from Earth-fixed to inertial at liftoff.
+        Matrix3 toInertial = CelestialToTerrestrial(launchTime).Transposed();
+        GeodeticPoint pad{vehicle.latitude, vehicle.longitude, vehicle.altitudeKm};
+        double sl = std::sin(vehicle.latitude), cl = std::cos(vehicle.latitude);
+        double so = std::sin(vehicle.longitude), co = std::cos(vehicle.longitude);
+        Vector3d north{-sl * co, -sl * so, cl}, east{-so, co, 0};
+        Vector3d heading = std::cos(vehicle.launchAzimuth) * north + std::sin(vehicle.launchAzimuth) * east;
+        Vector3d pole = toInertial * Vector3d{0, 0, 1};
+        Flight f{pitchProgram, pitchCount, pole, OMEGA_EARTH * pole, toInertial * heading};
+
+        Vector3d r = toInertial * GeodeticToEarthFixed(pad);
+        Vector3d v = Cross(f.omega, r);
+        double impactKm = AltitudeKm(r, pole) - ASCENT_IMPACT_MARGIN_KM;
+        double seaLevelDensity = ComputeAtmosphericDensityUncapped(0.0);
+
+        AscentPhase phase = PHASE_ASCENT;
+        int stage = 0;
+        double propellant = stages[0].propellantMass;
+        double ignitionAt = launchTime;
+        double t = launchTime;
+        double maxQ = 0;
+        int status = ASCENT_TIMEOUT;
+        int written = 0;
+        double nextSample = launchTime;
+
+        // Liftoff needs thrust above the weight on the pad.
+        double liftoffMass = vehicle.payloadMass;
+        for (int k = 0; k < stageCount; ++k)
+            liftoffMass += stages[k].dryMass + stages[k].propellantMass;
+        double liftoffThrust = stages[0].thrustVacuum * IspAt(stages[0], 1.0) / stages[0].ispVacuum;
+        if (liftoffThrust <= liftoffMass * Norm(Gravity(r, pole)) * UNIT_TO_KM * 1000.0)
+            status = ASCENT_IMPACT;
+
+        while (status == ASCENT_TIMEOUT && t < launchTime + ASCENT_MAX_TIME)
+        {
+            if (written < maxTrack && t >= nextSample)
+            {
+                track[written++] = ToDouble3(r);
+                nextSample = launchTime + ASCENT_TRACK_INTERVAL * (std::floor((t - launchTime) / ASCENT_TRACK_INTERVAL) + 1);
+            }
+
+            const AscentStage &s = stages[stage];
+            bool thrusting = phase != PHASE_COAST && t >= ignitionAt && propellant > 0;
+            double mdot = thrusting ? s.thrustVacuum / (STANDARD_GRAVITY * s.ispVacuum) : 0;
+            double mass = vehicle.payloadMass + s.dryMass + propellant;
+            for (int k = stage + 1; k < stageCount; ++k)
+                mass += stages[k].dryMass + stages[k].propellantMass;
+
+            double dt = thrusting ? ASCENT_STEP : ASCENT_COAST_STEP;
+            if (thrusting)
+                dt = std::min(dt, propellant / mdot);
+            else if (phase != PHASE_COAST && ignitionAt > t)
+                dt = std::min(dt, ignitionAt - t);
+
+            double t0 = t;
+            auto accel = [&](double tau, const Vector3d &p, const Vector3d &u)
+            {
+                Vector3d a = Gravity(p, f.pole);
+                double altKm = AltitudeKm(p, f.pole);
+                double rho = ComputeAtmosphericDensityUncapped(std::max(0.0, altKm)); // kg/km³
+                double m = mass - mdot * tau;
+                if (rho > 0 && vehicle.referenceArea > 0)
+                {
+                    Vector3d air = (u - Cross(f.omega, p)) * (UNIT_TO_KM * 1000.0); // m/s
+                    double k = -0.5 * vehicle.dragCoefficient * vehicle.referenceArea * rho * 1e-9 * Norm(air) / m;
+                    a += (k / (UNIT_TO_KM * 1000.0)) * air;
+                }
+                if (mdot > 0)
+                {
+                    double thrust = mdot * STANDARD_GRAVITY * IspAt(s, rho / seaLevelDensity);
+                    double thrustAccel = thrust / m / (UNIT_TO_KM * 1000.0);
+                    a += thrustAccel * ThrustDirection(f, phase, t0 + tau - launchTime, p, u, thrustAccel);
+                }
+                return a;
+            };
+            auto advance = [&](double tau, Vector3d &p, Vector3d &u)
+            {
+                p = r;
+                u = v;
+                DormandPrinceStepFn(p, u, tau, accel);
+            };
+            auto phaseEvent = [&](const Vector3d &p, const Vector3d &u)
+            {
+                double apogee, perigee;
+                Apsides(p, u, apogee, perigee);
+                if (phase == PHASE_ASCENT)
+                    return std::min(apogee, 1e9) - vehicle.targetApogeeKm;
+                if (phase == PHASE_COAST)
+                    return Dot(p, u);
+                return perigee - vehicle.targetPerigeeKm;
+            };
+            auto impactEvent = [&](const Vector3d &p, const Vector3d &) { return AltitudeKm(p, f.pole) - impactKm; };
+
+            Vector3d r1, v1;
+            advance(dt, r1, v1);
+            bool phaseDone = false, impact = false;
+            double g0 = phaseEvent(r, v), g1 = phaseEvent(r1, v1);
+            double i0 = impactEvent(r, v), i1 = impactEvent(r1, v1);
+            // The coast ends on the way down through r·v = 0; the others when g climbs through zero.
+            bool phaseCrossed = phase == PHASE_COAST ? (g0 > 0 && g1 <= 0) : (g0 < 0 && g1 >= 0);
+            if (i0 > 0 && i1 <= 0)
+            {
+                dt = LocateEvent([&](double tau) { Vector3d p, u; advance(tau, p, u); return impactEvent(p, u); },
+                                 0.0, dt, i0, i1, ASCENT_EVENT_TOLERANCE);
+                advance(dt, r1, v1);
+                impact = true;
+            }
+            else if (phaseCrossed)
+            {
+                dt = LocateEvent([&](double tau) { Vector3d p, u; advance(tau, p, u); return phaseEvent(p, u); },
+                                 0.0, dt, g0, g1, ASCENT_EVENT_TOLERANCE);
+                advance(dt, r1, v1);
+                phaseDone = true;
+            }
+
+            // Dynamic pressure peaks low in the atmosphere, where half-second samples resolve it.
+            double rho1 = ComputeAtmosphericDensityUncapped(std::max(0.0, AltitudeKm(r1, f.pole))) * 1e-9;
+            Vector3d air1 = (v1 - Cross(f.omega, r1)) * (UNIT_TO_KM * 1000.0);
+            maxQ = std::max(maxQ, 0.5 * rho1 * Dot(air1, air1));
+
+            r = r1;
+            v = v1;
+            t += dt;
+            if (thrusting)
+                propellant = std::max(0.0, propellant - mdot * dt);
+
+            if (impact)
+                status = ASCENT_IMPACT;
+            else if (phaseDone && phase == PHASE_CIRCULARIZE)
+                status = ASCENT_INSERTED;
+            else if (phaseDone)
+            {
+                phase = phase == PHASE_ASCENT ? PHASE_COAST : PHASE_CIRCULARIZE;
+                // A stage mid-way through its ignition delay lights as soon as the coast ends.
+                ignitionAt = std::min(ignitionAt, t);
+            }
+            else if (phase == PHASE_COAST && Dot(r, v) <= 0)
+                phase = PHASE_CIRCULARIZE; // Cut-off happened past apogee.
+
+            if (status == ASCENT_TIMEOUT && thrusting && propellant <= 1e-9 * stages[stage].propellantMass)
+            {
+                if (stage + 1 == stageCount)
+                    status = ASCENT_PROPELLANT_EXHAUSTED;
+                else
+                {
+                    ++stage;
+                    propellant = stages[stage].propellantMass;
+                    ignitionAt = t + stages[stage].ignitionDelay;
+                }
+            }
+        }
+
+        if (written < maxTrack)
+            track[written++] = ToDouble3(r);
+
+        result.status = status;
+        result.stage = stage;
+        result.endTime = t;
+        result.position = ToDouble3(r);
+        result.velocity = ToDouble3(v);
+        Apsides(r, v, result.apogeeKm, result.perigeeKm);
+        Vector3d h = Cross(r, v);
+        result.inclination = std::acos(std::clamp(h.z / Norm(h), -1.0, 1.0));
+        result.raan = std::fmod(std::atan2(h.x, -h.y) + 2 * M_PI, 2 * M_PI);
+        result.propellantRemaining = propellant;
+        for (int k = stage + 1; k < stageCount; ++k)
+            result.propellantRemaining += stages[k].propellantMass;
+        result.maxDynamicPressure = maxQ;
+        return written;
+    }
+
+    /** Mass left on orbit: payload, the stage in use and any stages still attached. */
+    double InsertedMass(const AscentVehicle &vehicle, const AscentStage *stages, int stageCount, const AscentResult &res)
+    {
+        double mass = vehicle.payloadMass + res.propellantRemaining;
+        for (int k = res.stage; k < stageCount; ++k)
+            mass += stages[k].dryMass;
+        return mass;
+    }
+}
+
+/**
+ * @brief Simulates one launch ascent and, on insertion, optionally hands the object to the catalog.
+ * @param vehicle Launch site, vehicle and target orbit.
+ * @param stages Stages in firing order.
+ * @param stageCount Number of stages.
+ * @param pitchProgram (time since liftoff (s), pitch from vertical (rad)) pairs, increasing in time;
+ *        the gravity turn starts after the last one. Start vertical and end with the kick.
+ * @param pitchCount Number of pairs.
+ * @param launchTime Simulation time of liftoff (s).
+ * @param catalogId Catalog id for the inserted object, or 0 to leave the catalog alone.
+ * @param result Output outcome.
+ * @param track Output inertial positions every ASCENT_TRACK_INTERVAL seconds and at the end, or null.
+ * @param maxTrack Capacity of track.
+ * @return Number of track samples written, or -1 for invalid input.
+ */
+extern "C" __attribute__((visibility("default"))) int AscentSimulate(const AscentVehicle *vehicle, const AscentStage *stages,
+                                                                     int stageCount, const double *pitchProgram, int pitchCount,
+                                                                     double launchTime, int catalogId, AscentResult *result,
+                                                                     double3 *track, int maxTrack)
+{
+    if (!ValidInput(*vehicle, stages, stageCount, pitchProgram, pitchCount))
+    {
+        LogDebug("[AscentSimulate] Invalid vehicle, stage or pitch program data");
+        *result = AscentResult{};
+        return -1;
+    }
+    EnsureFrameGrid(launchTime, launchTime);
+    int written = Fly(*vehicle, stages, stageCount, pitchProgram, pitchCount, launchTime, *result, track,
+                      track ? maxTrack : 0);
+    if (result->status == ASCENT_INSERTED && catalogId > 0)
+    {
+        Catalog &catalog = GetCatalog();
+        double radius = std::sqrt(vehicle->referenceArea / M_PI) / (UNIT_TO_KM * 1000.0);
+        int i = catalog.Upsert(catalogId, ToVector3dFromDouble3(result->position), ToVector3dFromDouble3(result->velocity),
+                               result->endTime, radius);
+        catalog.ballistic[i] = vehicle->dragCoefficient * vehicle->referenceArea /
+                               InsertedMass(*vehicle, stages, stageCount, *result);
+    }
+    return written;
+}
+
+/**
+ * @brief Flies the same ascent at each of a set of launch times in parallel (launch-window sweep).
+ * The catalog is not modified.
+ * @param vehicle Launch site, vehicle and target orbit.
+ * @param stages Stages in firing order.
+ * @param stageCount Number of stages.
+ * @param pitchProgram (time since liftoff, pitch) pairs as for AscentSimulate.
+ * @param pitchCount Number of pairs.
+ * @param launchTimes Simulation times of liftoff (s).
+ * @param count Number of launch times.
+ * @param results Output outcome per launch time.
+ * @return Number of ascents that reached insertion, or -1 for invalid input.
+ */
+extern "C" __attribute__((visibility("default"))) int AscentSweep(const AscentVehicle *vehicle, const AscentStage *stages,
+                                                                  int stageCount, const double *pitchProgram, int pitchCount,
+                                                                  const double *launchTimes, int count, AscentResult *results)
+{
+    if (!ValidInput(*vehicle, stages, stageCount, pitchProgram, pitchCount))
+    {
+        LogDebug("[AscentSweep] Invalid vehicle, stage or pitch program data");
+        return -1;
+    }
+    if (count <= 0)
+        return 0;
+    auto range = std::minmax_element(launchTimes, launchTimes + count);
+    EnsureFrameGrid(*range.first, *range.second);
+    ParallelFor(count, [&](int k)
+    {
+        Fly(*vehicle, stages, stageCount, pitchProgram, pitchCount, launchTimes[k], results[k], nullptr, 0);
+    });
+    int inserted = 0;
+    for (int k = 0; k < count; ++k)
+        inserted += results[k].status == ASCENT_INSERTED ? 1 : 0;
+    return inserted;
+}
@@ -0,0 +1,310 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+
+#include "Budget.h"
+
+/**
+ * @file Budget.cpp
+ * @brief Frame-time budget controller state, decision rule and exports.
+ *
+ * Per-frame costs accumulate in atomic nanosecond counters, so kernels can book time from any
+ * thread without locks. At the end of a frame they are folded into exponential moving averages,
+ * as is the frame time. The decision rule has hysteresis, so the controller does not oscillate:
+ * - It degrades only after several consecutive frames over budget, and only a subsystem that
+ *   costs enough to matter. If nothing is left to shed, the overload is flagged.
+ * - It restores only after a longer run of frames with clear headroom, and only if doubling the
+ *   subsystem's current cost would still fit the target.
+ * - After any change, decisions pause until the averages have caught up with the new level.
+ */
+
+const double BUDGET_DEFAULT_TARGET_MS = 1000.0 / 60.0; ///< Default frame-time target (ms).
+const double BUDGET_SMOOTHING = 0.1;                   ///< Weight of the newest frame in the moving averages.
+const double BUDGET_OVER_MARGIN = 0.05;                ///< Over budget above target * (1 + margin).
+const double BUDGET_RESTORE_MARGIN = 0.15;             ///< Headroom: frame time below target * (1 - margin).
+const int BUDGET_DEGRADE_FRAMES = 5;                   ///< Consecutive frames over budget before shedding work.
+const int BUDGET_RESTORE_FRAMES = 60;                  ///< Consecutive frames with headroom before restoring quality.
+const int BUDGET_SETTLE_FRAMES = 15;                   ///< Frames without decisions after a change.
+const int BUDGET_MAX_LEVEL = 4;                        ///< Deepest degradation (1/16 of the work).
+const double BUDGET_MIN_COST_MS = 0.2;                 ///< Subsystems cheaper than this are not worth degrading (ms).
+const int BUDGET_DECISION_LOG = 32;                    ///< Decisions kept for the stats API.
+
+enum BudgetReason
+{
+    BUDGET_DEGRADED = 0, ///< Over budget: work shed.
+    BUDGET_RESTORED = 1, ///< Headroom returned: quality restored.
+    BUDGET_LIMITED = 2,  ///< Level clamped by BudgetSetMaxLevel.
+};
+
+extern "C"
+{
+    /**
+     * @struct BudgetStats
+     * @brief Controller state; layout must match NativePhysics.BudgetStats.
+     */
+    struct BudgetStats
+    {
+        double targetMs;                   ///< Frame-time target.
+        double frameMs;                    ///< Smoothed frame time.
+        double lastFrameMs;                ///< Most recent frame time.
+        double costMs[BUDGET_SUBSYSTEMS];  ///< Smoothed cost per subsystem and frame.
+        double lastCostMs[BUDGET_SUBSYSTEMS]; ///< Cost per subsystem in the most recent frame.
+        int level[BUDGET_SUBSYSTEMS];      ///< Current quality level per subsystem.
+        int maxLevel[BUDGET_SUBSYSTEMS];   ///< Deepest allowed level per subsystem.
+        int frames;                        ///< Frames since the last reset.
+        int degradations;
+        int restorations;
+        int overloaded; ///< 1 if over budget with nothing left to degrade.
+    };
+
+    /**
+     * @struct BudgetDecision
+     * @brief One level change; layout must match NativePhysics.BudgetDecision.
+     */
+    struct BudgetDecision
+    {
+        int frame;
+        int subsystem;
+        int level;     ///< New level.
+        int reason;    ///< BudgetReason.
+        double frameMs; ///< Smoothed frame time when decided.
+        double costMs;  ///< Smoothed cost of the subsystem when decided.
+    };
+}
+
+namespace
+{
+    struct BudgetController
+    {
+        std::atomic<int64_t> frameCostNs[BUDGET_SUBSYSTEMS] = {};
+        std::atomic<int> level[BUDGET_SUBSYSTEMS] = {};
+
+        std::mutex mutex; ///< Guards everything below.
+        BudgetStats stats{};
+        int overFrames = 0, headroomFrames = 0, settleFrames = 0;
+        BudgetDecision log[BUDGET_DECISION_LOG] = {};
+        int logged = 0; ///< Total decisions; the log holds the last BUDGET_DECISION_LOG.
+
+        BudgetController()
+        {
+            stats.targetMs = BUDGET_DEFAULT_TARGET_MS;
+            for (int s = 0; s < BUDGET_SUBSYSTEMS; ++s)
+                stats.maxLevel[s] = s == BUDGET_PHYSICS ? 0 : BUDGET_MAX_LEVEL;
+            Reset();
+        }
+
+        /** Back to full quality with cleared statistics; the target and level limits are kept. */
+        void Reset()
+        {
+            BudgetStats previous = stats;
+            stats = {};
+            stats.targetMs = previous.targetMs;
+            for (int s = 0; s < BUDGET_SUBSYSTEMS; ++s)
+            {
+                frameCostNs[s] = 0;
+                level[s] = 0;
+                stats.maxLevel[s] = previous.maxLevel[s];
+            }
+            overFrames = headroomFrames = settleFrames = 0;
+            logged = 0;
+        }
+
+        void SetLevel(int s, int newLevel, int reason)
+        {
+            level[s] = newLevel;
+            stats.level[s] = newLevel;
+            log[logged % BUDGET_DECISION_LOG] = {stats.frames, s, newLevel, reason, stats.frameMs, stats.costMs[s]};
+            ++logged;
+            settleFrames = BUDGET_SETTLE_FRAMES;
+            overFrames = headroomFrames = 0;
+        }
+
+        /** Folds the frame into the averages and applies the decision rule; returns the changed subsystems as a bitmask. */
+        int EndFrame(double frameMs)
+        {
+            double w = stats.frames == 0 ? 1.0 : BUDGET_SMOOTHING;
+            for (int s = 0; s < BUDGET_SUBSYSTEMS; ++s)
+            {
+                stats.lastCostMs[s] = frameCostNs[s].exchange(0, std::memory_order_relaxed) * 1e-6;
+                stats.costMs[s] += w * (stats.lastCostMs[s] - stats.costMs[s]);
+            }
+            stats.lastFrameMs = frameMs;
+            stats.frameMs += w * (frameMs - stats.frameMs);
+            stats.frames++;
+
+            if (settleFrames > 0)
+            {
+                --settleFrames;
+                return 0;
+            }
+            double target = stats.targetMs;
+            overFrames = stats.frameMs > target * (1 + BUDGET_OVER_MARGIN) ? overFrames + 1 : 0;
+            headroomFrames = stats.frameMs < target * (1 - BUDGET_RESTORE_MARGIN) ? headroomFrames + 1 : 0;
+            stats.overloaded = 0;
+
+            if (overFrames >= BUDGET_DEGRADE_FRAMES)
+            {
+                int pick = -1;
+                for (int s = 0; s < BUDGET_SUBSYSTEMS; ++s)
+                    if (stats.level[s] < stats.maxLevel[s] && stats.costMs[s] >= BUDGET_MIN_COST_MS &&
+                        (pick < 0 || stats.costMs[s] > stats.costMs[pick]))
+                        pick = s;
+                if (pick < 0)
+                {
+                    stats.overloaded = 1;
+                    return 0;
+                }
+                stats.degradations++;
+                SetLevel(pick, stats.level[pick] + 1, BUDGET_DEGRADED);
+                return 1 << pick;
+            }
+
+            if (headroomFrames >= BUDGET_RESTORE_FRAMES)
+            {
+                // Restoring a level doubles the work, so the extra cost is about the current cost.
+                int pick = -1;
+                for (int s = 0; s < BUDGET_SUBSYSTEMS; ++s)
+                    if (stats.level[s] > 0 && stats.frameMs + stats.costMs[s] <= target &&
+                        (pick < 0 || stats.costMs[s] < stats.costMs[pick]))
+                        pick = s;
+                if (pick < 0)
+                    return 0;
+                stats.restorations++;
+                SetLevel(pick, stats.level[pick] - 1, BUDGET_RESTORED);
+                return 1 << pick;
+            }
+            return 0;
+        }
+    };
+
+    BudgetController &GetBudget()
+    {
+        static BudgetController budget;
+        return budget;
+    }
+
+    bool ValidSubsystem(int s)
+    {
+        return s >= 0 && s < BUDGET_SUBSYSTEMS;
+    }
+}
+
+void BudgetAddCost(int subsystem, std::chrono::steady_clock::duration elapsed)
+{
+    if (ValidSubsystem(subsystem))
+        GetBudget().frameCostNs[subsystem].fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+                                                     std::memory_order_relaxed);
+}
+
+int BudgetLevel(int subsystem)
+{
+    return ValidSubsystem(subsystem) ? GetBudget().level[subsystem].load(std::memory_order_relaxed) : 0;
+}
+
+/**
+ * @brief Books work measured on the managed side (e.g. prediction dispatch) against a subsystem.
+ * @param subsystem BudgetSubsystem.
+ * @param milliseconds Time spent this frame (ms).
+ */
+extern "C" __attribute__((visibility("default"))) void BudgetReport(int subsystem, double milliseconds)
+{
+    if (milliseconds > 0)
+        BudgetAddCost(subsystem, std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                     std::chrono::duration<double, std::milli>(milliseconds)));
+}
+
+/**
+ * @brief Closes a frame: updates the averages and may shed or restore one quality level.
+ * Call once per rendered frame, after the frame's work has been booked.
+ * @param frameMs Duration of the frame (ms), e.g. unscaled delta time.
+ * @return Bitmask of subsystems whose level changed (bit = BudgetSubsystem).
+ */
+extern "C" __attribute__((visibility("default"))) int BudgetEndFrame(double frameMs)
+{
+    BudgetController &b = GetBudget();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    return b.EndFrame(frameMs);
+}
+
+/**
+ * @brief Sets the frame-time target.
+ * @param targetMs Target frame time (ms), e.g. 16.7 for 60 Hz.
+ */
+extern "C" __attribute__((visibility("default"))) void BudgetSetTarget(double targetMs)
+{
+    BudgetController &b = GetBudget();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    if (targetMs > 0)
+        b.stats.targetMs = targetMs;
+}
+
+/**
+ * @brief Limits how far a subsystem may be degraded; 0 pins it at full quality.
+ * A subsystem already below the limit is raised to it immediately.
+ */
+extern "C" __attribute__((visibility("default"))) void BudgetSetMaxLevel(int subsystem, int maxLevel)
+{
+    if (!ValidSubsystem(subsystem))
+        return;
+    BudgetController &b = GetBudget();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.stats.maxLevel[subsystem] = std::clamp(maxLevel, 0, BUDGET_MAX_LEVEL);
+    if (b.stats.level[subsystem] > b.stats.maxLevel[subsystem])
+        b.SetLevel(subsystem, b.stats.maxLevel[subsystem], BUDGET_LIMITED);
+}
+
+/**
+ * @brief Quality level of a subsystem; 0 is full quality and each level halves the work.
+ */
+extern "C" __attribute__((visibility("default"))) int BudgetGetLevel(int subsystem)
+{
+    return BudgetLevel(subsystem);
+}
+
+/**
+ * @brief Work fraction of a subsystem, 2^-level: scale sample counts or resolution by it.
+ */
+extern "C" __attribute__((visibility("default"))) double BudgetGetQuality(int subsystem)
+{
+    return std::ldexp(1.0, -BudgetLevel(subsystem));
+}
+
+/**
+ * @brief Reads the controller state.
+ */
+extern "C" __attribute__((visibility("default"))) void BudgetGetStats(BudgetStats *stats)
+{
+    BudgetController &b = GetBudget();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    *stats = b.stats;
+}
+
+/**
+ * @brief Copies the most recent level changes, oldest first.
+ * @param decisions Output buffer (capacity maxDecisions).
+ * @param maxDecisions Capacity of the output buffer.
+ * @return Number of decisions written (at most the log size).
+ */
+extern "C" __attribute__((visibility("default"))) int BudgetGetDecisions(BudgetDecision *decisions, int maxDecisions)
+{
+    BudgetController &b = GetBudget();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    int available = std::min(b.logged, BUDGET_DECISION_LOG);
+    int count = std::min(available, std::max(0, maxDecisions));
+    for (int k = 0; k < count; ++k)
+        decisions[k] = b.log[(b.logged - count + k) % BUDGET_DECISION_LOG];
+    return count;
+}
+
+/**
+ * @brief Restores full quality everywhere and clears the statistics; the target and the limits
+ * set with BudgetSetMaxLevel are kept.
+ */
+extern "C" __attribute__((visibility("default"))) void BudgetReset()
+{
+    BudgetController &b = GetBudget();
+    std::lock_guard<std::mutex> lock(b.mutex);
+    b.Reset();
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * @file Budget.h
+ * @brief Frame-time budget controller: per-subsystem cost measurement and adaptive quality levels.
+ *
+ * Subsystems book the time they spend each frame, either by scoping a BudgetScope around their
+ * native work or through BudgetReport from the managed side. Once per frame, BudgetEndFrame
+ * compares the smoothed frame time with the target:
+ * - Over budget: the most expensive subsystem that can still be degraded drops one quality level.
+ * - Clear headroom: a degraded subsystem is restored, provided its cost at full quality still fits.
+ * Each level halves the subsystem's work, e.g. half the prediction resolution, ground tracks
+ * propagated at twice the knot spacing, or catalog objects refreshed every other frame. Decisions are logged for the stats API.
+ */
+
+enum BudgetSubsystem
+{
+    BUDGET_PHYSICS = 0,    ///< Integration of tracked bodies; measured but not degraded by default.
+    BUDGET_PREDICTION = 1, ///< Trajectory prediction resolution.
+    BUDGET_TRAILS = 2,     ///< Trail and ground-track sampling.
+    BUDGET_CATALOG = 3,    ///< Propagation of non-tracked catalog objects for rendering.
+    BUDGET_SUBSYSTEMS = 4,
+};
+
+/** Adds work time to a subsystem for the current frame. Thread-safe and lock-free. */
+void BudgetAddCost(int subsystem, std::chrono::steady_clock::duration elapsed);
+
+/** Quality level of a subsystem: 0 is full quality, each level halves the work. Thread-safe. */
+int BudgetLevel(int subsystem);
+
+/** Books the lifetime of the scope against a subsystem. */
+class BudgetScope
+{
+public:
+    explicit BudgetScope(int subsystem) : subsystem(subsystem), start(std::chrono::steady_clock::now()) {}
+    ~BudgetScope() { BudgetAddCost(subsystem, std::chrono::steady_clock::now() - start); }
+    BudgetScope(const BudgetScope &) = delete;
+    BudgetScope &operator=(const BudgetScope &) = delete;
+
+private:
+    int subsystem;
+    std::chrono::steady_clock::time_point start;
+};
@@ -0,0 +1,83 @@
+#include "Bvh.h"
+
+namespace
+{
+    double Axis(const Vector3d &v, int axis)
+    {
+        return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+    }
+
+    int BuildNode(Bvh &bvh, const std::vector<Aabb> &boxes, const std::vector<Vector3d> &centers,
+                  int first, int last, int leafSize)
+    {
+        int nodeIndex = (int)bvh.nodes.size();
+        bvh.nodes.push_back({});
+        Aabb box, centroidBox;
+        for (int k = first; k < last; ++k)
+        {
+            box.Grow(boxes[bvh.items[k]]);
+            centroidBox.Grow(centers[bvh.items[k]]);
+        }
+        bvh.nodes[nodeIndex].box = box;
+
+        if (last - first <= leafSize)
+        {
+            bvh.nodes[nodeIndex].index = first;
+            bvh.nodes[nodeIndex].count = last - first;
+            return nodeIndex;
+        }
+
+        Vector3d extent = centroidBox.hi - centroidBox.lo;
+        int axis = extent.x >= extent.y && extent.x >= extent.z ? 0 : extent.y >= extent.z ? 1 : 2;
+        int mid = (first + last) / 2;
+        std::nth_element(bvh.items.begin() + first, bvh.items.begin() + mid, bvh.items.begin() + last,
+                         [&](int a, int b)
+                         { return Axis(centers[a], axis) < Axis(centers[b], axis); });
+
+        BuildNode(bvh, boxes, centers, first, mid, leafSize);
+        int right = BuildNode(bvh, boxes, centers, mid, last, leafSize);
+        bvh.nodes[nodeIndex].index = right;
+        bvh.nodes[nodeIndex].count = 0;
+        return nodeIndex;
+    }
+}
+
+void Bvh::Build(const std::vector<Aabb> &boxes, int leafSize)
+{
+    nodes.clear();
+    items.resize(boxes.size());
+    if (boxes.empty())
+        return;
+    std::vector<Vector3d> centers(boxes.size());
+    for (size_t k = 0; k < boxes.size(); ++k)
+    {
+        items[k] = (int)k;
+        centers[k] = boxes[k].Center();
+    }
+    nodes.reserve(2 * boxes.size() / std::max(1, leafSize) + 1);
+    BuildNode(*this, boxes, centers, 0, (int)boxes.size(), std::max(1, leafSize));
+}
+
+double Bvh::Refit(const std::vector<Aabb> &boxes)
+{
+    // Children are stored after their parents, so a reverse sweep sees them first.
+    double cost = 0;
+    for (int k = (int)nodes.size() - 1; k >= 0; --k)
+    {
+        Node &node = nodes[k];
+        Aabb box;
+        if (node.count > 0)
+        {
+            for (int j = node.index; j < node.index + node.count; ++j)
+                box.Grow(boxes[items[j]]);
+        }
+        else
+        {
+            box = nodes[k + 1].box;
+            box.Grow(nodes[node.index].box);
+            cost += box.SurfaceArea();
+        }
+        node.box = box;
+    }
+    return cost;
+}
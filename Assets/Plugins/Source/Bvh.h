@@ -0,0 +1,123 @@
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file Bvh.h
+ * @brief Axis-aligned bounding boxes and a bounding-volume hierarchy over them.
+ *
+ * Nodes are stored depth-first: an inner node's left child follows it directly and its right
+ * child is stored by index, so every child comes after its parent and a reverse sweep visits
+ * children before parents (used for refitting).
+ */
+
+/**
+ * @struct Aabb
+ * @brief Axis-aligned bounding box.
+ */
+struct Aabb
+{
+    Vector3d lo{INFINITY, INFINITY, INFINITY};
+    Vector3d hi{-INFINITY, -INFINITY, -INFINITY};
+
+    void Grow(const Vector3d &p)
+    {
+        lo = {std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+        hi = {std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+    }
+
+    void Grow(const Aabb &b)
+    {
+        Grow(b.lo);
+        Grow(b.hi);
+    }
+
+    /** Grows the box by a margin on every side. */
+    void Pad(double margin)
+    {
+        lo = lo - Vector3d{margin, margin, margin};
+        hi = hi + Vector3d{margin, margin, margin};
+    }
+
+    bool Overlaps(const Aabb &b) const
+    {
+        return lo.x <= b.hi.x && hi.x >= b.lo.x && lo.y <= b.hi.y && hi.y >= b.lo.y && lo.z <= b.hi.z && hi.z >= b.lo.z;
+    }
+
+    Vector3d Center() const { return 0.5 * (lo + hi); }
+
+    double SurfaceArea() const
+    {
+        Vector3d d = hi - lo;
+        return 2 * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    /** Squared distance from a point to the box (0 inside). */
+    double DistanceSq(const Vector3d &p) const
+    {
+        double dx = std::max({lo.x - p.x, 0.0, p.x - hi.x});
+        double dy = std::max({lo.y - p.y, 0.0, p.y - hi.y});
+        double dz = std::max({lo.z - p.z, 0.0, p.z - hi.z});
+        return dx * dx + dy * dy + dz * dz;
+    }
+};
+
+/**
+ * @struct Bvh
+ * @brief Binary BVH over a set of boxes, built by median splits along the widest centroid axis.
+ */
+struct Bvh
+{
+    struct Node
+    {
+        Aabb box;
+        int index; ///< Leaf: first slot in items; inner: index of the right child.
+        int count; ///< Number of items in a leaf, 0 for inner nodes.
+    };
+
+    std::vector<Node> nodes;
+    std::vector<int> items; ///< Item indices, grouped by leaf.
+
+    /** Builds the hierarchy over boxes[0..n); items refer to positions in that array. */
+    void Build(const std::vector<Aabb> &boxes, int leafSize = 4);
+
+    /**
+     * @brief Recomputes every node box for moved items, keeping the topology.
+     * @return Sum of the inner-node surface areas, a measure of the tree's query cost.
+     */
+    double Refit(const std::vector<Aabb> &boxes);
+
+    /**
+     * @brief Visits every item whose enclosing nodes pass a test.
+     * @param test Callable (const Aabb &) -> bool deciding whether to descend into a node.
+     * @param visit Callable (int item) invoked for the items of every accepted leaf.
+     */
+    template <typename Test, typename Visit>
+    void Traverse(Test test, Visit visit) const
+    {
+        if (nodes.empty())
+            return;
+        int stack[64];
+        int top = 0;
+        stack[top++] = 0;
+        while (top > 0)
+        {
+            const Node &node = nodes[stack[--top]];
+            if (!test(node.box))
+                continue;
+            if (node.count > 0)
+            {
+                for (int k = node.index; k < node.index + node.count; ++k)
+                    visit(items[k]);
+            }
+            else
+            {
+                stack[top++] = node.index;
+                stack[top++] = (int)(&node - nodes.data()) + 1;
+            }
+        }
+    }
+};
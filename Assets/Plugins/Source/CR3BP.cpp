@@ -0,0 +1,667 @@
+#include <cmath>
+#include <algorithm>
+#include <vector>
+
+#include "CR3BP.h"
+#include "LinearAlgebra.h"
+#include "ThreadPool.h"
+
+/**
+ * @file CR3BP.cpp
+ * @brief CR3BP propagation, periodic-orbit differential correction and family continuation.
+ *
+ * Symmetric periodic orbits (Lyapunov, halo, NRHO) are parameterised by their perpendicular
+ * crossing of the x-z plane: X = [x0, z0, vy0, T/2]. Half a period later the orbit crosses
+ * the plane perpendicularly again, so y = vx = vz = 0 there (planar orbits replace vz = 0
+ * with z0 = 0). Three equations in four unknowns leave a one-parameter family, which is
+ * traced with pseudo-arclength continuation.
+ */
+
+enum Cr3bpFamily
+{
+    CR3BP_LYAPUNOV = 0,
+    CR3BP_HALO_NORTH = 1,
+    CR3BP_HALO_SOUTH = 2
+};
+
+const int CR3BP_MAX_NEWTON = 25;           ///< Newton iterations per correction.
+const double CR3BP_NEWTON_TOL = 1e-10;     ///< Residual tolerance of a converged orbit.
+const double CR3BP_SEED_AMPLITUDE = 1e-3;  ///< Linear Lyapunov seed amplitude (nondimensional).
+const double CR3BP_HALO_SEED_Z = 1e-3;     ///< Out-of-plane offset used to leave the Lyapunov family.
+const int CR3BP_FILL_PER_ANCHOR = 4;       ///< Members per sequential anchor; the rest are solved in parallel.
+const int CR3BP_MAX_BIFURCATION_SEARCH = 4000;
+
+void Cr3bpDerivatives(double mu, const double *x, double *dx, bool withStm)
+{
+    double px = x[0], py = x[1], pz = x[2];
+    double x1 = px + mu, x2 = px - 1.0 + mu;
+    double r1sq = x1 * x1 + py * py + pz * pz;
+    double r2sq = x2 * x2 + py * py + pz * pz;
+    double r1 = std::sqrt(r1sq), r2 = std::sqrt(r2sq);
+    double r13 = r1sq * r1, r23 = r2sq * r2;
+    double m1 = 1.0 - mu;
+
+    dx[0] = x[3];
+    dx[1] = x[4];
+    dx[2] = x[5];
+    dx[3] = 2.0 * x[4] + px - m1 * x1 / r13 - mu * x2 / r23;
+    dx[4] = -2.0 * x[3] + py - m1 * py / r13 - mu * py / r23;
+    dx[5] = -m1 * pz / r13 - mu * pz / r23;
+
+    if (!withStm)
+        return;
+
+    double r15 = r13 * r1sq, r25 = r23 * r2sq;
+    double common = m1 / r13 + mu / r23;
+    double Uxx = 1.0 - common + 3.0 * m1 * x1 * x1 / r15 + 3.0 * mu * x2 * x2 / r25;
+    double Uyy = 1.0 - common + 3.0 * m1 * py * py / r15 + 3.0 * mu * py * py / r25;
+    double Uzz = -common + 3.0 * m1 * pz * pz / r15 + 3.0 * mu * pz * pz / r25;
+    double Uxy = 3.0 * m1 * x1 * py / r15 + 3.0 * mu * x2 * py / r25;
+    double Uxz = 3.0 * m1 * x1 * pz / r15 + 3.0 * mu * x2 * pz / r25;
+    double Uyz = 3.0 * m1 * py * pz / r15 + 3.0 * mu * py * pz / r25;
+
+    // dΦ/dt = A Φ with A = [[0, I], [Uxx, Ω]], Φ stored row-major after the state.
+    const double *phi = x + 6;
+    double *dphi = dx + 6;
+    for (int j = 0; j < 6; ++j)
+    {
+        double p0 = phi[0 * 6 + j], p1 = phi[1 * 6 + j], p2 = phi[2 * 6 + j];
+        double p3 = phi[3 * 6 + j], p4 = phi[4 * 6 + j], p5 = phi[5 * 6 + j];
+        dphi[0 * 6 + j] = p3;
+        dphi[1 * 6 + j] = p4;
+        dphi[2 * 6 + j] = p5;
+        dphi[3 * 6 + j] = Uxx * p0 + Uxy * p1 + Uxz * p2 + 2.0 * p4;
+        dphi[4 * 6 + j] = Uxy * p0 + Uyy * p1 + Uyz * p2 - 2.0 * p3;
+        dphi[5 * 6 + j] = Uxz * p0 + Uyz * p1 + Uzz * p2;
+    }
+}
+
+double Cr3bpJacobi(double mu, const double *x)
+{
+    double r1 = std::sqrt((x[0] + mu) * (x[0] + mu) + x[1] * x[1] + x[2] * x[2]);
+    double r2 = std::sqrt((x[0] - 1.0 + mu) * (x[0] - 1.0 + mu) + x[1] * x[1] + x[2] * x[2]);
+    double v2 = x[3] * x[3] + x[4] * x[4] + x[5] * x[5];
+    return x[0] * x[0] + x[1] * x[1] + 2.0 * (1.0 - mu) / r1 + 2.0 * mu / r2 - v2;
+}
+
+bool Cr3bpPropagateState(double mu, double *state, double t, double *stm)
+{
+    auto accept = [](double, const double *, const double *, double, const double *, const double *)
+    { return true; };
+
+    if (stm == nullptr)
+    {
+        double reached = DormandPrinceAdaptive<6>(
+            state, 0.0, t, CR3BP_RTOL, CR3BP_ATOL, 6,
+            [mu](double, const double *x, double *dx)
+            { Cr3bpDerivatives(mu, x, dx, false); },
+            accept);
+        return std::fabs(reached - t) < 1e-9 * std::max(1.0, std::fabs(t));
+    }
+
+    double x[42];
+    for (int i = 0; i < 6; ++i)
+        x[i] = state[i];
+    for (int i = 0; i < 36; ++i)
+        x[6 + i] = (i % 7 == 0) ? 1.0 : 0.0;
+
+    double reached = DormandPrinceAdaptive<42>(
+        x, 0.0, t, CR3BP_RTOL, CR3BP_ATOL, 42,
+        [mu](double, const double *s, double *ds)
+        { Cr3bpDerivatives(mu, s, ds, true); },
+        accept);
+
+    for (int i = 0; i < 6; ++i)
+        state[i] = x[i];
+    for (int i = 0; i < 36; ++i)
+        stm[i] = x[6 + i];
+    return std::fabs(reached - t) < 1e-9 * std::max(1.0, std::fabs(t));
+}
+
+void Cr3bpMonodromy(double mu, const Cr3bpOrbit &orbit, double *monodromy)
+{
+    double s[6] = {orbit.x0, 0.0, orbit.z0, 0.0, orbit.vy0, 0.0};
+    Cr3bpPropagateState(mu, s, orbit.period, monodromy);
+}
+
+namespace
+{
+    /** True for the collinear libration points 1, 2 and 3. */
+    bool IsCollinearPoint(int point)
+    {
+        return point >= 1 && point <= 3;
+    }
+
+    /** x coordinate of collinear libration point 1, 2 or 3. */
+    double LibrationPointX(double mu, int point)
+    {
+        double gamma = std::cbrt(mu / 3.0);
+        double x = point == 1 ? 1.0 - mu - gamma : point == 2 ? 1.0 - mu + gamma
+                                                              : -1.0 - 5.0 * mu / 12.0;
+        for (int i = 0; i < 50; ++i)
+        {
+            double x1 = x + mu, x2 = x - 1.0 + mu;
+            double a1 = std::fabs(x1), a2 = std::fabs(x2);
+            double f = x - (1.0 - mu) * x1 / (a1 * a1 * a1) - mu * x2 / (a2 * a2 * a2);
+            double df = 1.0 + 2.0 * (1.0 - mu) / (a1 * a1 * a1) + 2.0 * mu / (a2 * a2 * a2);
+            double dx = f / df;
+            x -= dx;
+            if (std::fabs(dx) < 1e-15)
+                break;
+        }
+        return x;
+    }
+
+    /**
+     * @brief Half-period residual F (3) and Jacobian DF (3 x 4) for free variables X = [x0, z0, vy0, T/2].
+     * @return False if propagation failed.
+     */
+    bool HalfPeriodResidual(double mu, const double *X, bool planar, double *F, double *DF)
+    {
+        if (!(X[3] > 0.0))
+            return false;
+
+        double s[6] = {X[0], 0.0, X[1], 0.0, X[2], 0.0};
+        double phi[36];
+        if (!Cr3bpPropagateState(mu, s, X[3], phi))
+            return false;
+
+        double ds[6];
+        Cr3bpDerivatives(mu, s, ds, false);
+
+        const int rows[3] = {1, 3, 5};
+        for (int r = 0; r < 3; ++r)
+        {
+            int k = rows[r];
+            F[r] = s[k];
+            DF[r * 4 + 0] = phi[k * 6 + 0];
+            DF[r * 4 + 1] = phi[k * 6 + 2];
+            DF[r * 4 + 2] = phi[k * 6 + 4];
+            DF[r * 4 + 3] = ds[k];
+        }
+
+        if (planar)
+        {
+            F[2] = X[1];
+            DF[8] = 0.0;
+            DF[9] = 1.0;
+            DF[10] = 0.0;
+            DF[11] = 0.0;
+        }
+        return std::isfinite(F[0]) && std::isfinite(F[1]) && std::isfinite(F[2]);
+    }
+
+    /**
+     * @brief Newton iteration on F(X) = 0 augmented with one scalar constraint.
+     * @param extra Callable (X, row4) -> residual; fills the 4th Jacobian row.
+     */
+    template <typename ExtraConstraint>
+    bool Correct(double mu, double *X, bool planar, ExtraConstraint extra)
+    {
+        for (int iter = 0; iter < CR3BP_MAX_NEWTON; ++iter)
+        {
+            double F[4], J[16];
+            if (!HalfPeriodResidual(mu, X, planar, F, J))
+                return false;
+            F[3] = extra(X, J + 12);
+
+            double norm = 0.0;
+            for (int i = 0; i < 4; ++i)
+                norm = std::max(norm, std::fabs(F[i]));
+            if (norm < CR3BP_NEWTON_TOL)
+                return true;
+
+            double rhs[4] = {-F[0], -F[1], -F[2], -F[3]};
+            if (!SolveLinearSystem(J, rhs, 4))
+                return false;
+
+            // Damp very large updates so Newton cannot jump to a different family.
+            double step = 0.0;
+            for (int i = 0; i < 4; ++i)
+                step = std::max(step, std::fabs(rhs[i]));
+            double scale = step > 0.1 ? 0.1 / step : 1.0;
+            for (int i = 0; i < 4; ++i)
+                X[i] += scale * rhs[i];
+        }
+        return false;
+    }
+
+    bool CorrectFixed(double mu, double *X, bool planar, int fixedIndex)
+    {
+        double target = X[fixedIndex];
+        return Correct(mu, X, planar, [&](const double *x, double *row)
+                       {
+            for (int j = 0; j < 4; ++j)
+                row[j] = j == fixedIndex ? 1.0 : 0.0;
+            return x[fixedIndex] - target; });
+    }
+
+    /** Pseudo-arclength constraint (X - Xprev) · tangent = ds. */
+    bool CorrectArclength(double mu, double *X, bool planar, const double *Xprev, const double *tangent, double ds)
+    {
+        return Correct(mu, X, planar, [&](const double *x, double *row)
+                       {
+            double s = -ds;
+            for (int j = 0; j < 4; ++j)
+            {
+                row[j] = tangent[j];
+                s += (x[j] - Xprev[j]) * tangent[j];
+            }
+            return s; });
+    }
+
+    /** Null vector of the 3 x 4 Jacobian via signed 3x3 minors, normalised. */
+    void FamilyTangent(const double *DF, double *t)
+    {
+        for (int c = 0; c < 4; ++c)
+        {
+            int cols[3], k = 0;
+            for (int j = 0; j < 4; ++j)
+                if (j != c)
+                    cols[k++] = j;
+            const double *a = DF;
+            double det = a[0 * 4 + cols[0]] * (a[1 * 4 + cols[1]] * a[2 * 4 + cols[2]] - a[1 * 4 + cols[2]] * a[2 * 4 + cols[1]]) -
+                         a[0 * 4 + cols[1]] * (a[1 * 4 + cols[0]] * a[2 * 4 + cols[2]] - a[1 * 4 + cols[2]] * a[2 * 4 + cols[0]]) +
+                         a[0 * 4 + cols[2]] * (a[1 * 4 + cols[0]] * a[2 * 4 + cols[1]] - a[1 * 4 + cols[1]] * a[2 * 4 + cols[0]]);
+            t[c] = (c % 2 == 0) ? det : -det;
+        }
+        double n = std::sqrt(t[0] * t[0] + t[1] * t[1] + t[2] * t[2] + t[3] * t[3]);
+        for (int c = 0; c < 4; ++c)
+            t[c] /= n;
+    }
+
+    bool TangentAt(double mu, const double *X, bool planar, double *t)
+    {
+        double F[3], DF[12];
+        if (!HalfPeriodResidual(mu, X, planar, F, DF))
+            return false;
+        FamilyTangent(DF, t);
+        return std::isfinite(t[0]);
+    }
+
+    /** Fills the orbit record (period, Jacobi constant, stability indices) for a corrected X. */
+    void DescribeOrbit(double mu, const double *X, bool converged, Cr3bpOrbit &out, double *monodromyOut = nullptr)
+    {
+        out.x0 = X[0];
+        out.z0 = X[1];
+        out.vy0 = X[2];
+        out.period = 2.0 * X[3];
+        double s[6] = {X[0], 0.0, X[1], 0.0, X[2], 0.0};
+        out.jacobi = Cr3bpJacobi(mu, s);
+        out.converged = converged ? 1 : 0;
+
+        double M[36];
+        Cr3bpMonodromy(mu, out, M);
+        if (monodromyOut != nullptr)
+            std::copy(M, M + 36, monodromyOut);
+
+        // Eigenvalues come as {1, 1, λ1, 1/λ1, λ2, 1/λ2}; with α = λ + 1/λ the traces give
+        // α1 + α2 = tr(M) - 2 and α1² + α2² = tr(M²) + 2.
+        double tr = 0.0, tr2 = 0.0;
+        for (int i = 0; i < 6; ++i)
+        {
+            tr += M[i * 6 + i];
+            for (int k = 0; k < 6; ++k)
+                tr2 += M[i * 6 + k] * M[k * 6 + i];
+        }
+        double s1 = tr - 2.0;
+        double p = 0.5 * (s1 * s1 - (tr2 + 2.0));
+        double disc = std::max(0.0, s1 * s1 - 4.0 * p);
+        double a1 = 0.5 * (s1 + std::sqrt(disc));
+        double a2 = 0.5 * (s1 - std::sqrt(disc));
+        if (std::fabs(a2) > std::fabs(a1))
+            std::swap(a1, a2);
+        out.stability1 = 0.5 * a1;
+        out.stability2 = 0.5 * a2;
+    }
+
+    /** Trace of the out-of-plane (z, vz) block of the monodromy of a planar orbit; equals 2 at the halo bifurcation. */
+    double OutOfPlaneTrace(double mu, const double *X)
+    {
+        Cr3bpOrbit o{X[0], X[1], X[2], 2.0 * X[3], 0, 0, 0, 0};
+        double M[36];
+        Cr3bpMonodromy(mu, o, M);
+        return M[2 * 6 + 2] + M[5 * 6 + 5];
+    }
+
+    /** Corrected small-amplitude Lyapunov orbit from the linearised dynamics about the libration point. */
+    bool SeedLyapunov(double mu, int point, double *X)
+    {
+        double xL = LibrationPointX(mu, point);
+        double d1 = std::fabs(xL + mu), d2 = std::fabs(xL - 1.0 + mu);
+        double c2 = (1.0 - mu) / (d1 * d1 * d1) + mu / (d2 * d2 * d2);
+        double lambda = std::sqrt(0.5 * (2.0 - c2 + std::sqrt(9.0 * c2 * c2 - 8.0 * c2)));
+        double k = (lambda * lambda + 1.0 + 2.0 * c2) / (2.0 * lambda);
+
+        X[0] = xL - CR3BP_SEED_AMPLITUDE;
+        X[1] = 0.0;
+        X[2] = k * CR3BP_SEED_AMPLITUDE * lambda;
+        X[3] = M_PI / lambda;
+        return CorrectFixed(mu, X, true, 0);
+    }
+
+    /**
+     * @brief Continues the Lyapunov family until the out-of-plane trace crosses 2 and
+     * perturbs the bifurcating orbit out of plane to obtain the first halo member.
+     */
+    bool SeedHalo(double mu, int point, double zSign, double step, double *X)
+    {
+        if (!SeedLyapunov(mu, point, X))
+            return false;
+
+        double tangent[4];
+        if (!TangentAt(mu, X, true, tangent))
+            return false;
+        if (tangent[0] * (X[0] - LibrationPointX(mu, point)) < 0.0)
+            for (double &v : tangent)
+                v = -v;
+
+        double prev[4];
+        std::copy(X, X + 4, prev);
+        double prevTrace = OutOfPlaneTrace(mu, X) - 2.0;
+
+        for (int i = 0; i < CR3BP_MAX_BIFURCATION_SEARCH; ++i)
+        {
+            double next[4];
+            for (int j = 0; j < 4; ++j)
+                next[j] = prev[j] + step * tangent[j];
+            if (!CorrectArclength(mu, next, true, prev, tangent, step))
+                return false;
+
+            double trace = OutOfPlaneTrace(mu, next) - 2.0;
+            if ((trace > 0.0) != (prevTrace > 0.0))
+            {
+                double f = prevTrace / (prevTrace - trace);
+                for (int j = 0; j < 4; ++j)
+                    X[j] = prev[j] + f * (next[j] - prev[j]);
+                if (!CorrectFixed(mu, X, true, 0))
+                    return false;
+
+                X[1] = zSign * CR3BP_HALO_SEED_Z;
+                return CorrectFixed(mu, X, false, 1);
+            }
+
+            double newTangent[4];
+            if (!TangentAt(mu, next, true, newTangent))
+                return false;
+            double dot = 0.0;
+            for (int j = 0; j < 4; ++j)
+                dot += newTangent[j] * tangent[j];
+            for (int j = 0; j < 4; ++j)
+                tangent[j] = dot < 0.0 ? -newTangent[j] : newTangent[j];
+
+            std::copy(next, next + 4, prev);
+            prevTrace = trace;
+        }
+        return false;
+    }
+}
+
+/**
+ * @brief Returns the position of a collinear libration point.
+ * @param mu Mass ratio.
+ * @param point 1, 2 or 3.
+ * @return x coordinate (y = z = 0), or NaN if point is not 1, 2 or 3.
+ */
+extern "C" __attribute__((visibility("default"))) double Cr3bpLibrationPoint(double mu, int point)
+{
+    if (!IsCollinearPoint(point))
+        return NAN;
+    return LibrationPointX(mu, point);
+}
+
+/**
+ * @brief Propagates a nondimensional CR3BP state.
+ * @param mu Mass ratio.
+ * @param state 6-element state (in/out).
+ * @param t Propagation time (nondimensional, may be negative).
+ * @param stm Optional 36-element buffer for the row-major state transition matrix.
+ * @return 1 on success.
+ */
+extern "C" __attribute__((visibility("default"))) int Cr3bpPropagate(double mu, double *state, double t, double *stm)
+{
+    return Cr3bpPropagateState(mu, state, t, stm) ? 1 : 0;
+}
+
+/**
+ * @brief Single-shooting differential correction of a symmetric periodic orbit.
+ * @param mu Mass ratio.
+ * @param orbit Initial guess (x0, z0, vy0, period); corrected in place.
+ * @param fixedVariable 0 to hold x0 fixed, 1 to hold z0 fixed. Orbits with z0 = 0 and
+ *                      x0 held fixed are treated as planar.
+ * @return 1 if converged.
+ */
+extern "C" __attribute__((visibility("default"))) int Cr3bpCorrectPeriodic(double mu, Cr3bpOrbit *orbit, int fixedVariable)
+{
+    double X[4] = {orbit->x0, orbit->z0, orbit->vy0, 0.5 * orbit->period};
+    bool planar = orbit->z0 == 0.0 && fixedVariable == 0;
+    bool ok = CorrectFixed(mu, X, planar, fixedVariable == 1 ? 1 : 0);
+    DescribeOrbit(mu, X, ok, *orbit);
+    return ok ? 1 : 0;
+}
+
+/**
+ * @brief Multiple-shooting correction of a periodic orbit from patch points.
+ * Segment i runs from patch i for segmentTimes[i]; continuity is enforced between
+ * consecutive patches and the last segment closes onto the first. The underdetermined
+ * Newton step uses the minimum-norm update and segments are propagated in parallel.
+ *
+ * @param mu Mass ratio.
+ * @param patchStates 6 * numPatches states (in/out).
+ * @param segmentTimes numPatches segment durations (in/out).
+ * @param numPatches Number of patch points (>= 2).
+ * @param maxIterations Newton iteration limit.
+ * @param tolerance Max-norm continuity tolerance.
+ * @return Iterations used, or -1 if not converged.
+ */
+extern "C" __attribute__((visibility("default"))) int Cr3bpMultipleShooting(
+    double mu,
+    double *patchStates,
+    double *segmentTimes,
+    int numPatches,
+    int maxIterations,
+    double tolerance)
+{
+    int N = numPatches;
+    if (N < 2)
+        return -1;
+
+    int rows = 6 * N, cols = 7 * N;
+    std::vector<double> ends(6 * N), phis(36 * N), rates(6 * N);
+    std::vector<int> ok(N);
+    std::vector<double> DF, F(rows), dX(cols);
+
+    for (int iter = 0; iter <= maxIterations; ++iter)
+    {
+        ParallelFor(N, [&](int i)
+                    {
+            double *end = &ends[6 * i];
+            std::copy(patchStates + 6 * i, patchStates + 6 * i + 6, end);
+            ok[i] = Cr3bpPropagateState(mu, end, segmentTimes[i], &phis[36 * i]) ? 1 : 0;
+            Cr3bpDerivatives(mu, end, &rates[6 * i], false); });
+
+        for (int i = 0; i < N; ++i)
+            if (!ok[i])
+                return -1;
+
+        double norm = 0.0;
+        for (int i = 0; i < N; ++i)
+        {
+            int nextPatch = (i + 1) % N;
+            for (int k = 0; k < 6; ++k)
+            {
+                F[6 * i + k] = ends[6 * i + k] - patchStates[6 * nextPatch + k];
+                norm = std::max(norm, std::fabs(F[6 * i + k]));
+            }
+        }
+        if (norm < tolerance)
+            return iter;
+        if (iter == maxIterations)
+            break;
+
+        // Unknowns: [X_0..X_{N-1} (6 each), t_0..t_{N-1}].
+        DF.assign((size_t)rows * cols, 0.0);
+        for (int i = 0; i < N; ++i)
+        {
+            int nextPatch = (i + 1) % N;
+            for (int r = 0; r < 6; ++r)
+            {
+                double *row = &DF[(size_t)(6 * i + r) * cols];
+                for (int c = 0; c < 6; ++c)
+                    row[6 * i + c] += phis[36 * i + r * 6 + c];
+                row[6 * nextPatch + r] -= 1.0;
+                row[6 * N + i] = rates[6 * i + r];
+            }
+        }
+
+        for (double &v : F)
+            v = -v;
+        if (!SolveMinimumNorm(DF.data(), F.data(), rows, cols, dX.data()))
+            return -1;
+
+        for (int i = 0; i < 6 * N; ++i)
+            patchStates[i] += dX[i];
+        for (int i = 0; i < N; ++i)
+            segmentTimes[i] += dX[6 * N + i];
+    }
+    return -1;
+}
+
+/**
+ * @brief Generates a family of periodic orbits by pseudo-arclength continuation.
+ *
+ * Every CR3BP_FILL_PER_ANCHOR-th member is an anchor traced sequentially with a coarse
+ * arclength step; the members between consecutive anchors are independent corrections on
+ * hyperplanes through the chord and are solved in parallel, as is the monodromy/stability
+ * evaluation of every member. Halo families are seeded at the bifurcation from the planar
+ * Lyapunov family and, continued far enough, become near-rectilinear halo orbits (NRHOs).
+ *
+ * @param mu Mass ratio.
+ * @param librationPoint 1, 2 or 3.
+ * @param family 0 = planar Lyapunov, 1 = northern halo, 2 = southern halo.
+ * @param step Arclength between consecutive members in free-variable space (e.g. 1e-3).
+ * @param maxMembers Capacity of the output buffer.
+ * @param out Output orbits.
+ * @return Number of members written, or -1 if librationPoint or family is out of range.
+ */
+extern "C" __attribute__((visibility("default"))) int Cr3bpGenerateFamily(
+    double mu,
+    int librationPoint,
+    int family,
+    double step,
+    int maxMembers,
+    Cr3bpOrbit *out)
+{
+    if (!IsCollinearPoint(librationPoint) || family < CR3BP_LYAPUNOV || family > CR3BP_HALO_SOUTH)
+        return -1;
+    if (maxMembers <= 0 || step <= 0.0)
+        return 0;
+
+    bool planar = family == CR3BP_LYAPUNOV;
+    double X[4];
+    bool seeded = planar ? SeedLyapunov(mu, librationPoint, X)
+                         : SeedHalo(mu, librationPoint, family == CR3BP_HALO_SOUTH ? -1.0 : 1.0, step, X);
+    if (!seeded)
+        return 0;
+
+    // Orient the tangent so the family grows away from the libration point / plane.
+    double tangent[4];
+    if (!TangentAt(mu, X, planar, tangent))
+        return 0;
+    double grow = planar ? tangent[0] * (X[0] - LibrationPointX(mu, librationPoint)) : tangent[1] * X[1];
+    if (grow < 0.0)
+        for (double &v : tangent)
+            v = -v;
+
+    const int K = CR3BP_FILL_PER_ANCHOR;
+    int anchorCount = (maxMembers - 1 + K - 1) / K + 1;
+    std::vector<double> anchors;
+    anchors.insert(anchors.end(), X, X + 4);
+
+    double ds = step * K;
+    while ((int)anchors.size() / 4 < anchorCount)
+    {
+        const double *prev = &anchors[anchors.size() - 4];
+        double next[4];
+        bool ok = false;
+        for (int attempt = 0; attempt < 5 && !ok; ++attempt)
+        {
+            for (int j = 0; j < 4; ++j)
+                next[j] = prev[j] + ds * tangent[j];
+            ok = CorrectArclength(mu, next, planar, prev, tangent, ds);
+            if (!ok)
+                ds *= 0.5;
+        }
+        if (!ok)
+            break;
+
+        double newTangent[4];
+        if (!TangentAt(mu, next, planar, newTangent))
+            break;
+        double dot = 0.0;
+        for (int j = 0; j < 4; ++j)
+            dot += newTangent[j] * tangent[j];
+        for (int j = 0; j < 4; ++j)
+            tangent[j] = dot < 0.0 ? -newTangent[j] : newTangent[j];
+
+        anchors.insert(anchors.end(), next, next + 4);
+    }
+
+    int anchorsFound = (int)anchors.size() / 4;
+    int members = std::min(maxMembers, (anchorsFound - 1) * K + 1);
+    std::vector<double> Xs((size_t)members * 4);
+    std::vector<int> converged(members, 0);
+
+    ParallelFor(members, [&](int m)
+                {
+        int a = m / K, j = m % K;
+        double *x = &Xs[(size_t)m * 4];
+        const double *A = &anchors[(size_t)a * 4];
+        if (j == 0)
+        {
+            std::copy(A, A + 4, x);
+            converged[m] = 1;
+        }
+        else
+        {
+            const double *B = &anchors[(size_t)(a + 1) * 4];
+            double normal[4], guess[4], len = 0.0;
+            for (int k = 0; k < 4; ++k)
+            {
+                normal[k] = B[k] - A[k];
+                len += normal[k] * normal[k];
+                guess[k] = A[k] + (double)j / K * normal[k];
+                x[k] = guess[k];
+            }
+            len = std::sqrt(len);
+            for (double &v : normal)
+                v /= len;
+            converged[m] = CorrectArclength(mu, x, planar, guess, normal, 0.0) ? 1 : 0;
+        }
+        DescribeOrbit(mu, x, converged[m] != 0, out[m]); });
+
+    return members;
+}
+
+/**
+ * @brief Samples one period of an orbit for display.
+ * @param mu Mass ratio.
+ * @param orbit Orbit to sample.
+ * @param numPoints Number of samples (evenly spaced in time over one period).
+ * @param points Output positions in the rotating frame.
+ * @return Number of samples written.
+ */
+extern "C" __attribute__((visibility("default"))) int Cr3bpSampleOrbit(double mu, const Cr3bpOrbit *orbit, int numPoints, double3 *points)
+{
+    if (numPoints <= 0)
+        return 0;
+    double s[6] = {orbit->x0, 0.0, orbit->z0, 0.0, orbit->vy0, 0.0};
+    double dt = orbit->period / numPoints;
+    for (int i = 0; i < numPoints; ++i)
+    {
+        points[i] = {s[0], s[1], s[2]};
+        if (!Cr3bpPropagateState(mu, s, dt, nullptr))
+            return i + 1;
+    }
+    return numPoints;
+}
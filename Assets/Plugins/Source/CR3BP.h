@@ -0,0 +1,72 @@
+#pragma once
+
+#include "AdaptiveDopri.h"
+
+/**
+ * @file CR3BP.h
+ * @brief Circular restricted three-body problem in the nondimensional rotating frame.
+ *
+ * Units: distance = primary separation, time = 1 / mean motion (one revolution = 2π),
+ * mass ratio mu = m2 / (m1 + m2). The larger primary sits at (-mu, 0, 0) and the smaller
+ * at (1 - mu, 0, 0).
+ */
+
+const double CR3BP_RTOL = 1e-12; ///< Relative tolerance for CR3BP propagation.
+const double CR3BP_ATOL = 1e-13; ///< Absolute tolerance for CR3BP propagation.
+
+extern "C"
+{
+    /**
+     * @struct Cr3bpOrbit
+     * @brief A symmetric periodic orbit, stored by its perpendicular x-z plane crossing.
+     * Layout must match NativePhysics.Cr3bpOrbit on the C# side.
+     */
+    struct Cr3bpOrbit
+    {
+        double x0;         ///< Initial x (nondimensional).
+        double z0;         ///< Initial z.
+        double vy0;        ///< Initial y velocity.
+        double period;     ///< Full period.
+        double jacobi;     ///< Jacobi constant.
+        double stability1; ///< Larger stability index ½(λ + 1/λ) of the monodromy matrix.
+        double stability2; ///< Smaller stability index.
+        int converged;     ///< Non-zero if the corrector converged.
+    };
+}
+
+/**
+ * @brief State derivative, optionally with the 6x6 state transition matrix appended (42 values).
+ */
+void Cr3bpDerivatives(double mu, const double *x, double *dx, bool withStm);
+
+/**
+ * @brief Jacobi constant of a state.
+ */
+double Cr3bpJacobi(double mu, const double *x);
+
+/**
+ * @brief Propagates a 6-state (and optionally its STM) for time t.
+ * @param stm If non-null, receives the 6x6 row-major STM Φ(t, 0).
+ * @return False if the integrator failed to reach t.
+ */
+bool Cr3bpPropagateState(double mu, double *state, double t, double *stm);
+
+/**
+ * @brief Propagates a 6-state and reports every accepted step to an observer.
+ * @param onStep Callable (ta, xa, dxa, tb, xb, dxb) returning false to stop early.
+ * @return Time reached.
+ */
+template <typename StepObserver>
+double Cr3bpPropagateObserved(double mu, double *state, double t, StepObserver onStep)
+{
+    return DormandPrinceAdaptive<6>(
+        state, 0.0, t, CR3BP_RTOL, CR3BP_ATOL, 6,
+        [mu](double, const double *x, double *dx)
+        { Cr3bpDerivatives(mu, x, dx, false); },
+        onStep);
+}
+
+/**
+ * @brief Monodromy matrix of a periodic orbit (STM over one full period).
+ */
+void Cr3bpMonodromy(double mu, const Cr3bpOrbit &orbit, double *monodromy);
@@ -0,0 +1,313 @@
+#include <algorithm>
+#include <cmath>
+
+#include "Catalog.h"
+#include "Kepler.h"
+#include "ThreadPool.h"
+
+const double DRAG_SUBSTEP = 86400.0; ///< Interval over which the decay rate is held constant (s).
+
+/** Rotates v by angle about a unit axis (Rodrigues). */
+static Vector3d RotateAbout(const Vector3d &v, const Vector3d &axis, double angle)
+{
+    double c = std::cos(angle), s = std::sin(angle);
+    return v * c + Cross(axis, v) * s + axis * (Dot(axis, v) * (1 - c));
+}
+
+void J2SecularRates(double a, double e, double i, double mu, double &raanDot, double &argpDot, double &meanAnomalyDot)
+{
+    double n = std::sqrt(mu / (a * a * a));
+    double p = a * (1 - e * e);
+    double k = 1.5 * EARTH_J2 * n * (EARTH_RADIUS / p) * (EARTH_RADIUS / p);
+    double s2 = std::sin(i) * std::sin(i);
+    raanDot = -k * std::cos(i);
+    argpDot = k * (2 - 2.5 * s2);
+    meanAnomalyDot = k * std::sqrt(1 - e * e) * (1 - 1.5 * s2);
+}
+
+double DragDecayRate(double a, double ballistic, double mu)
+{
+    if (ballistic <= 0)
+        return 0.0;
+    double rho = ComputeAtmosphericDensity(std::max(0.0, (a - EARTH_RADIUS) * UNIT_TO_KM));
+    // rho [kg/km³] * B [m²/kg] -> 1/km, then per sim unit.
+    double rhoB = rho * ballistic * 1e-6 * UNIT_TO_KM;
+    return -rhoB * std::sqrt(mu * a);
+}
+
+int Catalog::Upsert(int id, const Vector3d &r, const Vector3d &v, double t, double hardBodyRadius)
+{
+    int i = Find(id);
+    if (i < 0)
+    {
+        i = Count();
+        indexOf[id] = i;
+        ids.push_back(id);
+        px.push_back(0), py.push_back(0), pz.push_back(0);
+        vx.push_back(0), vy.push_back(0), vz.push_back(0);
+        epoch.push_back(0);
+        radius.push_back(0);
+        ballistic.push_back(0);
+        meanElements.push_back({});
+        revision.push_back(0);
+    }
+    px[i] = r.x, py[i] = r.y, pz[i] = r.z;
+    vx[i] = v.x, vy[i] = v.y, vz[i] = v.z;
+    epoch[i] = t;
+    radius[i] = hardBodyRadius;
+
+    // Mean elements back the regime filters; fall back to osculating ones where the theory does not apply.
+    OrbitalElements osc{};
+    StateToElements(r, v, mu, osc);
+    if (!OsculatingToMean(osc, meanElements[i]))
+        meanElements[i] = osc;
+    Touch(i);
+    return i;
+}
+
+bool Catalog::Remove(int id)
+{
+    int i = Find(id);
+    if (i < 0)
+        return false;
+
+    int last = Count() - 1;
+    if (i != last)
+    {
+        ids[i] = ids[last];
+        px[i] = px[last], py[i] = py[last], pz[i] = pz[last];
+        vx[i] = vx[last], vy[i] = vy[last], vz[i] = vz[last];
+        epoch[i] = epoch[last];
+        radius[i] = radius[last];
+        ballistic[i] = ballistic[last];
+        meanElements[i] = meanElements[last];
+        revision[i] = revision[last];
+        indexOf[ids[i]] = i;
+    }
+    ids.pop_back();
+    px.pop_back(), py.pop_back(), pz.pop_back();
+    vx.pop_back(), vy.pop_back(), vz.pop_back();
+    epoch.pop_back();
+    radius.pop_back();
+    ballistic.pop_back();
+    meanElements.pop_back();
+    revision.pop_back();
+    indexOf.erase(id);
+    ++changeCounter;
+    return true;
+}
+
+void Catalog::Clear()
+{
+    ids.clear();
+    px.clear(), py.clear(), pz.clear();
+    vx.clear(), vy.clear(), vz.clear();
+    epoch.clear();
+    radius.clear();
+    ballistic.clear();
+    meanElements.clear();
+    revision.clear();
+    indexOf.clear();
+    tombstones.clear();
+    ++changeCounter;
+}
+
+bool Catalog::Propagate(const Vector3d &r0, const Vector3d &v0, double dt, double ballistic, Vector3d &r, Vector3d &v) const
+{
+    double r0n = Norm(r0);
+    double energy = 0.5 * Dot(v0, v0) - mu / r0n;
+    if (energy >= 0)
+        return KeplerPropagate(r0, v0, mu, dt, r, v);
+
+    Vector3d h = Cross(r0, v0);
+    double hn = Norm(h);
+    Vector3d hHat = h * (1.0 / hn);
+    Vector3d ecc = Cross(v0, h) * (1.0 / mu) - r0 * (1.0 / r0n);
+    double a0 = -mu / (2 * energy);
+    double e = std::min(Norm(ecc), 0.999);
+    double inc = std::acos(std::clamp(hHat.z, -1.0, 1.0));
+    double n0 = std::sqrt(mu / (a0 * a0 * a0));
+
+    double raanDot, argpDot, meanAnomalyDot;
+    J2SecularRates(a0, e, inc, mu, raanDot, argpDot, meanAnomalyDot);
+
+    // Drag: hold da/dt constant over substeps and accumulate the resulting along-track phase.
+    double a = a0, phase = 0.0, decay = 0.0;
+    if (ballistic > 0 && (a0 * (1 - e) - EARTH_RADIUS) * UNIT_TO_KM < 500.0)
+    {
+        int steps = std::max(1, (int)std::ceil(std::fabs(dt) / DRAG_SUBSTEP));
+        double span = dt / steps;
+        for (int k = 0; k < steps; ++k)
+        {
+            double aDot = DragDecayRate(a, ballistic, mu);
+            double n = std::sqrt(mu / (a * a * a));
+            phase += (n - n0) * span - 0.75 * n / a * aDot * span * span;
+            a += aDot * span;
+            if ((a - EARTH_RADIUS) * UNIT_TO_KM < DECAY_ALTITUDE_KM)
+                return false;
+        }
+        decay = DragDecayRate(a, ballistic, mu);
+    }
+
+    // Two-body motion advanced by the extra mean motion, then the secular rotations.
+    Vector3d rK, vK;
+    if (!KeplerPropagate(r0, v0, mu, dt + (meanAnomalyDot * dt + phase) / n0, rK, vK))
+        return false;
+    Vector3d zHat{0, 0, 1};
+    r = RotateAbout(RotateAbout(rK * (a / a0), hHat, argpDot * dt), zHat, raanDot * dt);
+
+    // v is the time derivative of r: the Kepler velocity at the rate the anomaly advances, the
+    // shrinking scale under drag, and the rotation of the perigee and the node.
+    double n = std::sqrt(mu / (a * a * a));
+    v = vK * ((a / a0) * (n + meanAnomalyDot) / n0) + rK * (decay / a0);
+    v = RotateAbout(RotateAbout(v, hHat, argpDot * dt), zHat, raanDot * dt);
+    v = v + Cross(RotateAbout(hHat, zHat, raanDot * dt), r) * argpDot + Cross(zHat, r) * raanDot;
+    return true;
+}
+
+OrbitalElements Catalog::MeanElementsAt(int i, double t) const
+{
+    OrbitalElements el = meanElements[i];
+    if (el.a <= 0)
+        return el;
+
+    double dt = t - epoch[i];
+    double raanDot, argpDot, meanAnomalyDot;
+    J2SecularRates(el.a, el.e, el.i, mu, raanDot, argpDot, meanAnomalyDot);
+    double n = std::sqrt(mu / (el.a * el.a * el.a));
+    el.raan = std::fmod(el.raan + raanDot * dt, 2 * M_PI);
+    el.argp = std::fmod(el.argp + argpDot * dt, 2 * M_PI);
+    el.meanAnomaly = std::fmod(el.meanAnomaly + (n + meanAnomalyDot) * dt, 2 * M_PI);
+    el.raan += el.raan < 0 ? 2 * M_PI : 0;
+    el.argp += el.argp < 0 ? 2 * M_PI : 0;
+    el.meanAnomaly += el.meanAnomaly < 0 ? 2 * M_PI : 0;
+    if (ballistic[i] > 0)
+        el.a = std::max(EARTH_RADIUS, el.a + DragDecayRate(el.a, ballistic[i], mu) * dt);
+    return el;
+}
+
+bool Catalog::StateAt(int i, double t, Vector3d &r, Vector3d &v) const
+{
+    Vector3d r0{px[i], py[i], pz[i]}, v0{vx[i], vy[i], vz[i]};
+    return Propagate(r0, v0, t - epoch[i], ballistic[i], r, v);
+}
+
+Catalog &GetCatalog()
+{
+    static Catalog catalog;
+    return catalog;
+}
+
+/**
+ * @brief Inserts or updates a catalog object.
+ * @param id Caller-chosen object id.
+ * @param position Position relative to Earth (inertial, Z = rotation axis, sim units).
+ * @param velocity Velocity (units/s).
+ * @param epoch Simulation time of the state (s).
+ * @param hardBodyRadius Hard-body radius used for collision probability (units).
+ * @return Catalog index of the object.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogUpsert(int id, double3 position, double3 velocity, double epoch, double hardBodyRadius)
+{
+    return GetCatalog().Upsert(id, ToVector3dFromDouble3(position), ToVector3dFromDouble3(velocity), epoch, hardBodyRadius);
+}
+
+/**
+ * @brief Removes a catalog object.
+ * @return 1 if the object existed.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogRemove(int id)
+{
+    return GetCatalog().Remove(id) ? 1 : 0;
+}
+
+/**
+ * @brief Removes every catalog object.
+ */
+extern "C" __attribute__((visibility("default"))) void CatalogClear()
+{
+    GetCatalog().Clear();
+}
+
+/**
+ * @brief Number of catalog objects.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogCount()
+{
+    return GetCatalog().Count();
+}
+
+/**
+ * @brief Sets the ballistic coefficient used for drag decay.
+ * @param id Object id.
+ * @param ballisticCoefficient Cd·A/m in m²/kg; 0 disables drag.
+ * @return 1 if the object exists.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogSetBallisticCoefficient(int id, double ballisticCoefficient)
+{
+    Catalog &c = GetCatalog();
+    int i = c.Find(id);
+    if (i < 0)
+        return 0;
+    c.ballistic[i] = ballisticCoefficient;
+    c.Touch(i);
+    return 1;
+}
+
+/**
+ * @brief Propagates a catalog object to a given time.
+ * @return 1 on success, 0 if the id is unknown or propagation failed.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogGetState(int id, double time, double3 *position, double3 *velocity)
+{
+    const Catalog &c = GetCatalog();
+    int i = c.Find(id);
+    Vector3d r, v;
+    if (i < 0 || !c.StateAt(i, time, r, v))
+        return 0;
+    *position = ToDouble3(r);
+    *velocity = ToDouble3(v);
+    return 1;
+}
+
+/**
+ * @brief Mean elements of a catalog object at a given time.
+ * @return 1 on success, 0 if the id is unknown.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogGetMeanElements(int id, double time, OrbitalElements *elements)
+{
+    const Catalog &c = GetCatalog();
+    int i = c.Find(id);
+    if (i < 0)
+        return 0;
+    *elements = c.MeanElementsAt(i, time);
+    return 1;
+}
+
+/**
+ * @brief Propagates every catalog object to a given time in parallel.
+ * @param time Simulation time (s).
+ * @param ids Output ids (capacity maxCount).
+ * @param positions Output positions.
+ * @param velocities Output velocities.
+ * @param valid Output flags, 0 where propagation failed (e.g. decayed), or null.
+ * @param maxCount Capacity of the output arrays.
+ * @return Number of objects written.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogGetStates(double time, int *ids, double3 *positions, double3 *velocities,
+                                                                       int *valid, int maxCount)
+{
+    const Catalog &c = GetCatalog();
+    int n = std::min(c.Count(), maxCount);
+    ParallelFor(n, [&](int i)
+    {
+        Vector3d r{0, 0, 0}, v{0, 0, 0};
+        bool ok = c.StateAt(i, time, r, v);
+        ids[i] = c.ids[i];
+        positions[i] = ToDouble3(r);
+        velocities[i] = ToDouble3(v);
+        if (valid)
+            valid[i] = ok ? 1 : 0;
+    });
+    return n;
+}
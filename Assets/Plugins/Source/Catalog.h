@@ -0,0 +1,106 @@
+#pragma once
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "MeanElements.h"
+#include "PhysicsCommon.h"
+
+/**
+ * @file Catalog.h
+ * @brief Native object catalog in structure-of-arrays layout.
+ *
+ * Each entry is an osculating state at its own epoch, relative to Earth's centre in an
+ * inertial frame with Z along the rotation axis (the C# side swaps Unity's Y-up), in sim
+ * units (1 unit = 10 km). Times are simulation seconds. States are propagated with two-body
+ * motion plus J2 secular drift and, below the top of the density profile, drag decay. The catalog is owned by the plugin
+ * and mutated only through the exported C API from the main thread; batch jobs read it
+ * concurrently.
+ */
+
+const double EARTH_MU = G * 5.972e24;                    ///< Earth's gravitational parameter (units³/s²).
+const double EARTH_J2 = 1.08262668e-3;                   ///< Earth's second zonal harmonic.
+const double EARTH_RADIUS = EARTH_RADIUS_KM / UNIT_TO_KM; ///< Earth's equatorial radius (units).
+const double DECAY_ALTITUDE_KM = 100.0;                  ///< Altitude at which an object is considered decayed.
+
+/**
+ * @brief Secular J2 rates of the node, argument of perigee and mean anomaly (beyond n).
+ * @param a Semi-major axis (units).
+ * @param e Eccentricity.
+ * @param i Inclination (rad).
+ * @param mu Gravitational parameter.
+ */
+void J2SecularRates(double a, double e, double i, double mu, double &raanDot, double &argpDot, double &meanAnomalyDot);
+
+/**
+ * @brief Orbit-averaged semi-major axis decay rate from drag for a near-circular orbit.
+ * @param a Semi-major axis (units).
+ * @param ballistic Ballistic coefficient Cd·A/m (m²/kg).
+ * @return da/dt (units/s, negative).
+ */
+double DragDecayRate(double a, double ballistic, double mu);
+
+struct Catalog
+{
+    std::vector<int> ids;
+    std::vector<double> px, py, pz; ///< Position at epoch.
+    std::vector<double> vx, vy, vz; ///< Velocity at epoch.
+    std::vector<double> epoch;      ///< Epoch of the state (s).
+    std::vector<double> radius;     ///< Hard-body radius (units).
+    std::vector<double> ballistic;  ///< Ballistic coefficient Cd·A/m (m²/kg); 0 disables drag.
+    std::vector<OrbitalElements> meanElements; ///< Brouwer–Lyddane mean elements at epoch.
+    std::vector<uint64_t> revision; ///< Value of changeCounter when the entry last changed.
+    std::unordered_map<int, int> indexOf;
+    std::unordered_map<int, double> tombstones; ///< Decay time (s) of removed decayed objects, by id.
+    uint64_t changeCounter = 0; ///< Bumped on every insert, update and removal.
+    double mu = EARTH_MU;
+
+    int Count() const { return (int)ids.size(); }
+
+    /** Index of an id, or -1. */
+    int Find(int id) const
+    {
+        auto it = indexOf.find(id);
+        return it == indexOf.end() ? -1 : it->second;
+    }
+
+    /** Inserts or replaces an entry; returns its index. */
+    int Upsert(int id, const Vector3d &r, const Vector3d &v, double t, double hardBodyRadius);
+
+    /** Marks entry i as changed so derived indexes pick it up. */
+    void Touch(int i) { revision[i] = ++changeCounter; }
+
+    /** Removes an entry (swap with the last); returns false if the id is unknown. */
+    bool Remove(int id);
+
+    /** Removes a decayed object and remembers it, so older element sets cannot bring it back. */
+    void Tombstone(int id, double t)
+    {
+        Remove(id);
+        tombstones[id] = t;
+    }
+
+    void Clear();
+
+    /**
+     * @brief Propagates a state with the catalog's force model.
+     * @param ballistic Ballistic coefficient (m²/kg), 0 for no drag.
+     * @return False if propagation failed or the orbit decayed.
+     */
+    bool Propagate(const Vector3d &r0, const Vector3d &v0, double dt, double ballistic, Vector3d &r, Vector3d &v) const;
+
+    /**
+     * @brief Mean elements of entry i at time t, advanced with the secular J2 rates and drag decay.
+     */
+    OrbitalElements MeanElementsAt(int i, double t) const;
+
+    /**
+     * @brief State of entry i at time t.
+     * @return False if propagation failed.
+     */
+    bool StateAt(int i, double t, Vector3d &r, Vector3d &v) const;
+};
+
+/** The plugin-wide catalog. */
+Catalog &GetCatalog();
@@ -0,0 +1,368 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Catalog.h"
+
+/**
+ * @file CatalogQuery.cpp
+ * @brief Interval indexes over catalog mean elements for regime queries.
+ *
+ * Each indexed quantity (mean perigee and apogee altitude, inclination, RAAN) is stored per object
+ * as the interval it sweeps over an index window, so drift (nodal regression, drag decay) is
+ * covered without re-sorting while queries stay inside the window. Intervals are kept sorted by
+ * their lower bound; with the widest interval known, the candidates for a range query form one
+ * contiguous span found by binary search. A compound query walks the smallest span and checks
+ * every predicate exactly at the query time.
+ *
+ * The index follows the catalog incrementally through the per-entry revision counters, and is
+ * rebuilt when many entries changed or a query falls outside the window.
+ */
+
+const double REGIME_INDEX_WINDOW = 86400.0;  ///< Span over which the drift intervals are valid (s).
+const double REGIME_REBUILD_FRACTION = 0.05; ///< Rebuild instead of patching above this fraction of changes.
+
+enum RegimeFilter
+{
+    REGIME_PERIGEE = 1,
+    REGIME_APOGEE = 2,
+    REGIME_INCLINATION = 4,
+    REGIME_RAAN = 8,
+};
+
+extern "C"
+{
+    /**
+     * @struct RegimeQuery
+     * @brief Compound range query on mean elements; layout must match NativePhysics.RegimeQuery.
+     */
+    struct RegimeQuery
+    {
+        double perigeeMin, perigeeMax;         ///< Mean perigee altitude (units).
+        double apogeeMin, apogeeMax;           ///< Mean apogee altitude (units).
+        double inclinationMin, inclinationMax; ///< Mean inclination (rad).
+        double raanMin, raanMax;               ///< Mean RAAN in [0, 2π) (rad); raanMin > raanMax wraps through 0.
+        int filters;                           ///< Bitmask of active ranges: 1 perigee, 2 apogee, 4 inclination, 8 RAAN.
+        int reserved;
+    };
+}
+
+namespace
+{
+    struct IntervalEntry
+    {
+        double lo, hi;
+        int id;
+    };
+
+    /** Intervals sorted by lower bound. */
+    struct IntervalIndex
+    {
+        std::vector<IntervalEntry> entries;
+        double maxWidth = 0;
+
+        void Sort()
+        {
+            std::sort(entries.begin(), entries.end(), [](const IntervalEntry &a, const IntervalEntry &b)
+                      { return a.lo < b.lo; });
+            maxWidth = 0;
+            for (const IntervalEntry &e : entries)
+                maxWidth = std::max(maxWidth, e.hi - e.lo);
+        }
+
+        void Insert(const IntervalEntry &e)
+        {
+            auto it = std::upper_bound(entries.begin(), entries.end(), e.lo, [](double lo, const IntervalEntry &x)
+                                       { return lo < x.lo; });
+            entries.insert(it, e);
+            maxWidth = std::max(maxWidth, e.hi - e.lo);
+        }
+
+        void Erase(int id, double lo)
+        {
+            auto it = std::lower_bound(entries.begin(), entries.end(), lo, [](const IntervalEntry &x, double v)
+                                       { return x.lo < v; });
+            for (; it != entries.end() && it->lo == lo; ++it)
+            {
+                if (it->id == id)
+                {
+                    entries.erase(it);
+                    return;
+                }
+            }
+        }
+
+        /** Index range [first, last) of entries whose interval may overlap [a, b]. */
+        std::pair<int, int> Span(double a, double b) const
+        {
+            auto cmp = [](const IntervalEntry &x, double v)
+            { return x.lo < v; };
+            int first = (int)(std::lower_bound(entries.begin(), entries.end(), a - maxWidth, cmp) - entries.begin());
+            int last = (int)(std::upper_bound(entries.begin(), entries.end(), b, [](double v, const IntervalEntry &x)
+                                              { return v < x.lo; }) -
+                             entries.begin());
+            return {first, std::max(first, last)};
+        }
+    };
+
+    struct IndexedObject
+    {
+        double lo[4]; ///< Lower bounds in each index, needed to erase the entry.
+        bool indexed;
+    };
+
+    struct RegimeIndex
+    {
+        IntervalIndex index[4]; ///< Perigee, apogee, inclination, RAAN.
+        std::unordered_map<int, IndexedObject> objects;
+        double windowStart = NAN;
+        uint64_t synced = 0;
+    };
+
+    RegimeIndex &GetRegimeIndex()
+    {
+        static RegimeIndex index;
+        return index;
+    }
+
+    /** Intervals swept by catalog entry i over [t0, t0 + window]. */
+    bool Intervals(const Catalog &catalog, int i, double t0, IntervalEntry out[4])
+    {
+        OrbitalElements e0 = catalog.MeanElementsAt(i, t0);
+        OrbitalElements e1 = catalog.MeanElementsAt(i, t0 + REGIME_INDEX_WINDOW);
+        if (!(e0.a > 0) || e0.e >= 1)
+            return false;
+
+        int id = catalog.ids[i];
+        double p0 = e0.a * (1 - e0.e) - EARTH_RADIUS, p1 = e1.a * (1 - e1.e) - EARTH_RADIUS;
+        double q0 = e0.a * (1 + e0.e) - EARTH_RADIUS, q1 = e1.a * (1 + e1.e) - EARTH_RADIUS;
+        out[0] = {std::min(p0, p1), std::max(p0, p1), id};
+        out[1] = {std::min(q0, q1), std::max(q0, q1), id};
+        out[2] = {e0.i, e0.i, id};
+
+        double raanDot, argpDot, meanAnomalyDot;
+        J2SecularRates(e0.a, e0.e, e0.i, catalog.mu, raanDot, argpDot, meanAnomalyDot);
+        double sweep = raanDot * REGIME_INDEX_WINDOW;
+        if (std::fabs(sweep) >= 2 * M_PI)
+            out[3] = {0, 2 * M_PI, id};
+        else
+        {
+            double lo = std::fmod(e0.raan + std::min(0.0, sweep), 2 * M_PI);
+            lo += lo < 0 ? 2 * M_PI : 0;
+            out[3] = {lo, lo + std::fabs(sweep), id};
+        }
+        return true;
+    }
+
+    void Add(RegimeIndex &index, const Catalog &catalog, int i, bool sorted)
+    {
+        IntervalEntry e[4];
+        IndexedObject &o = index.objects[catalog.ids[i]];
+        o.indexed = Intervals(catalog, i, index.windowStart, e);
+        if (!o.indexed)
+            return;
+        for (int k = 0; k < 4; ++k)
+        {
+            o.lo[k] = e[k].lo;
+            if (sorted)
+                index.index[k].Insert(e[k]);
+            else
+                index.index[k].entries.push_back(e[k]);
+        }
+    }
+
+    void Remove(RegimeIndex &index, int id)
+    {
+        auto it = index.objects.find(id);
+        if (it == index.objects.end())
+            return;
+        if (it->second.indexed)
+            for (int k = 0; k < 4; ++k)
+                index.index[k].Erase(id, it->second.lo[k]);
+        index.objects.erase(it);
+    }
+
+    void Rebuild(RegimeIndex &index, const Catalog &catalog, double t)
+    {
+        index.windowStart = t;
+        index.objects.clear();
+        for (IntervalIndex &x : index.index)
+            x.entries.clear();
+        for (int i = 0; i < catalog.Count(); ++i)
+            Add(index, catalog, i, false);
+        for (IntervalIndex &x : index.index)
+            x.Sort();
+        index.synced = catalog.changeCounter;
+    }
+
+    /** Brings the index up to date with the catalog for a query at time t. */
+    void Sync(RegimeIndex &index, const Catalog &catalog, double t)
+    {
+        if (std::isnan(index.windowStart) || t < index.windowStart || t > index.windowStart + REGIME_INDEX_WINDOW)
+        {
+            Rebuild(index, catalog, t);
+            return;
+        }
+        if (catalog.changeCounter == index.synced)
+            return;
+
+        std::vector<int> changed;
+        for (int i = 0; i < catalog.Count(); ++i)
+            if (catalog.revision[i] > index.synced)
+                changed.push_back(i);
+        if (changed.size() > REGIME_REBUILD_FRACTION * catalog.Count())
+        {
+            Rebuild(index, catalog, t);
+            return;
+        }
+
+        // Drop removed objects, then re-insert changed ones.
+        std::vector<int> removed;
+        for (const auto &kv : index.objects)
+            if (catalog.Find(kv.first) < 0)
+                removed.push_back(kv.first);
+        for (int id : removed)
+            Remove(index, id);
+        for (int i : changed)
+        {
+            Remove(index, catalog.ids[i]);
+            Add(index, catalog, i, true);
+        }
+        index.synced = catalog.changeCounter;
+    }
+
+    bool InRange(double x, double lo, double hi)
+    {
+        return x >= lo && x <= hi;
+    }
+
+    bool Matches(const RegimeQuery &q, const OrbitalElements &el)
+    {
+        double perigee = el.a * (1 - el.e) - EARTH_RADIUS;
+        double apogee = el.a * (1 + el.e) - EARTH_RADIUS;
+        if ((q.filters & REGIME_PERIGEE) && !InRange(perigee, q.perigeeMin, q.perigeeMax))
+            return false;
+        if ((q.filters & REGIME_APOGEE) && !InRange(apogee, q.apogeeMin, q.apogeeMax))
+            return false;
+        if ((q.filters & REGIME_INCLINATION) && !InRange(el.i, q.inclinationMin, q.inclinationMax))
+            return false;
+        if (q.filters & REGIME_RAAN)
+        {
+            bool in = q.raanMin <= q.raanMax ? InRange(el.raan, q.raanMin, q.raanMax)
+                                             : (el.raan >= q.raanMin || el.raan <= q.raanMax);
+            if (!in)
+                return false;
+        }
+        return true;
+    }
+
+    /** Candidate spans of one filter, merged so no entry is visited twice. */
+    std::vector<std::pair<int, int>> Spans(const IntervalIndex &x, int filter, const RegimeQuery &q)
+    {
+        std::vector<std::pair<int, int>> spans;
+        switch (filter)
+        {
+        case 0:
+            spans.push_back(x.Span(q.perigeeMin, q.perigeeMax));
+            break;
+        case 1:
+            spans.push_back(x.Span(q.apogeeMin, q.apogeeMax));
+            break;
+        case 2:
+            spans.push_back(x.Span(q.inclinationMin, q.inclinationMax));
+            break;
+        default:
+        {
+            // Intervals may run past 2π, so each range is also tried one turn up.
+            std::vector<std::pair<double, double>> ranges;
+            if (q.raanMin <= q.raanMax)
+                ranges.push_back({q.raanMin, q.raanMax});
+            else
+            {
+                ranges.push_back({q.raanMin, 2 * M_PI});
+                ranges.push_back({0, q.raanMax});
+            }
+            for (const auto &r : ranges)
+            {
+                spans.push_back(x.Span(r.first, r.second));
+                spans.push_back(x.Span(r.first + 2 * M_PI, r.second + 2 * M_PI));
+            }
+        }
+        }
+
+        std::sort(spans.begin(), spans.end());
+        std::vector<std::pair<int, int>> merged;
+        for (const auto &s : spans)
+        {
+            if (s.first >= s.second)
+                continue;
+            if (!merged.empty() && s.first <= merged.back().second)
+                merged.back().second = std::max(merged.back().second, s.second);
+            else
+                merged.push_back(s);
+        }
+        return merged;
+    }
+}
+
+/**
+ * @brief Finds catalog objects whose mean elements satisfy a compound range query.
+ * @param time Simulation time at which the elements are evaluated (s).
+ * @param query Ranges and the bitmask of active filters; with no filters every object matches.
+ * @param ids Output ids (capacity maxIds).
+ * @param maxIds Capacity of the output buffer.
+ * @return Number of matching objects (may exceed maxIds; only the first maxIds are written).
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogQuery(double time, const RegimeQuery *query, int *ids, int maxIds)
+{
+    const Catalog &catalog = GetCatalog();
+    const RegimeQuery &q = *query;
+    int count = 0;
+    if ((q.filters & 15) == 0)
+    {
+        for (int i = 0; i < catalog.Count(); ++i, ++count)
+            if (count < maxIds)
+                ids[count] = catalog.ids[i];
+        return count;
+    }
+
+    RegimeIndex &index = GetRegimeIndex();
+    Sync(index, catalog, time);
+
+    // Walk the filter with the fewest candidates and check everything exactly.
+    int best = -1;
+    size_t bestSize = SIZE_MAX;
+    std::vector<std::pair<int, int>> bestSpans;
+    for (int k = 0; k < 4; ++k)
+    {
+        if (!(q.filters & (1 << k)))
+            continue;
+        std::vector<std::pair<int, int>> spans = Spans(index.index[k], k, q);
+        size_t size = 0;
+        for (const auto &s : spans)
+            size += s.second - s.first;
+        if (size < bestSize)
+        {
+            best = k;
+            bestSize = size;
+            bestSpans = std::move(spans);
+        }
+    }
+
+    const std::vector<IntervalEntry> &entries = index.index[best].entries;
+    for (const auto &s : bestSpans)
+    {
+        for (int k = s.first; k < s.second; ++k)
+        {
+            int i = catalog.Find(entries[k].id);
+            if (i < 0 || !Matches(q, catalog.MeanElementsAt(i, time)))
+                continue;
+            if (count < maxIds)
+                ids[count] = entries[k].id;
+            ++count;
+        }
+    }
+    return count;
+}
@@ -0,0 +1,188 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "Catalog.h"
+#include "ElementHistory.h"
+#include "Frames.h"
+#include "Sgp4.h"
+#include "ThreadPool.h"
+
+/**
+ * @file CatalogUpdate.cpp
+ * @brief Applies element-set update files to the catalog in place, keyed by NORAD catalog number.
+ *
+ * An update file is a TLE file (two- or three-line form) in which a line "DECAY <number>"
+ * marks an object as decayed. Each element set is turned into a state at its own epoch with
+ * SGP4, rotated from TEME into the catalog frame. The parsing and SGP4 work runs in parallel.
+ * The catalog is then edited serially:
+ * - an element set newer than the stored epoch replaces the entry and bumps its revision, so
+ *   derived indexes re-propagate only that entry;
+ * - unknown numbers are appended;
+ * - sets no newer than the stored one are skipped;
+ * - decayed objects are removed and tombstoned, so a stale set cannot bring them back.
+ * Every parsed set is also appended to the element-set history when one is open.
+ */
+
+const double TLE_HARD_BODY_RADIUS = 5.0 / (UNIT_TO_KM * 1000.0); ///< Hard-body radius given to new objects (units).
+const double BSTAR_REFERENCE_DENSITY = 0.15696615;                ///< SGP4 reference density ρ0 (kg/m²/Earth radius).
+const double UPDATE_EPOCH_TOLERANCE = 1e-3;                       ///< Epoch difference treated as the same set (s).
+
+extern "C"
+{
+    /**
+     * @struct CatalogUpdateStats
+     * @brief Outcome of an update file; layout must match NativePhysics.CatalogUpdateStats.
+     */
+    struct CatalogUpdateStats
+    {
+        int added;      ///< New objects appended.
+        int updated;    ///< Objects given a newer element set.
+        int unchanged;  ///< Element sets no newer than the catalog's.
+        int tombstoned; ///< Objects removed as decayed.
+        int rejected;   ///< Malformed or unpropagatable element sets.
+        int reserved;
+    };
+}
+
+namespace
+{
+    /** One record of an update file, with its state once SGP4 has run. */
+    struct UpdateRecord
+    {
+        std::string line1, line2;
+        int decayId = -1; ///< Catalog number of a DECAY line, -1 for an element set.
+        ElementSet set;
+        bool parsed = false; ///< ParseTle accepted the lines; set may be partly filled otherwise.
+        double time = 0;
+        Vector3d r, v;
+        int status = 0; ///< 0 rejected, 1 state at epoch, 2 decayed at epoch.
+    };
+
+    bool ReadUpdateFile(const char *path, std::vector<UpdateRecord> &records)
+    {
+        FILE *f = std::fopen(path, "r");
+        if (!f)
+            return false;
+        char buffer[256];
+        std::string pending;
+        while (std::fgets(buffer, sizeof(buffer), f))
+        {
+            std::string line(buffer);
+            line.erase(line.find_last_not_of("\r\n") + 1);
+            if (line.rfind("DECAY", 0) == 0)
+            {
+                UpdateRecord record;
+                record.decayId = std::atoi(line.c_str() + std::strcspn(line.c_str(), "0123456789"));
+                records.push_back(record);
+            }
+            else if (line.size() > 1 && line[0] == '1' && line[1] == ' ')
+                pending = line;
+            else if (line.size() > 1 && line[0] == '2' && line[1] == ' ' && !pending.empty())
+            {
+                UpdateRecord record;
+                record.line1 = pending;
+                record.line2 = line;
+                records.push_back(record);
+                pending.clear();
+            }
+            // Anything else (names, blank lines) is ignored.
+        }
+        std::fclose(f);
+        return true;
+    }
+}
+
+/**
+ * @brief Applies an element-set update file to the catalog.
+ * @param path Path to the update file.
+ * @param stats Output counts, or null.
+ * @return 1 if the file was read, 0 otherwise.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogApplyUpdateFile(const char *path, CatalogUpdateStats *stats)
+{
+    std::vector<UpdateRecord> records;
+    if (!ReadUpdateFile(path, records))
+    {
+        LogDebug(std::string("[CatalogApplyUpdateFile] Cannot open ") + path);
+        return 0;
+    }
+
+    // Cover the element-set epochs first so the parallel TEME rotations read the frame grid.
+    double ta = 0, tb = 0;
+    bool first = true;
+    for (UpdateRecord &rec : records)
+    {
+        rec.parsed = rec.decayId < 0 && ParseTle(rec.line1.c_str(), rec.line2.c_str(), rec.set);
+        if (!rec.parsed)
+            continue;
+        rec.time = ElementSetTime(rec.set);
+        ta = first ? rec.time : std::min(ta, rec.time);
+        tb = first ? rec.time : std::max(tb, rec.time);
+        first = false;
+    }
+    if (!first)
+        EnsureFrameGrid(ta, tb);
+
+    // Every well-formed set goes into the history, whether or not it changes the catalog.
+    std::vector<ElementSet> sets;
+    for (const UpdateRecord &rec : records)
+        if (rec.parsed)
+            sets.push_back(rec.set);
+    ElementHistoryAppendSets(sets.data(), (int)sets.size());
+
+    ParallelFor((int)records.size(), [&](int k)
+    {
+        UpdateRecord &rec = records[k];
+        Sgp4State state;
+        if (!rec.parsed || !Sgp4Init(rec.set, state))
+            return;
+        bool ok = ElementSetStateAt(rec.set, state, rec.time, rec.r, rec.v);
+        rec.status = ok && (Norm(rec.r) - EARTH_RADIUS) * UNIT_TO_KM > DECAY_ALTITUDE_KM ? 1 : 2;
+    });
+
+    Catalog &catalog = GetCatalog();
+    CatalogUpdateStats s{};
+    for (const UpdateRecord &rec : records)
+    {
+        int id = rec.decayId >= 0 ? rec.decayId : rec.set.catalogNumber;
+        if (rec.decayId < 0 && rec.status == 0)
+        {
+            ++s.rejected;
+            continue;
+        }
+        auto tomb = catalog.tombstones.find(id);
+        if (rec.decayId < 0 && tomb != catalog.tombstones.end() && rec.time <= tomb->second)
+        {
+            ++s.unchanged;
+            continue;
+        }
+        int i = catalog.Find(id);
+        if (rec.decayId >= 0 || rec.status == 2)
+        {
+            if (i >= 0)
+                ++s.tombstoned;
+            // A decay notice is final; a set that decays at its own epoch only blocks older sets.
+            catalog.Tombstone(id, rec.decayId >= 0 ? INFINITY : rec.time);
+            continue;
+        }
+        if (i >= 0 && rec.time <= catalog.epoch[i] + UPDATE_EPOCH_TOLERANCE)
+        {
+            ++s.unchanged;
+            continue;
+        }
+
+        double radius = i >= 0 ? catalog.radius[i] : TLE_HARD_BODY_RADIUS;
+        ++(i >= 0 ? s.updated : s.added);
+        catalog.tombstones.erase(id);
+        i = catalog.Upsert(id, rec.r, rec.v, rec.time, radius);
+        if (rec.set.bstar > 0)
+            catalog.ballistic[i] = 2 * rec.set.bstar / BSTAR_REFERENCE_DENSITY;
+    }
+    if (stats)
+        *stats = s;
+    return 1;
+}
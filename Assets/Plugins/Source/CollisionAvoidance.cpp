@@ -0,0 +1,340 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Catalog.h"
+#include "Conjunction.h"
+#include "ThreadPool.h"
+
+/**
+ * @file CollisionAvoidance.cpp
+ * @brief Search for the cheapest impulsive maneuver that brings a conjunction's Pc under a threshold.
+ *
+ * For each candidate burn time the position/velocity block of the state transition matrix from
+ * the burn to TCA maps delta-v to the change in relative position at TCA. Along each candidate
+ * direction (the RTN axes and the steepest-descent direction of Pc) the smallest magnitude that
+ * meets the threshold is found on that linear model, then checked by propagating the maneuvered
+ * orbit and relocating TCA. Surviving candidates are re-screened against the whole catalog in
+ * order of increasing delta-v.
+ */
+
+const int AVOIDANCE_SCAN_POINTS = 32;  ///< Magnitude samples before bisection.
+const int AVOIDANCE_BISECTIONS = 30;   ///< Bisection steps on the magnitude.
+const int AVOIDANCE_CORRECTIONS = 8;   ///< Magnitude increases when the nonlinear check fails.
+const double AVOIDANCE_TCA_WINDOW = 300.0; ///< Half-width of the TCA search after a maneuver (s).
+const int AVOIDANCE_TCA_SAMPLES = 60;  ///< Range-rate samples across the TCA window.
+
+extern "C"
+{
+    /**
+     * @struct AvoidanceSettings
+     * @brief Search settings; layout must match NativePhysics.AvoidanceSettings.
+     */
+    struct AvoidanceSettings
+    {
+        double earliestBurn;    ///< First candidate burn time (s).
+        double latestBurn;      ///< Last candidate burn time (s, before TCA).
+        double pcThreshold;     ///< Acceptable probability of collision.
+        double maxDeltaV;       ///< Largest impulse considered (units/s).
+        double screenThreshold; ///< Miss distance reported by the re-screen (units).
+        double screenStep;      ///< Re-screen sampling step (s).
+        double screenEnd;       ///< End of the re-screen span (s).
+        double hardBodyRadius;  ///< Hard-body radius of the maneuvering object (units).
+        double3 sigmaRtn;       ///< Combined 1-sigma position uncertainty along R, T, N (units).
+        int numBurnTimes;       ///< Candidate burn times between earliestBurn and latestBurn.
+        int maxRescreens;       ///< Upper bound on candidates re-screened against the catalog.
+    };
+
+    /**
+     * @struct AvoidanceOption
+     * @brief One candidate maneuver; layout must match NativePhysics.AvoidanceOption.
+     */
+    struct AvoidanceOption
+    {
+        double burnTime;     ///< Impulse time (s).
+        double3 deltaV;      ///< Impulse in the inertial frame (units/s).
+        double3 deltaVRtn;   ///< Impulse along R, T, N (units/s).
+        double magnitude;    ///< |deltaV| (units/s).
+        double targetPc;     ///< Pc of the screened conjunction after the maneuver.
+        double targetMiss;   ///< Miss distance of the screened conjunction after the maneuver (units).
+        double maxOtherPc;   ///< Largest Pc among other conjunctions found by the re-screen.
+        int otherConjunctions; ///< Number of other conjunctions found by the re-screen.
+        int feasible;        ///< 1 if every Pc is below the threshold.
+    };
+}
+
+namespace
+{
+    struct Candidate
+    {
+        double burnTime;
+        Vector3d dv, dvRtn;
+        double magnitude;
+        double targetPc = 1.0, targetMiss = 0.0;
+        bool valid = false;
+    };
+
+    /** Orbit with an optional impulse at burnTime. */
+    struct ManeuveredOrbit
+    {
+        Vector3d r0, v0;
+        double epoch;
+        double burnTime;
+        Vector3d rb, vb; ///< State just after the impulse.
+        double ballistic;
+
+        bool State(double t, Vector3d &r, Vector3d &v) const
+        {
+            const Catalog &catalog = GetCatalog();
+            if (t < burnTime)
+                return catalog.Propagate(r0, v0, t - epoch, ballistic, r, v);
+            return catalog.Propagate(rb, vb, t - burnTime, ballistic, r, v);
+        }
+    };
+
+    /**
+     * @brief Closest approach to catalog entry i near an expected TCA.
+     * @return False if no range minimum was found in the window.
+     */
+    bool NearestApproach(const TrajectoryFn &trajectory, int i, double expected, double &tca, Vector3d &rp,
+                         Vector3d &vp, Vector3d &dr, Vector3d &dv)
+    {
+        const Catalog &catalog = GetCatalog();
+        double step = 2 * AVOIDANCE_TCA_WINDOW / AVOIDANCE_TCA_SAMPLES;
+        double best = INFINITY, gPrev = 0;
+        bool found = false;
+        for (int k = 0; k <= AVOIDANCE_TCA_SAMPLES; ++k)
+        {
+            double t = expected - AVOIDANCE_TCA_WINDOW + k * step;
+            Vector3d ra, va, rb, vb;
+            if (!trajectory(t, ra, va) || !catalog.StateAt(i, t, rb, vb))
+                return false;
+            double g = Dot(rb - ra, vb - va);
+            if (k > 0 && gPrev < 0 && g >= 0)
+            {
+                double t1;
+                if (RefineTca(trajectory, i, t - step, t, t1) && std::fabs(t1 - expected) < best)
+                {
+                    best = std::fabs(t1 - expected);
+                    tca = t1;
+                    found = true;
+                }
+            }
+            gPrev = g;
+        }
+        if (!found)
+            return false;
+
+        Vector3d rb, vb;
+        if (!trajectory(tca, rp, vp) || !catalog.StateAt(i, tca, rb, vb))
+            return false;
+        dr = rb - rp;
+        dv = vb - vp;
+        return true;
+    }
+}
+
+/**
+ * @brief Plans collision-avoidance maneuvers for one screened conjunction.
+ * @param position State of the maneuvering object at epoch (inertial, Z = rotation axis, sim units).
+ * @param velocity Velocity at epoch (units/s).
+ * @param epoch Simulation time of the state (s).
+ * @param selfId Catalog id of the maneuvering object (excluded from the re-screen), or -1.
+ * @param secondaryId Catalog id of the conjunction's other object.
+ * @param tca Time of closest approach of the conjunction (s).
+ * @param settings Search settings.
+ * @param options Output buffer (capacity maxOptions), feasible options first, each group by increasing delta-v.
+ * @param maxOptions Capacity of the output buffer.
+ * @return Number of options written, or -1 if the conjunction could not be located.
+ */
+extern "C" __attribute__((visibility("default"))) int PlanCollisionAvoidance(double3 position, double3 velocity, double epoch,
+                                                                             int selfId, int secondaryId, double tca,
+                                                                             const AvoidanceSettings *settings,
+                                                                             AvoidanceOption *options, int maxOptions)
+{
+    const Catalog &catalog = GetCatalog();
+    const AvoidanceSettings &s = *settings;
+    int secondary = catalog.Find(secondaryId);
+    if (secondary < 0 || maxOptions <= 0 || s.numBurnTimes <= 0 || s.latestBurn >= tca || s.earliestBurn < epoch)
+    {
+        LogDebug("[PlanCollisionAvoidance] Invalid conjunction or settings.");
+        return -1;
+    }
+
+    Vector3d sigma = ToVector3dFromDouble3(s.sigmaRtn);
+    double combinedRadius = s.hardBodyRadius + catalog.radius[secondary];
+    int self = catalog.Find(selfId);
+    ManeuveredOrbit nominal{ToVector3dFromDouble3(position), ToVector3dFromDouble3(velocity), epoch, INFINITY, {}, {},
+                            self >= 0 ? catalog.ballistic[self] : 0.0};
+    TrajectoryFn nominalFn = [&](double t, Vector3d &r, Vector3d &v)
+    { return nominal.State(t, r, v); };
+
+    double tcaNominal;
+    Vector3d rpTca, vpTca, relPos, relVel;
+    if (!NearestApproach(nominalFn, secondary, tca, tcaNominal, rpTca, vpTca, relPos, relVel))
+    {
+        LogDebug("[PlanCollisionAvoidance] Conjunction not found near the given TCA.");
+        return -1;
+    }
+
+    // Pc on the linearised encounter when the primary's TCA position moves by dp.
+    auto linearPc = [&](const Vector3d &dp)
+    { return CollisionProbability(relPos - dp, relVel, rpTca, vpTca, sigma, combinedRadius); };
+
+    const int numDirections = 7;
+    std::vector<Candidate> candidates(s.numBurnTimes * numDirections);
+    ParallelFor(s.numBurnTimes, [&](int b)
+    {
+        double tb = s.numBurnTimes == 1 ? s.earliestBurn
+                                        : s.earliestBurn + (s.latestBurn - s.earliestBurn) * b / (s.numBurnTimes - 1);
+        Vector3d rb, vb;
+        if (!nominal.State(tb, rb, vb))
+            return;
+
+        // Columns of dr(TCA)/dv(burn) by central differences.
+        const Catalog &cat = GetCatalog();
+        double eps = 1e-6 * Norm(vb);
+        Vector3d M[3];
+        bool ok = true;
+        for (int j = 0; j < 3; ++j)
+        {
+            Vector3d dv{j == 0 ? eps : 0, j == 1 ? eps : 0, j == 2 ? eps : 0};
+            Vector3d rPlus, rMinus, vTmp;
+            ok = ok && cat.Propagate(rb, vb + dv, tcaNominal - tb, nominal.ballistic, rPlus, vTmp);
+            ok = ok && cat.Propagate(rb, vb - dv, tcaNominal - tb, nominal.ballistic, rMinus, vTmp);
+            M[j] = (rPlus - rMinus) * (0.5 / eps);
+        }
+        if (!ok)
+            return;
+        auto mapDv = [&](const Vector3d &d)
+        { return M[0] * d.x + M[1] * d.y + M[2] * d.z; };
+
+        // RTN axes at the burn.
+        Vector3d rHat = rb * (1.0 / Norm(rb));
+        Vector3d nHat = Cross(rb, vb);
+        nHat = nHat * (1.0 / Norm(nHat));
+        Vector3d tHat = Cross(nHat, rHat);
+        Vector3d dirs[numDirections] = {rHat, rHat * -1.0, tHat, tHat * -1.0, nHat, nHat * -1.0, {0, 0, 0}};
+
+        // Steepest descent of log Pc with respect to delta-v.
+        double h = 1e-3 * s.maxDeltaV;
+        double g[3];
+        for (int j = 0; j < 3; ++j)
+        {
+            Vector3d d{j == 0 ? h : 0, j == 1 ? h : 0, j == 2 ? h : 0};
+            double pPlus = linearPc(mapDv(d)), pMinus = linearPc(mapDv(d * -1.0));
+            g[j] = (std::log(std::max(pPlus, 1e-300)) - std::log(std::max(pMinus, 1e-300))) / (2 * h);
+        }
+        Vector3d grad{g[0], g[1], g[2]};
+        double gradNorm = Norm(grad);
+        if (gradNorm > 0 && std::isfinite(gradNorm))
+            dirs[6] = grad * (-1.0 / gradNorm);
+
+        for (int d = 0; d < numDirections; ++d)
+        {
+            Candidate &c = candidates[b * numDirections + d];
+            c.burnTime = tb;
+            if (Norm(dirs[d]) == 0)
+                continue;
+            Vector3d dp = mapDv(dirs[d]);
+
+            // First magnitude on the scan that meets the threshold, then bisect down to it.
+            double lo = 0, hi = -1;
+            for (int k = 1; k <= AVOIDANCE_SCAN_POINTS; ++k)
+            {
+                double m = s.maxDeltaV * k / AVOIDANCE_SCAN_POINTS;
+                if (linearPc(dp * m) < s.pcThreshold)
+                {
+                    hi = m;
+                    break;
+                }
+                lo = m;
+            }
+            if (hi < 0)
+                continue;
+            for (int k = 0; k < AVOIDANCE_BISECTIONS; ++k)
+            {
+                double m = 0.5 * (lo + hi);
+                (linearPc(dp * m) < s.pcThreshold ? hi : lo) = m;
+            }
+
+            // Check on the propagated orbit and grow the impulse while the linear model is optimistic.
+            double magnitude = hi;
+            for (int k = 0; k <= AVOIDANCE_CORRECTIONS && magnitude <= s.maxDeltaV; ++k)
+            {
+                ManeuveredOrbit orbit = nominal;
+                orbit.burnTime = tb;
+                orbit.rb = rb;
+                orbit.vb = vb + dirs[d] * magnitude;
+                TrajectoryFn fn = [&](double t, Vector3d &r, Vector3d &v)
+                { return orbit.State(t, r, v); };
+
+                double t1;
+                Vector3d rp, vp, dr, dv;
+                if (!NearestApproach(fn, secondary, tcaNominal, t1, rp, vp, dr, dv))
+                    break;
+                double pc = CollisionProbability(dr, dv, rp, vp, sigma, combinedRadius);
+                if (pc < s.pcThreshold)
+                {
+                    c.dv = dirs[d] * magnitude;
+                    c.dvRtn = Vector3d{Dot(c.dv, rHat), Dot(c.dv, tHat), Dot(c.dv, nHat)};
+                    c.magnitude = magnitude;
+                    c.targetPc = pc;
+                    c.targetMiss = Norm(dr);
+                    c.valid = true;
+                    break;
+                }
+                magnitude *= 1.25;
+            }
+        }
+    });
+
+    std::vector<Candidate> ranked;
+    for (const Candidate &c : candidates)
+        if (c.valid)
+            ranked.push_back(c);
+    std::sort(ranked.begin(), ranked.end(), [](const Candidate &a, const Candidate &b)
+              { return a.magnitude < b.magnitude; });
+
+    // Re-screen the cheapest candidates against the catalog until enough feasible ones are found.
+    std::vector<AvoidanceOption> feasible, infeasible;
+    int rescreens = std::min((int)ranked.size(), s.maxRescreens > 0 ? s.maxRescreens : (int)ranked.size());
+    for (int k = 0; k < rescreens && (int)feasible.size() < maxOptions; ++k)
+    {
+        const Candidate &c = ranked[k];
+        Vector3d rb, vb;
+        nominal.State(c.burnTime, rb, vb);
+        ManeuveredOrbit orbit = nominal;
+        orbit.burnTime = c.burnTime;
+        orbit.rb = rb;
+        orbit.vb = vb + c.dv;
+        TrajectoryFn fn = [&](double t, Vector3d &r, Vector3d &v)
+        { return orbit.State(t, r, v); };
+
+        std::vector<ConjunctionEvent> events;
+        ScreenAgainstCatalog(fn, self, c.burnTime, std::max(s.screenEnd, tca + AVOIDANCE_TCA_WINDOW), s.screenStep,
+                             s.screenThreshold, sigma, s.hardBodyRadius, events);
+
+        AvoidanceOption o{};
+        o.burnTime = c.burnTime;
+        o.deltaV = ToDouble3(c.dv);
+        o.deltaVRtn = ToDouble3(c.dvRtn);
+        o.magnitude = c.magnitude;
+        o.targetPc = c.targetPc;
+        o.targetMiss = c.targetMiss;
+        for (const ConjunctionEvent &e : events)
+        {
+            if (e.objectId == secondaryId && std::fabs(e.tca - tcaNominal) < AVOIDANCE_TCA_WINDOW)
+                continue;
+            o.maxOtherPc = std::max(o.maxOtherPc, e.pc);
+            o.otherConjunctions++;
+        }
+        o.feasible = o.maxOtherPc < s.pcThreshold ? 1 : 0;
+        (o.feasible ? feasible : infeasible).push_back(o);
+    }
+
+    feasible.insert(feasible.end(), infeasible.begin(), infeasible.end());
+    int n = std::min((int)feasible.size(), maxOptions);
+    std::copy(feasible.begin(), feasible.begin() + n, options);
+    return n;
+}
@@ -0,0 +1,590 @@
+#include <cmath>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+#include "PhysicsCommon.h"
+#include "Kepler.h"
+#include "LinearAlgebra.h"
+#include "ThreadPool.h"
+
+/**
+ * @file Collocation.cpp
+ * @brief Low-thrust transfer optimisation by Hermite-Simpson direct collocation.
+ *
+ * The transfer is split into N segments. Each node carries the state x_k (r, v) and the
+ * thrust acceleration u_k, and each segment a midpoint control uc_k. The compressed
+ * Hermite-Simpson defect
+ *
+ *   x_c = (x_k + x_k+1) / 2 + h / 8 (f_k - f_k+1)
+ *   D_k = x_k+1 - x_k - h / 6 (f_k + 4 f(x_c, uc_k) + f_k+1)
+ *
+ * must vanish, together with the fixed initial and final states. The objective is the
+ * minimum-energy cost ½∫|u|² dt (Simpson quadrature). The resulting NLP is solved with an
+ * SQP method whose Jacobian is analytic; ordering variables and multipliers by node keeps
+ * the KKT matrix banded, so each iteration is a banded LU. The Hessian of the Lagrangian is
+ * built per segment by differencing the analytic Jacobian, and an adaptive diagonal shift
+ * keeps the steps descent directions for the L1 merit function far from the solution.
+ * Defects, Jacobian blocks and Hessian blocks are evaluated in parallel across segments.
+ *
+ * Everything is solved in canonical units (initial radius, mu = 1) and converted back.
+ */
+
+const int COLLOCATION_NODE_VARS = 12;        ///< x_k (6), u_k (3), uc_k (3).
+const double COLLOCATION_ARMIJO = 1e-4;      ///< Sufficient-decrease factor for the merit line search.
+const int COLLOCATION_SEGMENT_VARS = 21;      ///< Variables a defect depends on: node k block + x, u of node k + 1.
+const double COLLOCATION_MAX_STEP = 0.5;     ///< Largest accepted change of any variable per iteration (canonical units).
+const int COLLOCATION_MERIT_MEMORY = 8;       ///< Iterates remembered by the non-monotone line search.
+const double COLLOCATION_MIN_DAMPING = 1e-4;  ///< Hessian shift applied after a rejected step.
+const double COLLOCATION_MAX_DAMPING = 1e6;   ///< Ceiling of the adaptive Hessian shift.
+
+extern "C"
+{
+    /**
+     * @struct CollocationResult
+     * @brief Summary of a collocation solve. Layout must match NativePhysics.CollocationResult.
+     */
+    struct CollocationResult
+    {
+        double cost;           ///< ½∫|u|² dt in sim units (units² / s³).
+        double maxDefect;      ///< Largest constraint violation (canonical units).
+        double maxThrustAccel; ///< Largest thrust acceleration at any node or midpoint (units / s²).
+        int iterations;        ///< SQP iterations performed.
+        int converged;         ///< Non-zero if the KKT conditions were met.
+    };
+}
+
+namespace
+{
+    /** Two-body dynamics with thrust acceleration (mu = 1). */
+    void Dynamics(const double *x, const double *u, double *f)
+    {
+        double r2 = x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+        double r3 = r2 * std::sqrt(r2);
+        for (int i = 0; i < 3; ++i)
+        {
+            f[i] = x[3 + i];
+            f[3 + i] = -x[i] / r3 + u[i];
+        }
+    }
+
+    /** ∂f/∂x (6 x 6, row-major); ∂f/∂u is [0; I]. */
+    void DynamicsJacobian(const double *x, double *A)
+    {
+        std::fill(A, A + 36, 0.0);
+        double r2 = x[0] * x[0] + x[1] * x[1] + x[2] * x[2];
+        double r = std::sqrt(r2);
+        double r3 = r2 * r, r5 = r3 * r2;
+        for (int i = 0; i < 3; ++i)
+        {
+            A[i * 6 + 3 + i] = 1.0;
+            for (int j = 0; j < 3; ++j)
+                A[(3 + i) * 6 + j] = 3.0 * x[i] * x[j] / r5 - (i == j ? 1.0 / r3 : 0.0);
+        }
+    }
+
+    /** Defect and its Jacobian blocks for one segment. */
+    struct SegmentLinearization
+    {
+        double defect[6];
+        double dxk[36], duk[18], duc[18], dxn[36], dun[18];
+        double uc2; ///< |uc|², for the thrust report.
+    };
+
+    void LinearizeSegment(const double *xk, const double *uk, const double *uc, const double *xn, const double *un,
+                          double h, SegmentLinearization &s)
+    {
+        double fk[6], fn[6], fc[6], xc[6];
+        Dynamics(xk, uk, fk);
+        Dynamics(xn, un, fn);
+        for (int i = 0; i < 6; ++i)
+            xc[i] = 0.5 * (xk[i] + xn[i]) + h / 8.0 * (fk[i] - fn[i]);
+        Dynamics(xc, uc, fc);
+
+        for (int i = 0; i < 6; ++i)
+            s.defect[i] = xn[i] - xk[i] - h / 6.0 * (fk[i] + 4.0 * fc[i] + fn[i]);
+        s.uc2 = uc[0] * uc[0] + uc[1] * uc[1] + uc[2] * uc[2];
+
+        double Ak[36], An[36], Ac[36];
+        DynamicsJacobian(xk, Ak);
+        DynamicsJacobian(xn, An);
+        DynamicsJacobian(xc, Ac);
+
+        // ∂x_c/∂x_k = I/2 + h/8 A_k, ∂x_c/∂x_n = I/2 - h/8 A_n, ∂x_c/∂u_k = h/8 B, ∂x_c/∂u_n = -h/8 B.
+        double Xk[36], Xn[36], AcXk[36], AcXn[36];
+        for (int i = 0; i < 36; ++i)
+        {
+            double id = (i % 7 == 0) ? 0.5 : 0.0;
+            Xk[i] = id + h / 8.0 * Ak[i];
+            Xn[i] = id - h / 8.0 * An[i];
+        }
+        MatMul(Ac, Xk, AcXk, 6, 6, 6);
+        MatMul(Ac, Xn, AcXn, 6, 6, 6);
+
+        for (int i = 0; i < 6; ++i)
+        {
+            for (int j = 0; j < 6; ++j)
+            {
+                double id = (i == j) ? 1.0 : 0.0;
+                s.dxk[i * 6 + j] = -id - h / 6.0 * (Ak[i * 6 + j] + 4.0 * AcXk[i * 6 + j]);
+                s.dxn[i * 6 + j] = id - h / 6.0 * (An[i * 6 + j] + 4.0 * AcXn[i * 6 + j]);
+            }
+            for (int j = 0; j < 3; ++j)
+            {
+                // A_c B picks column 3 + j of A_c.
+                double b = (i == 3 + j) ? 1.0 : 0.0;
+                double acb = Ac[i * 6 + 3 + j];
+                s.duk[i * 3 + j] = -h / 6.0 * (b + 4.0 * (h / 8.0) * acb);
+                s.dun[i * 3 + j] = -h / 6.0 * (b - 4.0 * (h / 8.0) * acb);
+                s.duc[i * 3 + j] = -h / 6.0 * 4.0 * b;
+            }
+        }
+    }
+
+    /**
+     * @brief Hessian of λᵀD_k with respect to the segment variables (21 x 21), by central
+     * differences of the analytic Jacobian.
+     * @param v Segment variables: x_k, u_k, uc_k, x_k+1, u_k+1 (contiguous in the NLP vector).
+     */
+    void SegmentHessian(const double *v, const double *lambda, double h, double *H)
+    {
+        auto gradient = [&](const double *w, double *g)
+        {
+            SegmentLinearization s;
+            LinearizeSegment(w, w + 6, w + 9, w + 12, w + 18, h, s);
+            for (int j = 0; j < COLLOCATION_SEGMENT_VARS; ++j)
+            {
+                double sum = 0.0;
+                for (int i = 0; i < 6; ++i)
+                {
+                    double d = j < 6 ? s.dxk[i * 6 + j] : j < 9 ? s.duk[i * 3 + j - 6]
+                                                   : j < 12  ? s.duc[i * 3 + j - 9]
+                                                   : j < 18  ? s.dxn[i * 6 + j - 12]
+                                                             : s.dun[i * 3 + j - 18];
+                    sum += lambda[i] * d;
+                }
+                g[j] = sum;
+            }
+        };
+
+        double w[COLLOCATION_SEGMENT_VARS], gp[COLLOCATION_SEGMENT_VARS], gm[COLLOCATION_SEGMENT_VARS];
+        std::copy(v, v + COLLOCATION_SEGMENT_VARS, w);
+        for (int j = 0; j < COLLOCATION_SEGMENT_VARS; ++j)
+        {
+            double eps = 1e-6 * std::max(1.0, std::fabs(v[j]));
+            w[j] = v[j] + eps;
+            gradient(w, gp);
+            w[j] = v[j] - eps;
+            gradient(w, gm);
+            w[j] = v[j];
+            for (int i = 0; i < COLLOCATION_SEGMENT_VARS; ++i)
+                H[i * COLLOCATION_SEGMENT_VARS + j] = (gp[i] - gm[i]) / (2.0 * eps);
+        }
+        for (int i = 0; i < COLLOCATION_SEGMENT_VARS; ++i)
+            for (int j = 0; j < i; ++j)
+            {
+                double a = 0.5 * (H[i * COLLOCATION_SEGMENT_VARS + j] + H[j * COLLOCATION_SEGMENT_VARS + i]);
+                H[i * COLLOCATION_SEGMENT_VARS + j] = a;
+                H[j * COLLOCATION_SEGMENT_VARS + i] = a;
+            }
+    }
+
+    /** Collocation NLP over N segments with fixed boundary states. */
+    struct CollocationProblem
+    {
+        int N;
+        double h;
+        double xInit[6], xFinal[6];
+
+        int NumVars() const { return COLLOCATION_NODE_VARS * N + 9; }
+        int NumConstraints() const { return 6 * N + 12; }
+
+        const double *X(const double *z, int k) const { return z + COLLOCATION_NODE_VARS * k; }
+        const double *U(const double *z, int k) const { return z + COLLOCATION_NODE_VARS * k + 6; }
+        const double *Uc(const double *z, int k) const { return z + COLLOCATION_NODE_VARS * k + 9; }
+
+        /** KKT position of variable z[i]: each node block is followed by its defect multipliers. */
+        int VarSlot(int i) const
+        {
+            if (i >= COLLOCATION_NODE_VARS * N)
+                return 6 + 18 * N + (i - COLLOCATION_NODE_VARS * N);
+            return 6 + 18 * (i / COLLOCATION_NODE_VARS) + i % COLLOCATION_NODE_VARS;
+        }
+
+        /** KKT position of constraint c[i]: [x_0 - x_init, D_0 .. D_N-1, x_N - x_final]. */
+        int ConSlot(int i) const
+        {
+            if (i < 6)
+                return i;
+            if (i < 6 + 6 * N)
+                return 6 + 18 * ((i - 6) / 6) + 12 + (i - 6) % 6;
+            return 6 + 18 * N + 9 + (i - 6 - 6 * N);
+        }
+
+        /** Quadrature weight of each control variable in ½ Σ w |u|². */
+        double ControlWeight(int i) const
+        {
+            if (i >= COLLOCATION_NODE_VARS * N)
+                return (i - COLLOCATION_NODE_VARS * N) >= 6 ? h / 6.0 : 0.0;
+            int local = i % COLLOCATION_NODE_VARS;
+            if (local < 6)
+                return 0.0;
+            if (local >= 9)
+                return 4.0 * h / 6.0;
+            return (i / COLLOCATION_NODE_VARS == 0) ? h / 6.0 : 2.0 * h / 6.0;
+        }
+
+        double Cost(const double *z) const
+        {
+            double J = 0.0;
+            for (int i = 0; i < NumVars(); ++i)
+                J += 0.5 * ControlWeight(i) * z[i] * z[i];
+            return J;
+        }
+
+        /** Constraint values, and the segment linearisations when lin is non-null. */
+        void Evaluate(const double *z, double *c, std::vector<SegmentLinearization> *lin) const
+        {
+            std::vector<SegmentLinearization> local;
+            std::vector<SegmentLinearization> &segs = lin ? *lin : local;
+            segs.resize(N);
+
+            ParallelFor(N, [&](int k)
+                        { LinearizeSegment(X(z, k), U(z, k), Uc(z, k), X(z, k + 1), U(z, k + 1), h, segs[k]); });
+
+            for (int i = 0; i < 6; ++i)
+            {
+                c[i] = X(z, 0)[i] - xInit[i];
+                c[6 + 6 * N + i] = X(z, N)[i] - xFinal[i];
+            }
+            for (int k = 0; k < N; ++k)
+                for (int i = 0; i < 6; ++i)
+                    c[6 + 6 * k + i] = segs[k].defect[i];
+        }
+    };
+
+    double L1(const std::vector<double> &c)
+    {
+        double s = 0.0;
+        for (double v : c)
+            s += std::fabs(v);
+        return s;
+    }
+
+    double LInf(const std::vector<double> &c)
+    {
+        double s = 0.0;
+        for (double v : c)
+            s = std::max(s, std::fabs(v));
+        return s;
+    }
+
+    /** Cylindrical coordinates (rho, theta, z) and velocity (radial, tangential, z) in a fixed frame. */
+    struct PolarState
+    {
+        double rho, theta, z, vr, vt, vz;
+    };
+
+    PolarState ToPolar(const Vector3d &r, const Vector3d &v, const Vector3d &e1, const Vector3d &e2, const Vector3d &e3)
+    {
+        double x = Dot(r, e1), y = Dot(r, e2);
+        double vx = Dot(v, e1), vy = Dot(v, e2);
+        double rho = std::sqrt(x * x + y * y);
+        return {rho, std::atan2(y, x), Dot(r, e3), (x * vx + y * vy) / rho, (x * vy - y * vx) / rho, Dot(v, e3)};
+    }
+
+    /**
+     * @brief Initial guess: blend of the forward coast from the initial state and the backward
+     * coast from the final state, with zero thrust. The blend is done in cylindrical
+     * coordinates about the initial orbit normal with unwrapped angles, so multi-revolution
+     * guesses keep a sensible radius instead of cutting across the central body.
+     */
+    void InitialGuess(const CollocationProblem &p, double tof, double *z)
+    {
+        Vector3d r0{p.xInit[0], p.xInit[1], p.xInit[2]}, v0{p.xInit[3], p.xInit[4], p.xInit[5]};
+        Vector3d rf{p.xFinal[0], p.xFinal[1], p.xFinal[2]}, vf{p.xFinal[3], p.xFinal[4], p.xFinal[5]};
+        Vector3d hv = Cross(r0, v0);
+        Vector3d e3 = (1.0 / Norm(hv)) * hv;
+        Vector3d e1 = (1.0 / Norm(r0)) * r0;
+        Vector3d e2 = Cross(e3, e1);
+
+        std::vector<PolarState> a(p.N + 1), b(p.N + 1);
+        for (int k = 0; k <= p.N; ++k)
+        {
+            Vector3d r, v;
+            KeplerPropagate(r0, v0, 1.0, p.h * k, r, v);
+            a[k] = ToPolar(r, v, e1, e2, e3);
+            if (k > 0)
+                a[k].theta = a[k - 1].theta + std::remainder(a[k].theta - a[k - 1].theta, 2.0 * M_PI);
+        }
+        for (int k = p.N; k >= 0; --k)
+        {
+            Vector3d r, v;
+            KeplerPropagate(rf, vf, 1.0, p.h * k - tof, r, v);
+            b[k] = ToPolar(r, v, e1, e2, e3);
+            if (k < p.N)
+                b[k].theta = b[k + 1].theta + std::remainder(b[k].theta - b[k + 1].theta, 2.0 * M_PI);
+        }
+        double shift = 2.0 * M_PI * std::round((a[0].theta - b[0].theta) / (2.0 * M_PI));
+
+        std::fill(z, z + p.NumVars(), 0.0);
+        for (int k = 0; k <= p.N; ++k)
+        {
+            double s = (double)k / p.N;
+            auto mix = [s](double x, double y)
+            { return (1.0 - s) * x + s * y; };
+            double rho = mix(a[k].rho, b[k].rho), theta = mix(a[k].theta, b[k].theta + shift);
+            double vr = mix(a[k].vr, b[k].vr), vt = mix(a[k].vt, b[k].vt);
+            Vector3d radial = std::cos(theta) * e1 + std::sin(theta) * e2;
+            Vector3d along = Cross(e3, radial);
+            Vector3d r = rho * radial + mix(a[k].z, b[k].z) * e3;
+            Vector3d v = vr * radial + vt * along + mix(a[k].vz, b[k].vz) * e3;
+
+            double *x = z + COLLOCATION_NODE_VARS * k;
+            x[0] = r.x, x[1] = r.y, x[2] = r.z;
+            x[3] = v.x, x[4] = v.y, x[5] = v.z;
+        }
+    }
+}
+
+/**
+ * @brief Optimises a minimum-energy low-thrust transfer between two fixed states.
+ *
+ * @param mu Gravitational parameter of the central body (sim units).
+ * @param r0 Initial position relative to the central body.
+ * @param v0 Initial velocity.
+ * @param rf Target position at arrival.
+ * @param vf Target velocity at arrival.
+ * @param timeOfFlight Transfer duration in seconds (multi-revolution transfers are fine).
+ * @param numSegments Number of collocation segments (e.g. 20-40 per revolution).
+ * @param maxIterations SQP iteration limit.
+ * @param tolerance Feasibility / optimality tolerance (canonical units, e.g. 1e-8).
+ * @param nodePositions Output positions at the numSegments + 1 nodes (may be null).
+ * @param nodeControls Output thrust acceleration at the nodes (units/s², may be null).
+ * @param result Output solve summary.
+ * @return 1 if converged, 0 otherwise.
+ */
+extern "C" __attribute__((visibility("default"))) int CollocationOptimize(
+    double mu,
+    double3 r0,
+    double3 v0,
+    double3 rf,
+    double3 vf,
+    double timeOfFlight,
+    int numSegments,
+    int maxIterations,
+    double tolerance,
+    double3 *nodePositions,
+    double3 *nodeControls,
+    CollocationResult *result)
+{
+    *result = {};
+    if (numSegments < 1 || timeOfFlight <= 0.0 || mu <= 0.0)
+        return 0;
+
+    double DU = Norm(ToVector3dFromDouble3(r0));
+    double TU = std::sqrt(DU * DU * DU / mu);
+    double VU = DU / TU, AU = DU / (TU * TU);
+
+    CollocationProblem p;
+    p.N = numSegments;
+    double tof = timeOfFlight / TU;
+    p.h = tof / numSegments;
+    double init[6] = {r0.x / DU, r0.y / DU, r0.z / DU, v0.x / VU, v0.y / VU, v0.z / VU};
+    double fin[6] = {rf.x / DU, rf.y / DU, rf.z / DU, vf.x / VU, vf.y / VU, vf.z / VU};
+    std::copy(init, init + 6, p.xInit);
+    std::copy(fin, fin + 6, p.xFinal);
+
+    int n = p.NumVars(), m = p.NumConstraints();
+    std::vector<double> z(n), c(m), trial(n), cTrial(m);
+    std::vector<SegmentLinearization> lin;
+    InitialGuess(p, tof, z.data());
+
+    // Half-bandwidth of the KKT matrix: a defect (and its Hessian block) couples node k to node k + 1.
+    int band = p.VarSlot(COLLOCATION_SEGMENT_VARS - 1) - p.VarSlot(0);
+    for (int i = 0; i < 6; ++i)
+    {
+        int row = p.ConSlot(6 + i);
+        band = std::max(band, std::abs(row - p.VarSlot(0)));
+        band = std::max(band, std::abs(row - p.VarSlot(COLLOCATION_SEGMENT_VARS - 1)));
+    }
+    band = std::max(band, p.ConSlot(5) - p.VarSlot(0));
+    band = std::max(band, p.ConSlot(m - 1) - p.VarSlot(COLLOCATION_NODE_VARS * p.N));
+
+    double rho = 1.0;
+    double damping = 0.0;
+    std::vector<std::pair<double, double>> history; // (cost, |c|_1) of recent iterates for the non-monotone test
+    std::vector<double> lambda(m, 0.0), hessians((size_t)p.N * COLLOCATION_SEGMENT_VARS * COLLOCATION_SEGMENT_VARS);
+    int iter = 0;
+    bool converged = false;
+    p.Evaluate(z.data(), c.data(), &lin);
+
+    for (; iter < maxIterations; ++iter)
+    {
+        int size = n + m;
+        BandedMatrix K(size, band, band);
+        std::vector<double> rhs(size, 0.0);
+
+        for (int i = 0; i < n; ++i)
+        {
+            double w = p.ControlWeight(i);
+            int s = p.VarSlot(i);
+            K.At(s, s) = w + damping;
+            rhs[s] = -w * z[i];
+        }
+
+        ParallelFor(p.N, [&](int k)
+                    { SegmentHessian(&z[COLLOCATION_NODE_VARS * k], &lambda[6 + 6 * k], p.h,
+                                     &hessians[(size_t)k * COLLOCATION_SEGMENT_VARS * COLLOCATION_SEGMENT_VARS]); });
+        for (int k = 0; k < p.N; ++k)
+        {
+            const double *Hk = &hessians[(size_t)k * COLLOCATION_SEGMENT_VARS * COLLOCATION_SEGMENT_VARS];
+            int base = COLLOCATION_NODE_VARS * k;
+            for (int i = 0; i < COLLOCATION_SEGMENT_VARS; ++i)
+                for (int j = 0; j < COLLOCATION_SEGMENT_VARS; ++j)
+                    K.At(p.VarSlot(base + i), p.VarSlot(base + j)) += Hk[i * COLLOCATION_SEGMENT_VARS + j];
+        }
+
+        auto addJ = [&](int con, int var, double v)
+        {
+            int a = p.ConSlot(con), b = p.VarSlot(var);
+            K.At(a, b) += v;
+            K.At(b, a) += v;
+        };
+        for (int i = 0; i < 6; ++i)
+        {
+            addJ(i, i, 1.0);
+            addJ(6 + 6 * p.N + i, COLLOCATION_NODE_VARS * p.N + i, 1.0);
+        }
+        for (int k = 0; k < p.N; ++k)
+        {
+            const SegmentLinearization &s = lin[k];
+            int xk = COLLOCATION_NODE_VARS * k, xn = COLLOCATION_NODE_VARS * (k + 1);
+            for (int i = 0; i < 6; ++i)
+            {
+                int con = 6 + 6 * k + i;
+                for (int j = 0; j < 6; ++j)
+                {
+                    addJ(con, xk + j, s.dxk[i * 6 + j]);
+                    addJ(con, xn + j, s.dxn[i * 6 + j]);
+                }
+                for (int j = 0; j < 3; ++j)
+                {
+                    addJ(con, xk + 6 + j, s.duk[i * 3 + j]);
+                    addJ(con, xk + 9 + j, s.duc[i * 3 + j]);
+                    addJ(con, xn + 6 + j, s.dun[i * 3 + j]);
+                }
+            }
+        }
+        for (int i = 0; i < m; ++i)
+            rhs[p.ConSlot(i)] = -c[i];
+
+        BandedMatrix Kcorrection = K;
+        if (!SolveBandedSystem(K, rhs.data()))
+            break;
+
+        double stepNorm = 0.0, lambdaMax = 0.0, gradDotStep = 0.0;
+        std::vector<double> d(n);
+        for (int i = 0; i < n; ++i)
+        {
+            d[i] = rhs[p.VarSlot(i)];
+            stepNorm = std::max(stepNorm, std::fabs(d[i]));
+            gradDotStep += p.ControlWeight(i) * z[i] * d[i];
+        }
+        for (int i = 0; i < m; ++i)
+            lambdaMax = std::max(lambdaMax, std::fabs(rhs[p.ConSlot(i)]));
+
+        double feasibility = LInf(c);
+        if (feasibility < tolerance && stepNorm < tolerance)
+        {
+            converged = true;
+            break;
+        }
+
+        // Backtracking line search on the L1 merit function f + rho |c|_1.
+        rho = std::max(rho, 1.1 * lambdaMax);
+        double slope = gradDotStep - rho * L1(c);
+        if (slope >= 0.0 || stepNorm > COLLOCATION_MAX_STEP)
+        {
+            // Not a descent direction (indefinite Hessian) or an implausibly long step: shift the
+            // Hessian and solve again, which also acts as a trust region.
+            damping = std::min(COLLOCATION_MAX_DAMPING, std::max(COLLOCATION_MIN_DAMPING, damping * 10.0));
+            continue;
+        }
+
+        // Non-monotone reference: the worst merit over the last few iterates, so that steps
+        // following a curved feasible valley are not rejected for a transient rise in |c|.
+        history.push_back({p.Cost(z.data()), L1(c)});
+        if ((int)history.size() > COLLOCATION_MERIT_MEMORY)
+            history.erase(history.begin());
+        double merit = 0.0;
+        for (const auto &hm : history)
+            merit = std::max(merit, hm.first + rho * hm.second);
+
+        auto accept = [&](double alpha)
+        {
+            p.Evaluate(trial.data(), cTrial.data(), nullptr);
+            double trialMerit = p.Cost(trial.data()) + rho * L1(cTrial);
+            return std::isfinite(trialMerit) && trialMerit <= merit + COLLOCATION_ARMIJO * alpha * slope;
+        };
+
+        double alpha = 1.0;
+        for (int i = 0; i < n; ++i)
+            trial[i] = z[i] + d[i];
+        bool accepted = accept(1.0);
+        if (!accepted)
+        {
+            // Second-order correction: re-project the full step onto the linearised constraints
+            // before cutting it, which avoids the Maratos effect close to the solution.
+            std::vector<double> soc(size, 0.0);
+            for (int i = 0; i < m; ++i)
+                soc[p.ConSlot(i)] = -cTrial[i];
+            if (SolveBandedSystem(Kcorrection, soc.data()))
+            {
+                for (int i = 0; i < n; ++i)
+                    trial[i] = z[i] + d[i] + soc[p.VarSlot(i)];
+                accepted = accept(1.0);
+            }
+        }
+        for (int ls = 1; ls < 30 && !accepted; ++ls)
+        {
+            alpha *= 0.5;
+            for (int i = 0; i < n; ++i)
+                trial[i] = z[i] + alpha * d[i];
+            accepted = accept(alpha);
+        }
+        if (!accepted)
+        {
+            // No step along this direction passes the Armijo test: keep the iterate and shift the
+            // Hessian, as for a non-descent direction.
+            damping = std::min(COLLOCATION_MAX_DAMPING, std::max(COLLOCATION_MIN_DAMPING, damping * 10.0));
+            continue;
+        }
+        damping = alpha < 1.0 ? std::min(COLLOCATION_MAX_DAMPING, std::max(COLLOCATION_MIN_DAMPING, damping * 8.0))
+                              : (damping > 1e-10 ? damping / 3.0 : 0.0);
+        for (int i = 0; i < m; ++i)
+            lambda[i] += alpha * (rhs[p.ConSlot(i)] - lambda[i]);
+        z.swap(trial);
+        p.Evaluate(z.data(), c.data(), &lin);
+    }
+
+    double maxU2 = 0.0;
+    for (int k = 0; k <= p.N; ++k)
+    {
+        const double *u = p.U(z.data(), k);
+        maxU2 = std::max(maxU2, u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+        if (k < p.N)
+            maxU2 = std::max(maxU2, lin[k].uc2);
+        if (nodePositions)
+            nodePositions[k] = {p.X(z.data(), k)[0] * DU, p.X(z.data(), k)[1] * DU, p.X(z.data(), k)[2] * DU};
+        if (nodeControls)
+            nodeControls[k] = {u[0] * AU, u[1] * AU, u[2] * AU};
+    }
+
+    result->cost = p.Cost(z.data()) * AU * AU * TU;
+    result->maxDefect = LInf(c);
+    result->maxThrustAccel = std::sqrt(maxU2) * AU;
+    result->iterations = iter;
+    result->converged = converged ? 1 : 0;
+    return converged ? 1 : 0;
+}
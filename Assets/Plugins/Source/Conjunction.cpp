@@ -0,0 +1,251 @@
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+
+#include "Catalog.h"
+#include "Conjunction.h"
+#include "EventDetection.h"
+#include "ThreadPool.h"
+
+const double TCA_TOLERANCE = 1e-3; ///< TCA time tolerance (s).
+const int PC_INTERVALS = 64;       ///< Simpson intervals across the hard-body disk.
+
+/**
+ * @brief Perigee and apogee radius of a two-body state (apogee is infinite when unbound).
+ */
+static void ApsisRadii(const Vector3d &r, const Vector3d &v, double mu, double &rp, double &ra)
+{
+    Vector3d h = Cross(r, v);
+    double h2 = Dot(h, h);
+    double energy = 0.5 * Dot(v, v) - mu / Norm(r);
+    double e = std::sqrt(std::max(0.0, 1.0 + 2.0 * energy * h2 / (mu * mu)));
+    rp = h2 / mu / (1.0 + e);
+    ra = e < 1.0 ? h2 / mu / (1.0 - e) : INFINITY;
+}
+
+static double NormalCdf(double x)
+{
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+double CollisionProbability(const Vector3d &relPos, const Vector3d &relVel, const Vector3d &primaryPos,
+                            const Vector3d &primaryVel, const Vector3d &sigmaRtn, double hardBodyRadius)
+{
+    double speed = Norm(relVel);
+    if (speed < 1e-12 || hardBodyRadius <= 0)
+        return 0.0;
+
+    // RTN frame of the primary.
+    Vector3d rHat = primaryPos * (1.0 / Norm(primaryPos));
+    Vector3d nHat = Cross(primaryPos, primaryVel);
+    nHat = nHat * (1.0 / Norm(nHat));
+    Vector3d tHat = Cross(nHat, rHat);
+
+    // Encounter plane: x along the miss vector, y completing the frame with the relative velocity.
+    Vector3d u = relVel * (1.0 / speed);
+    Vector3d miss = relPos - u * Dot(relPos, u);
+    double missDistance = Norm(miss);
+    Vector3d xHat = missDistance > 1e-12 ? miss * (1.0 / missDistance) : Cross(u, std::fabs(u.x) < 0.9 ? Vector3d{1, 0, 0} : Vector3d{0, 1, 0});
+    xHat = xHat * (1.0 / Norm(xHat));
+    Vector3d yHat = Cross(u, xHat);
+
+    // Project the diagonal RTN covariance onto the plane.
+    double var[3] = {sigmaRtn.x * sigmaRtn.x, sigmaRtn.y * sigmaRtn.y, sigmaRtn.z * sigmaRtn.z};
+    double px[3] = {Dot(xHat, rHat), Dot(xHat, tHat), Dot(xHat, nHat)};
+    double py[3] = {Dot(yHat, rHat), Dot(yHat, tHat), Dot(yHat, nHat)};
+    double cxx = 0, cxy = 0, cyy = 0;
+    for (int k = 0; k < 3; ++k)
+    {
+        cxx += px[k] * px[k] * var[k];
+        cxy += px[k] * py[k] * var[k];
+        cyy += py[k] * py[k] * var[k];
+    }
+
+    // Principal axes of the 2x2 covariance; the disk is rotationally symmetric so only the mean rotates.
+    double theta = 0.5 * std::atan2(2 * cxy, cxx - cyy);
+    double c = std::cos(theta), s = std::sin(theta);
+    double s1 = std::sqrt(std::max(cxx * c * c + 2 * cxy * c * s + cyy * s * s, 1e-30));
+    double s2 = std::sqrt(std::max(cxx * s * s - 2 * cxy * c * s + cyy * c * c, 1e-30));
+    double m1 = missDistance * c, m2 = -missDistance * s;
+
+    // Integrate over x in closed form in y (Simpson across the disk).
+    double R = hardBodyRadius;
+    double h = 2 * R / PC_INTERVALS;
+    double sum = 0;
+    for (int k = 0; k <= PC_INTERVALS; ++k)
+    {
+        double x = -R + k * h;
+        double half = std::sqrt(std::max(0.0, R * R - x * x));
+        double gx = std::exp(-0.5 * (x - m1) * (x - m1) / (s1 * s1)) / (std::sqrt(2 * M_PI) * s1);
+        double fy = NormalCdf((half - m2) / s2) - NormalCdf((-half - m2) / s2);
+        double w = (k == 0 || k == PC_INTERVALS) ? 1 : (k % 2 ? 4 : 2);
+        sum += w * gx * fy;
+    }
+    return std::min(1.0, sum * h / 3.0);
+}
+
+/**
+ * @brief Relative state (catalog entry minus trajectory) at time t.
+ */
+static bool RelativeState(const TrajectoryFn &primary, int i, double t, Vector3d &ra, Vector3d &va,
+                          Vector3d &dr, Vector3d &dv)
+{
+    Vector3d rb, vb;
+    if (!primary(t, ra, va) || !GetCatalog().StateAt(i, t, rb, vb))
+        return false;
+    dr = rb - ra;
+    dv = vb - va;
+    return true;
+}
+
+bool RefineTca(const TrajectoryFn &primary, int i, double ta, double tb, double &tca)
+{
+    Vector3d ra, va, dr, dv;
+    if (!RelativeState(primary, i, ta, ra, va, dr, dv))
+        return false;
+    double ga = Dot(dr, dv);
+    if (!RelativeState(primary, i, tb, ra, va, dr, dv))
+        return false;
+    double gb = Dot(dr, dv);
+    if (ga >= 0 || gb <= 0)
+    {
+        tca = ga >= 0 ? ta : tb;
+        return true;
+    }
+
+    bool ok = true;
+    auto rangeRate = [&](double t)
+    {
+        Vector3d r, v, d, w;
+        if (!RelativeState(primary, i, t, r, v, d, w))
+        {
+            ok = false;
+            return 0.0;
+        }
+        return Dot(d, w);
+    };
+    tca = LocateEvent(rangeRate, ta, tb, ga, gb, TCA_TOLERANCE);
+    return ok;
+}
+
+void ScreenAgainstCatalog(const TrajectoryFn &primary, int excludeIndex, double t0, double t1, double step,
+                          double threshold, const Vector3d &sigmaRtn, double primaryRadius,
+                          std::vector<ConjunctionEvent> &out)
+{
+    const Catalog &catalog = GetCatalog();
+    int numSamples = std::max(2, (int)std::ceil((t1 - t0) / step) + 1);
+    step = (t1 - t0) / (numSamples - 1);
+
+    // The screened trajectory is sampled once and shared by every object.
+    std::vector<Vector3d> pr(numSamples), pv(numSamples);
+    double rMin = INFINITY, rMax = 0;
+    for (int k = 0; k < numSamples; ++k)
+    {
+        if (!primary(t0 + k * step, pr[k], pv[k]))
+        {
+            LogDebug("[ScreenAgainstCatalog] Trajectory could not be evaluated.");
+            return;
+        }
+        double r = Norm(pr[k]);
+        double margin = Norm(pv[k]) * step;
+        rMin = std::min(rMin, r - margin);
+        rMax = std::max(rMax, r + margin);
+    }
+
+    std::mutex lock;
+    ParallelFor(catalog.Count(), [&](int i)
+    {
+        if (i == excludeIndex)
+            return;
+
+        Vector3d r0{catalog.px[i], catalog.py[i], catalog.pz[i]}, v0{catalog.vx[i], catalog.vy[i], catalog.vz[i]};
+        double rp, ra;
+        ApsisRadii(r0, v0, catalog.mu, rp, ra);
+        if (rp > rMax + threshold || ra < rMin - threshold)
+            return;
+
+        std::vector<ConjunctionEvent> found;
+        double gPrev = 0, dPrev = 0, sPrev = 0;
+        for (int k = 0; k < numSamples; ++k)
+        {
+            double t = t0 + k * step;
+            Vector3d rb, vb;
+            if (!catalog.StateAt(i, t, rb, vb))
+                return;
+            Vector3d dr = rb - pr[k], dv = vb - pv[k];
+            double g = Dot(dr, dv), d = Norm(dr), speed = Norm(dv);
+
+            // A range minimum lies in [t - step, t] when the range rate turns positive, or at an end of the span.
+            bool minimum = (k > 0 && gPrev < 0 && g >= 0) || (k == 0 && g >= 0) || (k == numSamples - 1 && g < 0);
+            double bound = k > 0 ? std::min(d, dPrev) - 0.5 * step * std::max(speed, sPrev) : d;
+            if (minimum && bound <= threshold)
+            {
+                double ta = k > 0 ? t - step : t;
+                double tca;
+                Vector3d pa, va, dra, dva;
+                if (RefineTca(primary, i, ta, t, tca) && RelativeState(primary, i, tca, pa, va, dra, dva))
+                {
+                    double miss = Norm(dra);
+                    if (miss <= threshold)
+                    {
+                        ConjunctionEvent e{};
+                        e.tca = tca;
+                        e.missDistance = miss;
+                        e.relativeSpeed = Norm(dva);
+                        e.pc = CollisionProbability(dra, dva, pa, va, sigmaRtn, primaryRadius + catalog.radius[i]);
+                        e.objectId = catalog.ids[i];
+                        found.push_back(e);
+                    }
+                }
+            }
+            gPrev = g, dPrev = d, sPrev = speed;
+        }
+
+        if (!found.empty())
+        {
+            std::lock_guard<std::mutex> guard(lock);
+            out.insert(out.end(), found.begin(), found.end());
+        }
+    });
+
+    std::sort(out.begin(), out.end(), [](const ConjunctionEvent &a, const ConjunctionEvent &b)
+              { return a.tca < b.tca; });
+}
+
+/**
+ * @brief Screens a state against the catalog over a time span.
+ * @param position State position at startTime (inertial, Z = rotation axis, sim units).
+ * @param velocity State velocity (units/s).
+ * @param startTime Simulation time of the state and start of the span (s).
+ * @param endTime End of the span (s).
+ * @param step Sampling step (s); should be a small fraction of the shortest orbital period.
+ * @param threshold Miss distance below which a conjunction is reported (units).
+ * @param sigmaRtn Combined 1-sigma position uncertainty along R, T, N (units).
+ * @param hardBodyRadius Hard-body radius of the screened object (units).
+ * @param excludeId Catalog id of the screened object itself, or -1.
+ * @param conjunctions Output buffer (capacity maxConjunctions), sorted by TCA.
+ * @param maxConjunctions Capacity of the output buffer.
+ * @return Number of conjunctions found (may exceed maxConjunctions; only the first are written).
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogScreen(double3 position, double3 velocity, double startTime, double endTime,
+                                                                    double step, double threshold, double3 sigmaRtn, double hardBodyRadius,
+                                                                    int excludeId, ConjunctionEvent *conjunctions, int maxConjunctions)
+{
+    if (endTime <= startTime || step <= 0)
+        return 0;
+
+    Vector3d r0 = ToVector3dFromDouble3(position), v0 = ToVector3dFromDouble3(velocity);
+    const Catalog &catalog = GetCatalog();
+    int self = catalog.Find(excludeId);
+    double ballistic = self >= 0 ? catalog.ballistic[self] : 0.0;
+    TrajectoryFn trajectory = [&](double t, Vector3d &r, Vector3d &v)
+    { return catalog.Propagate(r0, v0, t - startTime, ballistic, r, v); };
+
+    std::vector<ConjunctionEvent> found;
+    ScreenAgainstCatalog(trajectory, self, startTime, endTime, step, threshold,
+                         ToVector3dFromDouble3(sigmaRtn), hardBodyRadius, found);
+
+    int n = std::min((int)found.size(), maxConjunctions);
+    std::copy(found.begin(), found.begin() + n, conjunctions);
+    return (int)found.size();
+}
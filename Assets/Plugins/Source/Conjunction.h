@@ -0,0 +1,70 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file Conjunction.h
+ * @brief Conjunction screening of a trajectory against the catalog, TCA refinement and
+ * collision probability.
+ */
+
+extern "C"
+{
+    /**
+     * @struct ConjunctionEvent
+     * @brief A close approach between the screened trajectory and a catalog object.
+     * Layout must match NativePhysics.ConjunctionEvent on the C# side.
+     */
+    struct ConjunctionEvent
+    {
+        double tca;           ///< Time of closest approach (s).
+        double missDistance;  ///< Distance at TCA (units).
+        double relativeSpeed; ///< Relative speed at TCA (units/s).
+        double pc;            ///< Probability of collision.
+        int objectId;         ///< Catalog id of the other object.
+        int reserved;
+    };
+}
+
+/** State of the screened trajectory at time t; returns false if it cannot be evaluated. */
+using TrajectoryFn = std::function<bool(double t, Vector3d &r, Vector3d &v)>;
+
+/**
+ * @brief Collision probability in the encounter plane (short-encounter approximation).
+ * The combined position covariance is diagonal in the primary's RTN frame; it is projected
+ * onto the plane normal to the relative velocity and integrated over the hard-body disk.
+ *
+ * @param relPos Secondary minus primary position at TCA.
+ * @param relVel Secondary minus primary velocity at TCA.
+ * @param primaryPos Primary position (defines RTN).
+ * @param primaryVel Primary velocity.
+ * @param sigmaRtn Combined 1-sigma position uncertainty along R, T, N (units).
+ * @param hardBodyRadius Combined hard-body radius (units).
+ */
+double CollisionProbability(const Vector3d &relPos, const Vector3d &relVel, const Vector3d &primaryPos,
+                            const Vector3d &primaryVel, const Vector3d &sigmaRtn, double hardBodyRadius);
+
+/**
+ * @brief Finds the TCA between the trajectory and catalog entry i inside [ta, tb], where the
+ * range rate changes sign from negative to positive.
+ * @return False if either state could not be evaluated.
+ */
+bool RefineTca(const TrajectoryFn &primary, int i, double ta, double tb, double &tca);
+
+/**
+ * @brief Screens a trajectory against every catalog object over [t0, t1].
+ * Objects whose perigee/apogee band cannot come within the threshold of the trajectory's
+ * radius band are skipped; the rest are sampled at the given step and every range-rate
+ * minimum closer than the threshold is refined and reported. Objects are screened in parallel.
+ *
+ * @param primary Screened trajectory.
+ * @param excludeIndex Catalog index to skip (the maneuvering object itself), or -1.
+ * @param primaryRadius Hard-body radius of the screened object (units).
+ * @param out Conjunctions found, sorted by TCA.
+ */
+void ScreenAgainstCatalog(const TrajectoryFn &primary, int excludeIndex, double t0, double t1, double step,
+                          double threshold, const Vector3d &sigmaRtn, double primaryRadius,
+                          std::vector<ConjunctionEvent> &out);
@@ -4,44 +4,11 @@
 #include <sstream>
 #include <iomanip>
 
+#include "Budget.h"
+#include "PhysicsCommon.h"
+
 extern "C"
 {
-    /**
-     * @struct Vector3
-     * @brief 3D vector using single-precision floats.
-     */
-    struct Vector3
-    {
-        float x, y, z;
-    };
-
-    /**
-     * @struct Vector3d
-     * @brief 3D vector using double-precision floats.
-     */
-    struct Vector3d
-    {
-        double x, y, z;
-    };
-
-    /**
-     * @struct double3
-     * @brief Unity-compatible 3D double-precision vector.
-     */
-    struct double3
-    {
-        double x, y, z;
-    };
-
-    /** Converts Vector3 to Vector3d */
-    inline Vector3d ToVector3dFromVector3(const Vector3 &v) { return {v.x, v.y, v.z}; }
-
-    /** Converts double3 to Vector3d */
-    inline Vector3d ToVector3dFromDouble3(const double3 &v) { return {v.x, v.y, v.z}; }
-
-    /** Converts Vector3d to double3 */
-    inline double3 ToDouble3(const Vector3d &v) { return {v.x, v.y, v.z}; }
-
     /**
      * @brief Appends a message to the debug log file.
      * @param msg Message to write.
@@ -52,15 +19,6 @@ extern "C"
         log << msg << std::endl;
     }
 
-    // Constants
-    const double G = 6.67430e-23;                ///< Gravitational constant (scaled for sim units).
-    const double minDistSq = 1e-20;              ///< Minimum distance squared to avoid singularities.
-    const double maxForce = 1;                   ///< Cap on maximum gravitational force per object.
-    const double UNIT_TO_KM = 10.0;              ///< Unit conversion: 1 sim unit = 10 km.
-    const double EARTH_RADIUS_KM = 637.8 * 10.0; ///< Earth's radius in sim units.
-    const double OMEGA_EARTH = 7.2921150e-5;     ///< Earth's angular velocity (rad/s).
-    const double DENSITY_SCALE = 1.0;            ///< Global scaling for atmosphere density.
-
     static const int JR_N = 51;
     static const double JR_ALT[JR_N] = {
         0, 10, 20, 30, 40,
@@ -109,26 +67,32 @@ extern "C"
     } _jrInit;
 
     /**
-     * @brief Computes atmospheric density at a given altitude using exponential interpolation.
+     * @brief Computes atmospheric density at a given altitude using exponential interpolation,
+     * without the cap below 130 km.
      * @param altKm Altitude in kilometers.
      * @return Density in kg/km³.
      */
-    static inline double ComputeAtmosphericDensity(double altKm)
+    double ComputeAtmosphericDensityUncapped(double altKm)
     {
         if (altKm <= JR_ALT[0])
             return JR_RHO[0];
         if (altKm >= JR_ALT[JR_N - 1])
             return 0.0;
 
-        // pick band
         int idx = std::min(int(altKm / 10.0), JR_N - 2);
         double dH = altKm - JR_ALT[idx];
-        if (altKm < 130)
-        {
-            double rho = JR_RHO[idx] * std::exp(-dH / JR_H[idx]);
-            return std::min(rho, 1e4);
-        }
-        return JR_RHO[idx] * std::exp(-dH / JR_H[idx]) * DENSITY_SCALE;
+        double rho = JR_RHO[idx] * std::exp(-dH / JR_H[idx]);
+        return altKm < 130 ? rho : rho * DENSITY_SCALE;
+    }
+
+    /**
+     * @brief Atmospheric density with the low-altitude cap used for orbital decay.
+     * @param altKm Altitude in kilometers.
+     * @return Density in kg/km³.
+     */
+    double ComputeAtmosphericDensity(double altKm)
+    {
+        return std::min(ComputeAtmosphericDensityUncapped(altKm), 1e4);
     }
 
     /**
@@ -212,11 +176,6 @@ extern "C"
         return a;
     }
 
-    static const double c_dp[7] = {0.0, 1. / 5, 3. / 10, 4. / 5, 8. / 9, 1.0, 1.0};
-    static const double a_dp[7][6] = {
-        {}, {1. / 5}, {3. / 40, 9. / 40}, {44. / 45, -56. / 15, 32. / 9}, {19372. / 6561, -25360. / 2187, 64448. / 6561, -212. / 729}, {9017. / 3168, -355. / 33, 46732. / 5247, 49. / 176, -5103. / 18656}, {35. / 384, 0, 500. / 1113, 125. / 192, -2187. / 6784, 11. / 84}};
-    static const double b_dp[7] = {35. / 384, 0, 500. / 1113, 125. / 192, -2187. / 6784, 11. / 84, 0};
-
     /**
      * @brief Performs one integration step using the Dormand-Prince 5th order Runge-Kutta method.
      * @param pos Position (input/output).
@@ -323,6 +282,7 @@ extern "C"
         float dragCoeff,
         float areaUU)
     {
+        BudgetScope budget(BUDGET_PHYSICS);
         if (mass <= 1e-6f)
             return;
 
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "EarthOrientation.h"
+#include "Frames.h"
+#include "TimeScales.h"
+
+namespace
+{
+    /** One day of the table, at 0h UTC. */
+    struct EopNode
+    {
+        double xp, yp;       ///< Pole coordinates (rad).
+        double ut1MinusTai;  ///< UT1 - TAI (s).
+    };
+
+    struct EopTable
+    {
+        double startMjd = 0; ///< MJD of the first row.
+        std::vector<EopNode> nodes;
+    };
+
+    std::atomic<const EopTable *> activeTable{nullptr};
+
+    /** Replaced tables stay alive: a worker may still be reading one. Reloads are rare. */
+    std::vector<std::unique_ptr<EopTable>> &GetRetiredTables()
+    {
+        static std::vector<std::unique_ptr<EopTable>> tables;
+        return tables;
+    }
+
+    /** Parses a fixed-width field; false when it is missing or blank. */
+    bool ParseField(const std::string &line, size_t start, size_t width, double &value)
+    {
+        if (line.size() < start + width)
+            return false;
+        std::string field = line.substr(start, width);
+        char *end = nullptr;
+        value = std::strtod(field.c_str(), &end);
+        return end != field.c_str();
+    }
+}
+
+EarthOrientation EarthOrientationAt(double t)
+{
+    const EopTable *table = activeTable.load(std::memory_order_acquire);
+    if (table)
+    {
+        // Rows are at 0h UTC but indexed with TT; the ~1 min offset is well below the data's
+        // precision (µs in UT1, µas at the pole).
+        JulianDate tt = SimulationToTT(t);
+        double x = (tt.day - MJD_ZERO - table->startMjd) + tt.fraction;
+        if (x >= 0 && x <= table->nodes.size() - 1)
+        {
+            size_t k = std::min((size_t)x, table->nodes.size() - 2);
+            double w = x - k;
+            const EopNode &a = table->nodes[k], &b = table->nodes[k + 1];
+            return {a.xp + w * (b.xp - a.xp), a.yp + w * (b.yp - a.yp),
+                    a.ut1MinusTai + w * (b.ut1MinusTai - a.ut1MinusTai) - TT_MINUS_TAI, true};
+        }
+    }
+    return {0, 0, UtcMinusTT(t), false};
+}
+
+/**
+ * @brief Loads Earth orientation parameters from an IERS finals file (finals2000A.all/.data/.daily).
+ * Uses the Bulletin A columns (pole and UT1 - UTC, observed and predicted) up to the first row
+ * where they are missing. The leap-second table should be loaded first; it is used to store UT1
+ * against TAI. Safe to call from one thread while others transform points.
+ * @param path Path to the file.
+ * @return Number of daily rows loaded, or 0 on failure (the previous table is kept).
+ */
+extern "C" __attribute__((visibility("default"))) int EopLoad(const char *path)
+{
+    FILE *f = std::fopen(path, "r");
+    if (!f)
+    {
+        LogDebug(std::string("[EopLoad] Cannot open ") + path);
+        return 0;
+    }
+    auto table = std::make_unique<EopTable>();
+    char buffer[256];
+    while (std::fgets(buffer, sizeof(buffer), f))
+    {
+        std::string line(buffer);
+        double mjd, xp, yp, dut1;
+        if (!ParseField(line, 7, 8, mjd) || !ParseField(line, 18, 9, xp) || !ParseField(line, 37, 9, yp) ||
+            !ParseField(line, 58, 10, dut1))
+            break;
+        if (table->nodes.empty())
+            table->startMjd = mjd;
+        else if (mjd != table->startMjd + table->nodes.size())
+            break;
+        double taiMinusUtc = TaiMinusUtc({mjd + MJD_ZERO, 0});
+        table->nodes.push_back({xp * ARCSEC_TO_RAD, yp * ARCSEC_TO_RAD, dut1 - taiMinusUtc});
+    }
+    std::fclose(f);
+    if (table->nodes.size() < 2)
+    {
+        LogDebug(std::string("[EopLoad] No usable rows in ") + path);
+        return 0;
+    }
+    int rows = (int)table->nodes.size();
+    activeTable.store(table.get(), std::memory_order_release);
+    GetRetiredTables().push_back(std::move(table));
+    return rows;
+}
+
+/**
+ * @brief Earth orientation parameters at a simulation time.
+ * @param time Simulation time (s).
+ * @param xp Output pole x (arcsec).
+ * @param yp Output pole y (arcsec).
+ * @param ut1MinusUtc Output UT1 - UTC (s).
+ * @return 1 if the time is inside the loaded table, 0 if defaults were returned.
+ */
+extern "C" __attribute__((visibility("default"))) int EopGet(double time, double *xp, double *yp, double *ut1MinusUtc)
+{
+    EarthOrientation eo = EarthOrientationAt(time);
+    *xp = eo.xp / ARCSEC_TO_RAD;
+    *yp = eo.yp / ARCSEC_TO_RAD;
+    *ut1MinusUtc = eo.ut1MinusTT - UtcMinusTT(time);
+    return eo.measured ? 1 : 0;
+}
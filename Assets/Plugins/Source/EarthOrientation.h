@@ -0,0 +1,27 @@
+#pragma once
+
+/**
+ * @file EarthOrientation.h
+ * @brief Earth orientation parameters (polar motion, UT1) from IERS files.
+ *
+ * A loaded file becomes an immutable daily table. Lookups compute the row index directly from
+ * the date and interpolate linearly. The table is published through an atomic pointer, so batch
+ * kernels on worker threads read it without locks. UT1 is stored as UT1 - TAI, which has no
+ * jumps at leap seconds. Outside the table the pole is taken as zero and UT1 as UTC.
+ */
+
+/**
+ * @struct EarthOrientation
+ * @brief Interpolated Earth orientation at one instant.
+ */
+struct EarthOrientation
+{
+    double xp, yp;     ///< Pole coordinates (rad).
+    double ut1MinusTT; ///< UT1 - TT (s).
+    bool measured;     ///< False when the date is outside the loaded table.
+};
+
+/**
+ * @brief Earth orientation at simulation time t (s).
+ */
+EarthOrientation EarthOrientationAt(double t);
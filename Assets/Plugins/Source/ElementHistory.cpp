@@ -0,0 +1,441 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "ElementHistory.h"
+#include "Frames.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    const char HISTORY_MAGIC[8] = {'O', 'C', 'S', 'E', 'L', 'H', '0', '1'};
+    const double SAME_EPOCH_DAYS = 1e-9;   ///< Epochs closer than this (days, ~0.1 ms) are the same set.
+    const int LOOKUP_BLOCK = 256;          ///< Sorted queries per work item of the batch lookup.
+
+    /** File header; the record count follows from the file size. */
+    struct HistoryHeader
+    {
+        char magic[8];
+        uint32_t recordSize;
+        uint32_t reserved;
+    };
+
+    /** One element set as stored on disk (native byte order). Records with no catalog number are padding. */
+    struct HistoryRecord
+    {
+        int32_t catalogNumber;
+        int32_t reserved;
+        double epochDay, epochFraction; ///< UTC.
+        double meanMotion, eccentricity, inclination, raan, argPerigee, meanAnomaly, bstar;
+    };
+
+    /** Index entry: a record and its epoch as UTC days since J2000. */
+    struct EpochEntry
+    {
+        double epoch;
+        uint32_t record;
+    };
+
+    /** Read-only mapping of the history file. */
+    class MappedFile
+    {
+    public:
+        ~MappedFile() { Unmap(); }
+
+        bool Map(const std::string &path)
+        {
+            Unmap();
+#ifdef _WIN32
+            file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                               FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return false;
+            LARGE_INTEGER fileSize;
+            mapping = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0
+                          ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                          : nullptr;
+            data = mapping ? (const char *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+            size = data ? (size_t)fileSize.QuadPart : 0;
+#else
+            int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return false;
+            struct stat st;
+            if (fstat(fd, &st) == 0 && st.st_size > 0)
+            {
+                void *p = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+                if (p != MAP_FAILED)
+                {
+                    data = (const char *)p;
+                    size = (size_t)st.st_size;
+                }
+            }
+            close(fd);
+#endif
+            if (!data)
+                Unmap();
+            return data != nullptr;
+        }
+
+        void Unmap()
+        {
+#ifdef _WIN32
+            if (data)
+                UnmapViewOfFile(data);
+            if (mapping)
+                CloseHandle(mapping);
+            if (file != INVALID_HANDLE_VALUE)
+                CloseHandle(file);
+            mapping = nullptr;
+            file = INVALID_HANDLE_VALUE;
+#else
+            if (data)
+                munmap((void *)data, size);
+#endif
+            data = nullptr;
+            size = 0;
+        }
+
+        const char *data = nullptr;
+        size_t size = 0;
+
+    private:
+#ifdef _WIN32
+        HANDLE file = INVALID_HANDLE_VALUE;
+        HANDLE mapping = nullptr;
+#endif
+    };
+
+    struct ElementHistory
+    {
+        std::string path;
+        MappedFile map;
+        uint32_t recordCount = 0;
+        std::unordered_map<int, std::vector<EpochEntry>> index; ///< Per object, sorted by epoch.
+
+        const HistoryRecord &Record(uint32_t k) const
+        {
+            return ((const HistoryRecord *)(map.data + sizeof(HistoryHeader)))[k];
+        }
+    };
+
+    ElementHistory *openHistory = nullptr;
+
+    double EpochKey(const JulianDate &utc)
+    {
+        return (utc.day - J2000_JD) + utc.fraction;
+    }
+
+    HistoryRecord ToRecord(const ElementSet &s)
+    {
+        return {s.catalogNumber, 0, s.epoch.day, s.epoch.fraction, s.meanMotion, s.eccentricity,
+                s.inclination, s.raan, s.argPerigee, s.meanAnomaly, s.bstar};
+    }
+
+    ElementSet ToElementSet(const HistoryRecord &r)
+    {
+        ElementSet s;
+        s.catalogNumber = r.catalogNumber;
+        s.epoch = {r.epochDay, r.epochFraction};
+        s.meanMotion = r.meanMotion;
+        s.eccentricity = r.eccentricity;
+        s.inclination = r.inclination;
+        s.raan = r.raan;
+        s.argPerigee = r.argPerigee;
+        s.meanAnomaly = r.meanAnomaly;
+        s.bstar = r.bstar;
+        return s;
+    }
+
+    /** Adds a record to its object's epoch list; appends arrive mostly in epoch order. */
+    void IndexRecord(ElementHistory &h, const HistoryRecord &r, uint32_t k)
+    {
+        if (r.catalogNumber <= 0)
+            return;
+        std::vector<EpochEntry> &list = h.index[r.catalogNumber];
+        EpochEntry entry{EpochKey({r.epochDay, r.epochFraction}), k};
+        auto it = std::upper_bound(list.begin(), list.end(), entry.epoch,
+                                   [](double e, const EpochEntry &x) { return e < x.epoch; });
+        list.insert(it, entry);
+    }
+
+    bool Contains(const ElementHistory &h, int id, double epoch)
+    {
+        auto found = h.index.find(id);
+        if (found == h.index.end())
+            return false;
+        const std::vector<EpochEntry> &list = found->second;
+        auto it = std::lower_bound(list.begin(), list.end(), epoch - SAME_EPOCH_DAYS,
+                                   [](const EpochEntry &x, double e) { return x.epoch < e; });
+        return it != list.end() && it->epoch <= epoch + SAME_EPOCH_DAYS;
+    }
+
+    /** Maps the file and checks its header; the record count excludes a torn trailing record. */
+    bool MapHistory(ElementHistory &h)
+    {
+        if (!h.map.Map(h.path) || h.map.size < sizeof(HistoryHeader))
+            return false;
+        const HistoryHeader *header = (const HistoryHeader *)h.map.data;
+        if (std::memcmp(header->magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC)) != 0 ||
+            header->recordSize != sizeof(HistoryRecord))
+            return false;
+        h.recordCount = (uint32_t)((h.map.size - sizeof(HistoryHeader)) / sizeof(HistoryRecord));
+        return true;
+    }
+
+    /** Index of the record at or before an epoch, or -1 if the object has none that early. */
+    int64_t FindPreceding(const ElementHistory &h, int id, double epoch)
+    {
+        auto found = h.index.find(id);
+        if (found == h.index.end())
+            return -1;
+        const std::vector<EpochEntry> &list = found->second;
+        auto it = std::upper_bound(list.begin(), list.end(), epoch,
+                                   [](double e, const EpochEntry &x) { return e < x.epoch; });
+        return it == list.begin() ? -1 : (int64_t)std::prev(it)->record;
+    }
+}
+
+int ElementHistoryAppendSets(const ElementSet *sets, int count)
+{
+    ElementHistory *h = openHistory;
+    if (!h)
+        return 0;
+    std::vector<std::pair<int, double>> keys;
+    std::vector<HistoryRecord> fresh;
+    for (int k = 0; k < count; ++k)
+    {
+        double epoch = EpochKey(sets[k].epoch);
+        if (sets[k].catalogNumber <= 0 || Contains(*h, sets[k].catalogNumber, epoch))
+            continue;
+        keys.push_back({sets[k].catalogNumber, epoch});
+        fresh.push_back(ToRecord(sets[k]));
+    }
+
+    // Drop repeats within the batch itself.
+    std::vector<int> order(fresh.size());
+    for (size_t k = 0; k < order.size(); ++k)
+        order[k] = (int)k;
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return keys[a] < keys[b]; });
+    std::vector<HistoryRecord> unique;
+    for (size_t k = 0; k < order.size(); ++k)
+    {
+        const auto &key = keys[order[k]];
+        if (k > 0 && keys[order[k - 1]].first == key.first && key.second - keys[order[k - 1]].second <= SAME_EPOCH_DAYS)
+            continue;
+        unique.push_back(fresh[order[k]]);
+    }
+    fresh.swap(unique);
+    if (fresh.empty())
+        return 0;
+
+    // Records are only ever appended; the mapping is dropped while the file grows.
+    h->map.Unmap();
+    FILE *f = std::fopen(h->path.c_str(), "ab");
+    size_t written = f ? std::fwrite(fresh.data(), sizeof(HistoryRecord), fresh.size(), f) : 0;
+    if (f)
+        std::fclose(f);
+    uint32_t first = h->recordCount;
+    if (!MapHistory(*h))
+    {
+        LogDebug("[ElementHistoryAppendSets] Cannot remap " + h->path);
+        delete openHistory;
+        openHistory = nullptr;
+        return 0;
+    }
+    for (uint32_t k = first; k < h->recordCount; ++k)
+        IndexRecord(*h, h->Record(k), k);
+    if (written != fresh.size())
+        LogDebug("[ElementHistoryAppendSets] Short write to " + h->path);
+    return (int)(h->recordCount - first);
+}
+
+/**
+ * @brief Opens an element-set history file, creating it if missing, and builds the epoch index.
+ * Any previously open history is closed. A torn trailing record is padded out so later appends
+ * stay aligned.
+ * @param path Path to the history file.
+ * @return Number of records in the file, or -1 if it cannot be opened or is not a history file.
+ */
+extern "C" __attribute__((visibility("default"))) int ElementHistoryOpen(const char *path)
+{
+    delete openHistory;
+    openHistory = nullptr;
+
+    FILE *f = std::fopen(path, "ab");
+    if (!f)
+    {
+        LogDebug(std::string("[ElementHistoryOpen] Cannot open ") + path);
+        return -1;
+    }
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    if (size == 0)
+    {
+        HistoryHeader header{};
+        std::memcpy(header.magic, HISTORY_MAGIC, sizeof(HISTORY_MAGIC));
+        header.recordSize = sizeof(HistoryRecord);
+        std::fwrite(&header, sizeof(header), 1, f);
+    }
+    else if (size > (long)sizeof(HistoryHeader))
+    {
+        long torn = (size - (long)sizeof(HistoryHeader)) % (long)sizeof(HistoryRecord);
+        if (torn != 0)
+        {
+            std::vector<char> padding(sizeof(HistoryRecord) - torn, 0);
+            std::fwrite(padding.data(), 1, padding.size(), f);
+        }
+    }
+    std::fclose(f);
+
+    auto *h = new ElementHistory;
+    h->path = path;
+    if (!MapHistory(*h))
+    {
+        LogDebug(std::string("[ElementHistoryOpen] Not an element-set history: ") + path);
+        delete h;
+        return -1;
+    }
+    for (uint32_t k = 0; k < h->recordCount; ++k)
+        IndexRecord(*h, h->Record(k), k);
+    openHistory = h;
+    return (int)h->recordCount;
+}
+
+/**
+ * @brief Closes the open history file, if any.
+ */
+extern "C" __attribute__((visibility("default"))) void ElementHistoryClose()
+{
+    delete openHistory;
+    openHistory = nullptr;
+}
+
+/**
+ * @brief Appends the element sets of a TLE file (two- or three-line form) to the open history.
+ * @param path Path to the TLE file.
+ * @return Number of sets appended, or -1 without an open history or readable file.
+ */
+extern "C" __attribute__((visibility("default"))) int ElementHistoryAppendTleFile(const char *path)
+{
+    FILE *f = openHistory ? std::fopen(path, "r") : nullptr;
+    if (!f)
+    {
+        LogDebug(std::string("[ElementHistoryAppendTleFile] No open history or cannot open ") + path);
+        return -1;
+    }
+    std::vector<ElementSet> sets;
+    char buffer[256];
+    std::string pending;
+    while (std::fgets(buffer, sizeof(buffer), f))
+    {
+        std::string line(buffer);
+        line.erase(line.find_last_not_of("\r\n") + 1);
+        ElementSet set;
+        if (line.size() > 1 && line[0] == '1' && line[1] == ' ')
+            pending = line;
+        else if (line.size() > 1 && line[0] == '2' && line[1] == ' ' && !pending.empty())
+        {
+            if (ParseTle(pending.c_str(), line.c_str(), set))
+                sets.push_back(set);
+            pending.clear();
+        }
+    }
+    std::fclose(f);
+    return ElementHistoryAppendSets(sets.data(), (int)sets.size());
+}
+
+/**
+ * @brief Number of element sets stored for an object.
+ * @param id Catalog number.
+ * @return Count, or 0 if the object is unknown or no history is open.
+ */
+extern "C" __attribute__((visibility("default"))) int ElementHistoryCount(int id)
+{
+    if (!openHistory)
+        return 0;
+    auto found = openHistory->index.find(id);
+    return found == openHistory->index.end() ? 0 : (int)found->second.size();
+}
+
+/**
+ * @brief States of objects at given times from the nearest preceding element set of each.
+ * Queries are grouped by element set so each set is initialised once per block.
+ * @param ids Catalog number of each query.
+ * @param times Simulation time of each query (s).
+ * @param count Number of queries.
+ * @param positions Output inertial positions (units).
+ * @param velocities Output inertial velocities (units/s).
+ * @param valid Output per query: 1 if a state was produced, 0 if there is no set at or before
+ *        the time or SGP4 failed.
+ * @return Number of valid states, or -1 without an open history.
+ */
+extern "C" __attribute__((visibility("default"))) int ElementHistoryStateBatch(const int *ids, const double *times, int count,
+                                                                               double3 *positions, double3 *velocities, int *valid)
+{
+    const ElementHistory *h = openHistory;
+    if (!h)
+        return -1;
+    if (count <= 0)
+        return 0;
+
+    // Pair each query with its element set, then sort by set so a block shares initialisations.
+    std::vector<std::pair<int64_t, int>> work(count);
+    ParallelFor((count + LOOKUP_BLOCK - 1) / LOOKUP_BLOCK, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * LOOKUP_BLOCK);
+        for (int k = b * LOOKUP_BLOCK; k < end; ++k)
+        {
+            JulianDate utc = ConvertTime(SimulationToTT(times[k]), SCALE_TT, SCALE_UTC);
+            work[k] = {FindPreceding(*h, ids[k], EpochKey(utc)), k};
+        }
+    });
+    std::sort(work.begin(), work.end());
+    auto range = std::minmax_element(times, times + count);
+    EnsureFrameGrid(*range.first, *range.second);
+
+    ParallelFor((count + LOOKUP_BLOCK - 1) / LOOKUP_BLOCK, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * LOOKUP_BLOCK);
+        int64_t current = -1;
+        bool ready = false;
+        ElementSet set;
+        Sgp4State state;
+        for (int w = b * LOOKUP_BLOCK; w < end; ++w)
+        {
+            int k = work[w].second;
+            valid[k] = 0;
+            if (work[w].first < 0)
+                continue;
+            if (work[w].first != current)
+            {
+                current = work[w].first;
+                set = ToElementSet(h->Record((uint32_t)current));
+                ready = Sgp4Init(set, state);
+            }
+            Vector3d r, v;
+            if (ready && ElementSetStateAt(set, state, times[k], r, v))
+            {
+                positions[k] = ToDouble3(r);
+                velocities[k] = ToDouble3(v);
+                valid[k] = 1;
+            }
+        }
+    });
+    return (int)std::count(valid, valid + count, 1);
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "Sgp4.h"
+
+/**
+ * @file ElementHistory.h
+ * @brief Append-only, memory-mapped history of element sets per catalog object.
+ *
+ * The history file is a short header followed by fixed-size element-set records, appended in
+ * arrival order and never rewritten. On open, the file is mapped read-only and an index is
+ * built from it: for each object, its records sorted by epoch. A state lookup picks the
+ * nearest element set at or before the requested time and propagates it with SGP4. That is
+ * how the sets were meant to be used, and it keeps historical states consistent with what was
+ * known at the time. A record cut short by an interrupted append is ignored.
+ *
+ * SGP4 is near-Earth only (see Sgp4.h), so deep-space objects are less accurate far from the
+ * chosen epoch. Mutated from the main thread only; batch lookups read it concurrently.
+ */
+
+/**
+ * @brief Appends element sets to the open history, skipping sets already stored for the same
+ * object and epoch. Called by the catalog update path; does nothing without an open history.
+ * @return Number of sets appended.
+ */
+int ElementHistoryAppendSets(const ElementSet *sets, int count);
@@ -0,0 +1,255 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Budget.h"
+#include "PhysicsCommon.h"
+#include "Kepler.h"
+
+/**
+ * @file Encke.cpp
+ * @brief Encke-formulation propagator.
+ *
+ * Instead of integrating the full acceleration, only the deviation of the body from an
+ * analytic osculating Kepler orbit about the primary (bodies[0]) is integrated. The
+ * two-body term is carried exactly by the reference orbit, so the integrated quantity is
+ * small and smooth and much larger steps can be taken at the same accuracy. When the
+ * deviation grows past ENCKE_RECTIFY_RATIO of the reference radius the reference is
+ * re-osculated (rectified) to the current state.
+ */
+
+const double ENCKE_RECTIFY_RATIO = 1e-2; ///< Max |deviation| / |reference radius| before rectification.
+const double ENCKE_RESYNC_TOL = 1e-6;    ///< Relative mismatch that forces a re-initialisation.
+
+extern "C"
+{
+    /**
+     * @struct EnckeState
+     * @brief Per-body Encke bookkeeping, owned by the caller and passed by reference every step.
+     * Layout must match NativePhysics.EnckeState on the C# side.
+     */
+    struct EnckeState
+    {
+        double3 referencePosition;     ///< Reference position relative to the primary at the last rectification.
+        double3 referenceVelocity;     ///< Reference velocity at the last rectification.
+        double3 deltaPosition;         ///< Integrated deviation from the reference position.
+        double3 deltaVelocity;         ///< Integrated deviation from the reference velocity.
+        double timeSinceRectification; ///< Seconds elapsed on the current reference orbit.
+        double chi;                    ///< Universal anomaly warm start for the reference solve.
+        int rectificationCount;        ///< Number of rectifications performed (diagnostics).
+        int initialized;               ///< Non-zero once the reference has been set.
+    };
+}
+
+/**
+ * @brief Battin's f(q), evaluated without the cancellation in 1 - (rho/r)^3.
+ */
+static inline double EnckeF(double q)
+{
+    double s = std::sqrt(1.0 + q);
+    return q * (3.0 + 3.0 * q + q * q) / (1.0 + s * s * s);
+}
+
+/**
+ * @brief Resets the reference orbit to the given relative state and clears the deviation.
+ */
+static void Rectify(EnckeState &s, const Vector3d &relPos, const Vector3d &relVel)
+{
+    s.referencePosition = ToDouble3(relPos);
+    s.referenceVelocity = ToDouble3(relVel);
+    s.deltaPosition = {0, 0, 0};
+    s.deltaVelocity = {0, 0, 0};
+    s.timeSinceRectification = 0.0;
+    s.chi = 0.0;
+    s.rectificationCount++;
+}
+
+/**
+ * @brief Deviation acceleration for the Encke formulation.
+ * @param ref Reference position relative to the primary.
+ * @param delta Deviation from the reference.
+ * @param primary Absolute position of the primary.
+ * @param mu Gravitational parameter of the primary.
+ * @param bodies Perturbing body positions (primary excluded).
+ * @param masses Perturbing body masses.
+ * @param n Number of perturbing bodies.
+ * @param mass Mass of the propagated body.
+ * @param thrustAcc Thrust acceleration.
+ * @return Second derivative of the deviation.
+ */
+static Vector3d DeviationAcceleration(
+    const Vector3d &ref,
+    const Vector3d &delta,
+    const Vector3d &primary,
+    double mu,
+    const Vector3d *bodies,
+    const double *masses,
+    int n,
+    double mass,
+    const Vector3d &thrustAcc)
+{
+    Vector3d r = ref + delta;
+    double r2 = Dot(r, r);
+    double rho2 = Dot(ref, ref);
+    double rho3 = rho2 * std::sqrt(rho2);
+
+    double q = Dot(delta, delta - 2.0 * r) / r2;
+    Vector3d a = -(mu / rho3) * (EnckeF(q) * r + delta);
+
+    if (n > 0)
+        a += ComputeAcceleration(primary + r, (double *)masses, (Vector3d *)bodies, n, mass);
+
+    return a + thrustAcc;
+}
+
+/**
+ * @brief Advances the deviation by one Dormand-Prince step along the current reference.
+ * @param refStart Reference position at the start of the step.
+ * @param refEnd Output reference position at the end of the step.
+ * @param refEndVel Output reference velocity at the end of the step.
+ */
+static void EnckeStep(
+    EnckeState &s,
+    const Vector3d &primary,
+    double mu,
+    const Vector3d *bodies,
+    const double *masses,
+    int n,
+    double mass,
+    const Vector3d &thrustAcc,
+    double dt,
+    const Vector3d &refStart,
+    Vector3d &refEnd,
+    Vector3d &refEndVel)
+{
+    Vector3d ref0 = ToVector3dFromDouble3(s.referencePosition);
+    Vector3d vref0 = ToVector3dFromDouble3(s.referenceVelocity);
+    Vector3d dp = ToVector3dFromDouble3(s.deltaPosition);
+    Vector3d dv = ToVector3dFromDouble3(s.deltaVelocity);
+
+    // Reference positions at every stage node; the last two nodes coincide (c = 1).
+    Vector3d refStage[7];
+    refStage[0] = refStart;
+    double chi = s.chi;
+    for (int i = 1; i < 7; i++)
+    {
+        if (c_dp[i] == c_dp[i - 1])
+        {
+            refStage[i] = refStage[i - 1];
+            continue;
+        }
+        double stageChi = s.chi;
+        KeplerPropagate(ref0, vref0, mu, s.timeSinceRectification + c_dp[i] * dt, refStage[i], refEndVel, &stageChi);
+        chi = stageChi;
+    }
+
+    Vector3d kx[7], kv[7];
+    kx[0] = dv;
+    kv[0] = DeviationAcceleration(refStage[0], dp, primary, mu, bodies, masses, n, mass, thrustAcc);
+
+    for (int i = 1; i < 7; i++)
+    {
+        Vector3d pi = dp, vi = dv;
+        for (int j = 0; j < i; j++)
+        {
+            pi += (dt * a_dp[i][j]) * kx[j];
+            vi += (dt * a_dp[i][j]) * kv[j];
+        }
+        kx[i] = vi;
+        kv[i] = DeviationAcceleration(refStage[i], pi, primary, mu, bodies, masses, n, mass, thrustAcc);
+    }
+
+    for (int i = 0; i < 7; i++)
+    {
+        dp += (dt * b_dp[i]) * kx[i];
+        dv += (dt * b_dp[i]) * kv[i];
+    }
+
+    s.deltaPosition = ToDouble3(dp);
+    s.deltaVelocity = ToDouble3(dv);
+    s.timeSinceRectification += dt;
+    s.chi = chi;
+    refEnd = refStage[6];
+}
+
+/**
+ * @brief Public C-callable Encke propagation step.
+ * The body is propagated about bodies[0]; remaining bodies act as perturbations.
+ * If the incoming position no longer matches the Encke state (first call, or the body was
+ * moved externally) the reference orbit is re-osculated before stepping.
+ *
+ * @param position Pointer to position vector (in/out).
+ * @param velocity Pointer to velocity vector (in/out).
+ * @param state Pointer to the caller-owned Encke state (in/out).
+ * @param mass Mass of the object.
+ * @param bodies Array of other body positions (float), primary first.
+ * @param masses Array of other body masses.
+ * @param numBodies Number of other bodies.
+ * @param dt Timestep in seconds.
+ * @param thrustImpulse Impulse applied (force * dt).
+ */
+extern "C" __attribute__((visibility("default"))) void EnckeSingle(
+    double3 *position,
+    double3 *velocity,
+    EnckeState *state,
+    double mass,
+    Vector3 *bodies,
+    double *masses,
+    int numBodies,
+    float dt,
+    Vector3 thrustImpulse)
+{
+    BudgetScope budget(BUDGET_PHYSICS);
+    if (mass <= 1e-6f || numBodies <= 0)
+        return;
+
+    Vector3d bodiesD[256];
+    double massesD[256];
+    for (int i = 0; i < numBodies; i++)
+    {
+        bodiesD[i] = ToVector3dFromVector3(bodies[i]);
+        massesD[i] = masses[i];
+    }
+
+    Vector3d primary = bodiesD[0];
+    double mu = G * massesD[0];
+
+    Vector3d relPos = ToVector3dFromDouble3(*position) - primary;
+    Vector3d relVel = ToVector3dFromDouble3(*velocity);
+
+    EnckeState &s = *state;
+    if (!s.initialized)
+    {
+        Rectify(s, relPos, relVel);
+        s.rectificationCount = 0;
+        s.initialized = 1;
+    }
+
+    Vector3d refStart, vrefStart;
+    double chi = s.chi;
+    KeplerPropagate(ToVector3dFromDouble3(s.referencePosition), ToVector3dFromDouble3(s.referenceVelocity),
+                    mu, s.timeSinceRectification, refStart, vrefStart, &chi);
+
+    Vector3d expectedPos = refStart + ToVector3dFromDouble3(s.deltaPosition);
+    Vector3d expectedVel = vrefStart + ToVector3dFromDouble3(s.deltaVelocity);
+    if (Norm(expectedPos - relPos) > ENCKE_RESYNC_TOL * Norm(relPos) ||
+        Norm(expectedVel - relVel) > ENCKE_RESYNC_TOL * std::max(Norm(relVel), 1e-9))
+    {
+        Rectify(s, relPos, relVel);
+        refStart = relPos;
+    }
+
+    Vector3d th{thrustImpulse.x / mass, thrustImpulse.y / mass, thrustImpulse.z / mass};
+
+    Vector3d refEnd, refEndVel;
+    EnckeStep(s, primary, mu, bodiesD + 1, massesD + 1, numBodies - 1, mass, th, (double)dt, refStart, refEnd, refEndVel);
+
+    Vector3d dp = ToVector3dFromDouble3(s.deltaPosition);
+    Vector3d newRel = refEnd + dp;
+    Vector3d newVel = refEndVel + ToVector3dFromDouble3(s.deltaVelocity);
+
+    if (Norm(dp) > ENCKE_RECTIFY_RATIO * Norm(refEnd))
+        Rectify(s, newRel, newVel);
+
+    *position = ToDouble3(primary + newRel);
+    *velocity = ToDouble3(newVel);
+}
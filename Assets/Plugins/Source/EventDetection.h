@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cmath>
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file EventDetection.h
+ * @brief Dense output and root location for switching-function events.
+ *
+ * Propagators sample a switching function g(t) at the ends of each step. When g changes
+ * sign the step is interpolated with a cubic Hermite segment built from the end-point
+ * states and the crossing time is located on that interpolant, so event times are found
+ * to high accuracy without shrinking the integration step.
+ */
+
+/**
+ * @struct HermiteSegment
+ * @brief Cubic Hermite interpolant of position over one integration step.
+ */
+struct HermiteSegment
+{
+    double t0, t1;  ///< Step start and end times.
+    Vector3d p0, v0; ///< State at t0.
+    Vector3d p1, v1; ///< State at t1.
+
+    /** Position at time t in [t0, t1]. */
+    Vector3d Position(double t) const
+    {
+        double h = t1 - t0;
+        double s = (t - t0) / h;
+        double s2 = s * s, s3 = s2 * s;
+        double h00 = 2 * s3 - 3 * s2 + 1;
+        double h10 = s3 - 2 * s2 + s;
+        double h01 = -2 * s3 + 3 * s2;
+        double h11 = s3 - s2;
+        return h00 * p0 + (h10 * h) * v0 + h01 * p1 + (h11 * h) * v1;
+    }
+
+    /** Velocity (derivative of the interpolant) at time t in [t0, t1]. */
+    Vector3d Velocity(double t) const
+    {
+        double h = t1 - t0;
+        double s = (t - t0) / h;
+        double s2 = s * s;
+        double d00 = (6 * s2 - 6 * s) / h;
+        double d10 = 3 * s2 - 4 * s + 1;
+        double d01 = (-6 * s2 + 6 * s) / h;
+        double d11 = 3 * s2 - 2 * s;
+        return d00 * p0 + d10 * v0 + d01 * p1 + d11 * v1;
+    }
+};
+
+/**
+ * @brief Locates a sign change of g on [ta, tb] with the Illinois (modified regula falsi) method.
+ * @param g Switching function of time.
+ * @param ta Bracket start.
+ * @param tb Bracket end.
+ * @param ga g(ta).
+ * @param gb g(tb); must have the opposite sign of ga.
+ * @param tol Absolute time tolerance.
+ * @return Time of the crossing.
+ */
+template <typename SwitchFn>
+double LocateEvent(SwitchFn g, double ta, double tb, double ga, double gb, double tol)
+{
+    int side = 0;
+    double t = ta;
+    for (int iter = 0; iter < 60; ++iter)
+    {
+        t = (ta * gb - tb * ga) / (gb - ga);
+        if (std::fabs(tb - ta) < tol)
+            break;
+
+        double gt = g(t);
+        if (gt == 0.0)
+            break;
+
+        if ((gt > 0) == (gb > 0))
+        {
+            tb = t;
+            gb = gt;
+            if (side == -1)
+                ga *= 0.5;
+            side = -1;
+        }
+        else
+        {
+            ta = t;
+            ga = gt;
+            if (side == 1)
+                gb *= 0.5;
+            side = 1;
+        }
+    }
+    return t;
+}
@@ -0,0 +1,300 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "EarthOrientation.h"
+#include "Frames.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    /**
+     * Largest luni-solar terms of the IAU 2000B nutation series: multipliers of l, l', F, D, Ω,
+     * then longitude (sin, t·sin, cos) and obliquity (cos, t·cos, sin) coefficients in 0.1 µas.
+     * Truncating here keeps the pole within about 10 mas (0.3 m at the surface) of IAU 2000A.
+     */
+    const double NUTATION_TERMS[][11] = {
+        {0, 0, 0, 0, 1, -172064161.0, -174666.0, 33386.0, 92052331.0, 9086.0, 15377.0},
+        {0, 0, 2, -2, 2, -13170906.0, -1675.0, -13696.0, 5730336.0, -3015.0, -4587.0},
+        {0, 0, 2, 0, 2, -2276413.0, -234.0, 2796.0, 978459.0, -485.0, 1374.0},
+        {0, 0, 0, 0, 2, 2074554.0, 207.0, -698.0, -897492.0, 470.0, -291.0},
+        {0, 1, 0, 0, 0, 1475877.0, -3633.0, 11817.0, 73871.0, -184.0, -1924.0},
+        {0, 1, 2, -2, 2, -516821.0, 1226.0, -524.0, 224386.0, -677.0, -174.0},
+        {1, 0, 0, 0, 0, 711159.0, 73.0, -872.0, -6750.0, 0.0, 358.0},
+        {0, 0, 2, 0, 1, -387298.0, -367.0, 380.0, 200728.0, 18.0, 318.0},
+        {1, 0, 2, 0, 2, -301461.0, -36.0, 816.0, 129025.0, -63.0, 367.0},
+        {0, -1, 2, -2, 2, 215829.0, -494.0, 111.0, -95929.0, 299.0, 132.0},
+        {0, 0, 2, -2, 1, 128227.0, 137.0, 181.0, -68982.0, -9.0, 39.0},
+        {-1, 0, 2, 0, 2, 123457.0, 11.0, 19.0, -53311.0, 32.0, -4.0},
+        {-1, 0, 0, 2, 0, 156994.0, 10.0, -168.0, -1235.0, 0.0, 82.0},
+        {1, 0, 0, 0, 1, 63110.0, 63.0, 27.0, -33228.0, 0.0, -9.0},
+        {-1, 0, 0, 0, 1, -57976.0, -63.0, -189.0, 31429.0, 0.0, -75.0},
+        {-1, 0, 2, 2, 2, -59641.0, -11.0, 149.0, 25543.0, -11.0, 66.0},
+        {1, 0, 2, 0, 1, -51613.0, -42.0, 129.0, 26366.0, 0.0, 78.0},
+        {-2, 0, 2, 0, 1, 45893.0, 50.0, 31.0, -24236.0, -10.0, 20.0},
+        {0, 0, 0, 2, 0, 63384.0, 11.0, -150.0, -1220.0, 0.0, 29.0},
+        {0, 0, 2, 2, 2, -38571.0, -1.0, 158.0, 16452.0, -11.0, 68.0},
+    };
+
+    const double NUTATION_UNIT = 1e-7 * ARCSEC_TO_RAD; ///< 0.1 µas.
+    const double TURN_ARCSEC = 1296000.0;
+
+    /** Fundamental (Delaunay) arguments, IERS Conventions 2003 (rad). */
+    void FundamentalArguments(double t, double &l, double &lp, double &f, double &d, double &om)
+    {
+        auto arg = [&](double c0, double c1, double c2, double c3, double c4)
+        {
+            return std::fmod(c0 + t * (c1 + t * (c2 + t * (c3 + t * c4))), TURN_ARCSEC) * ARCSEC_TO_RAD;
+        };
+        l = arg(485868.249036, 1717915923.2178, 31.8792, 0.051635, -0.00024470);
+        lp = arg(1287104.79305, 129596581.0481, -0.5532, 0.000136, -0.00001149);
+        f = arg(335779.526232, 1739527262.8478, -12.7512, -0.001037, 0.00000417);
+        d = arg(1072260.70369, 1602961601.2090, -6.3706, 0.006593, -0.00003169);
+        om = arg(450160.398036, -6962890.5431, 7.4722, 0.007702, -0.00005939);
+    }
+
+    /** Mean obliquity of date, IAU 2006 (rad). */
+    double MeanObliquity(double t)
+    {
+        return (84381.406 + t * (-46.836769 + t * (-0.0001831 + t * (0.00200340 + t * (-0.000000576 + t * -0.0000000434))))) *
+               ARCSEC_TO_RAD;
+    }
+
+    /** GMST - ERA, IAU 2006 (rad). */
+    double GmstMinusEra(double t)
+    {
+        return (0.014506 + t * (4612.156534 + t * (1.3915817 + t * (-0.00000044 + t * (-0.000029956 + t * -0.0000000368))))) *
+               ARCSEC_TO_RAD;
+    }
+
+    Matrix3 RotX(double a)
+    {
+        double c = std::cos(a), s = std::sin(a);
+        return {{{1, 0, 0}, {0, c, s}, {0, -s, c}}};
+    }
+
+    Matrix3 RotZ(double a)
+    {
+        double c = std::cos(a), s = std::sin(a);
+        return {{{c, s, 0}, {-s, c, 0}, {0, 0, 1}}};
+    }
+
+    /** NPB and GAST - ERA tabulated at FRAME_GRID_STEP from start. */
+    struct FrameGrid
+    {
+        double start = 0;
+        std::vector<Matrix3> npb;
+        std::vector<double> offset;
+
+        bool Covers(double t) const
+        {
+            return !npb.empty() && t >= start && t <= start + (npb.size() - 1) * FRAME_GRID_STEP;
+        }
+    };
+
+    FrameGrid &GetFrameGrid()
+    {
+        static FrameGrid grid;
+        return grid;
+    }
+
+    double Centuries(double t)
+    {
+        JulianDate tt = SimulationToTT(t);
+        return ((tt.day - J2000_JD) + tt.fraction) / DAYS_PER_CENTURY;
+    }
+
+    /** Interpolated (or directly evaluated) NPB and GAST - ERA at simulation time t. */
+    void SlowTerms(double t, Matrix3 &npb, double &offset)
+    {
+        const FrameGrid &grid = GetFrameGrid();
+        if (!grid.Covers(t))
+        {
+            npb = PrecessionNutationMatrix(Centuries(t));
+            offset = EquinoxOffset(Centuries(t));
+            return;
+        }
+        double x = (t - grid.start) / FRAME_GRID_STEP;
+        size_t k = std::min((size_t)x, grid.npb.size() - 2);
+        double w = x - k;
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                npb.m[i][j] = grid.npb[k].m[i][j] + w * (grid.npb[k + 1].m[i][j] - grid.npb[k].m[i][j]);
+        offset = grid.offset[k] + w * (grid.offset[k + 1] - grid.offset[k]);
+    }
+}
+
+void Nutation(double t, double &dpsi, double &deps)
+{
+    double l, lp, f, d, om;
+    FundamentalArguments(t, l, lp, f, d, om);
+    dpsi = deps = 0;
+    for (const double *term : NUTATION_TERMS)
+    {
+        double arg = term[0] * l + term[1] * lp + term[2] * f + term[3] * d + term[4] * om;
+        double s = std::sin(arg), c = std::cos(arg);
+        dpsi += (term[5] + term[6] * t) * s + term[7] * c;
+        deps += (term[8] + term[9] * t) * c + term[10] * s;
+    }
+    // Fixed offsets standing in for the planetary terms of IAU 2000B.
+    dpsi = dpsi * NUTATION_UNIT - 0.135e-3 * ARCSEC_TO_RAD;
+    deps = deps * NUTATION_UNIT + 0.388e-3 * ARCSEC_TO_RAD;
+}
+
+Matrix3 PrecessionNutationMatrix(double t)
+{
+    // Fukushima–Williams angles, IAU 2006 (frame bias included).
+    double gamb = (-0.052928 + t * (10.556378 + t * (0.4932044 + t * (-0.00031238 + t * (-0.000002788 + t * 0.0000000260))))) *
+                  ARCSEC_TO_RAD;
+    double phib = (84381.412819 + t * (-46.811016 + t * (0.0511268 + t * (0.00053289 + t * (-0.000000440 + t * -0.0000000176))))) *
+                  ARCSEC_TO_RAD;
+    double psib = (-0.041775 + t * (5038.481484 + t * (1.5584175 + t * (-0.00018522 + t * (-0.000026452 + t * -0.0000000148))))) *
+                  ARCSEC_TO_RAD;
+    double dpsi, deps;
+    Nutation(t, dpsi, deps);
+    return RotX(-(MeanObliquity(t) + deps)) * RotZ(-(psib + dpsi)) * RotX(phib) * RotZ(gamb);
+}
+
+double EquinoxOffset(double t)
+{
+    // GMST - ERA plus the equation of the equinoxes with its two largest complementary terms.
+    double l, lp, f, d, om, dpsi, deps;
+    FundamentalArguments(t, l, lp, f, d, om);
+    Nutation(t, dpsi, deps);
+    double complementary = (2640.96e-6 * std::sin(om) + 63.52e-6 * std::sin(2 * om)) * ARCSEC_TO_RAD;
+    return GmstMinusEra(t) + dpsi * std::cos(MeanObliquity(t)) + complementary;
+}
+
+double EarthRotationAngleUt1(const JulianDate &ut1)
+{
+    // Whole days contribute whole turns, so only the day's fraction enters at full size.
+    double days = ut1.day - J2000_JD;
+    double turns = (days - std::floor(days)) + ut1.fraction + 0.7790572732640 + 0.00273781191135448 * (days + ut1.fraction);
+    return 2 * M_PI * (turns - std::floor(turns));
+}
+
+double Ut1MinusTT(double t)
+{
+    return EarthOrientationAt(t).ut1MinusTT;
+}
+
+void EnsureFrameGrid(double ta, double tb)
+{
+    FrameGrid &grid = GetFrameGrid();
+    if (grid.Covers(ta) && grid.Covers(tb))
+        return;
+    double start = ta - FRAME_GRID_MARGIN, end = tb + FRAME_GRID_MARGIN;
+    if (!grid.npb.empty())
+    {
+        start = std::min(start, grid.start);
+        end = std::max(end, grid.start + (grid.npb.size() - 1) * FRAME_GRID_STEP);
+    }
+    start = std::floor(start / FRAME_GRID_STEP) * FRAME_GRID_STEP;
+    int count = (int)std::ceil((end - start) / FRAME_GRID_STEP) + 1;
+
+    FrameGrid next;
+    next.start = start;
+    next.npb.resize(count);
+    next.offset.resize(count);
+    ParallelFor(count, [&](int k)
+    {
+        double t = Centuries(start + k * FRAME_GRID_STEP);
+        next.npb[k] = PrecessionNutationMatrix(t);
+        next.offset[k] = EquinoxOffset(t);
+    });
+    grid = std::move(next);
+}
+
+void ResetFrameGrid()
+{
+    GetFrameGrid() = FrameGrid{};
+}
+
+double SiderealAngle(double t)
+{
+    Matrix3 npb;
+    double offset;
+    SlowTerms(t, npb, offset);
+    JulianDate ut1 = SimulationToTT(t + Ut1MinusTT(t));
+    return std::fmod(EarthRotationAngleUt1(ut1) + offset + 2 * M_PI, 2 * M_PI);
+}
+
+Matrix3 TemeToCelestial(double t)
+{
+    Matrix3 npb;
+    double offset;
+    SlowTerms(t, npb, offset);
+    // TEME's x axis is the mean equinox, which trails the true equinox by the equation of the equinoxes.
+    double equationOfEquinoxes = offset - GmstMinusEra(Centuries(t));
+    return npb.Transposed() * RotZ(-equationOfEquinoxes);
+}
+
+Matrix3 CelestialToTerrestrial(double t)
+{
+    Matrix3 npb;
+    double offset;
+    SlowTerms(t, npb, offset);
+    EarthOrientation eo = EarthOrientationAt(t);
+    JulianDate ut1 = SimulationToTT(t + eo.ut1MinusTT);
+    double gast = EarthRotationAngleUt1(ut1) + offset;
+    double c = std::cos(gast), s = std::sin(gast);
+    // Polar motion W = R1(-yp) R2(-xp) R3(s') to first order; the pole angles are ~1e-6 rad, so the
+    // dropped products are ~1e-12 rad. s' (-47 µas/century) is below that resolution and omitted.
+    Matrix3 m;
+    for (int j = 0; j < 3; ++j)
+    {
+        double r0 = c * npb.m[0][j] + s * npb.m[1][j];
+        double r1 = -s * npb.m[0][j] + c * npb.m[1][j];
+        double r2 = npb.m[2][j];
+        m.m[0][j] = r0 + eo.xp * r2;
+        m.m[1][j] = r1 - eo.yp * r2;
+        m.m[2][j] = r2 - eo.xp * r0 + eo.yp * r1;
+    }
+    return m;
+}
+
+/**
+ * @brief Greenwich apparent sidereal time at a simulation time, for rotating the Earth model.
+ * @param time Simulation time (s).
+ * @return Angle in [0, 2π) (rad).
+ */
+extern "C" __attribute__((visibility("default"))) double FrameGetSiderealAngle(double time)
+{
+    EnsureFrameGrid(time, time);
+    return SiderealAngle(time);
+}
+
+/**
+ * @brief GCRF-to-ITRF rotation at a simulation time.
+ * @param time Simulation time (s).
+ * @param matrix Output row-major 3x3 matrix (9 doubles).
+ */
+extern "C" __attribute__((visibility("default"))) void FrameGetCelestialToTerrestrial(double time, double *matrix)
+{
+    EnsureFrameGrid(time, time);
+    Matrix3 m = CelestialToTerrestrial(time);
+    std::copy(&m.m[0][0], &m.m[0][0] + 9, matrix);
+}
+
+/**
+ * @brief Transforms inertial positions to Earth-fixed positions in parallel.
+ * @param times Simulation time of each point (s).
+ * @param positions Inertial positions (GCRF axes).
+ * @param count Number of points.
+ * @param out Output Earth-fixed positions (ITRF axes).
+ */
+extern "C" __attribute__((visibility("default"))) void InertialToEarthFixedBatch(const double *times, const double3 *positions,
+                                                                                int count, double3 *out)
+{
+    if (count <= 0)
+        return;
+    auto range = std::minmax_element(times, times + count);
+    EnsureFrameGrid(*range.first, *range.second);
+    const int block = 1024;
+    ParallelFor((count + block - 1) / block, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * block);
+        for (int k = b * block; k < end; ++k)
+            out[k] = ToDouble3(CelestialToTerrestrial(times[k]) * ToVector3dFromDouble3(positions[k]));
+    });
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include "PhysicsCommon.h"
+#include "TimeScales.h"
+
+/**
+ * @file Frames.h
+ * @brief Celestial-to-terrestrial frame transforms (IAU 2006 precession, IAU 2000B nutation).
+ *
+ * The plugin's inertial frame is taken as the GCRF and the Earth-fixed frame as the ITRF.
+ * The transform is the equinox-based chain
+ *
+ *     r_ITRF = W · R3(GAST) · NPB · r_GCRF
+ *
+ * with NPB from the Fukushima–Williams precession angles and the nutation series, GAST from
+ * the Earth rotation angle plus the IAU 2006 GMST and equation-of-equinoxes terms, and W the
+ * polar motion from EarthOrientation.h (identity outside the loaded table).
+ *
+ * Everything except the Earth rotation angle varies slowly, so NPB and GAST - ERA are tabulated
+ * on a fixed time grid and interpolated linearly; a per-point transform costs one sine/cosine
+ * and two matrix products. Simulation time is TT from the epoch of TimeScales.h; UT1 is taken as
+ * UTC outside the loaded Earth orientation table.
+ */
+
+const double ARCSEC_TO_RAD = M_PI / (180.0 * 3600.0);
+const double FRAME_GRID_STEP = 21600.0;     ///< Spacing of the tabulated NPB and GAST - ERA (s).
+const double FRAME_GRID_MARGIN = 10 * 86400.0; ///< Extra span tabulated around a requested range (s).
+
+/**
+ * @struct Matrix3
+ * @brief Row-major 3x3 rotation.
+ */
+struct Matrix3
+{
+    double m[3][3];
+
+    Vector3d operator*(const Vector3d &v) const
+    {
+        return {m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z,
+                m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z,
+                m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z};
+    }
+
+    Matrix3 operator*(const Matrix3 &b) const
+    {
+        Matrix3 c{};
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                c.m[i][j] = m[i][0] * b.m[0][j] + m[i][1] * b.m[1][j] + m[i][2] * b.m[2][j];
+        return c;
+    }
+
+    Matrix3 Transposed() const
+    {
+        Matrix3 c{};
+        for (int i = 0; i < 3; ++i)
+            for (int j = 0; j < 3; ++j)
+                c.m[i][j] = m[j][i];
+        return c;
+    }
+};
+
+/**
+ * @brief Nutation in longitude and obliquity, IAU 2000B (largest luni-solar terms).
+ * @param t Julian centuries TT since J2000.
+ */
+void Nutation(double t, double &dpsi, double &deps);
+
+/**
+ * @brief Precession-nutation-bias matrix (GCRF to true equator and equinox of date).
+ * @param t Julian centuries TT since J2000.
+ */
+Matrix3 PrecessionNutationMatrix(double t);
+
+/**
+ * @brief Greenwich apparent sidereal time minus the Earth rotation angle (rad).
+ * @param t Julian centuries TT since J2000.
+ */
+double EquinoxOffset(double t);
+
+/**
+ * @brief Earth rotation angle (rad) for a two-part UT1 Julian date.
+ */
+double EarthRotationAngleUt1(const JulianDate &ut1);
+
+/** UT1 - TT at simulation time t (s). */
+double Ut1MinusTT(double t);
+
+/**
+ * @brief Makes sure the tabulated grid covers [ta, tb] (simulation seconds).
+ * Not thread-safe; batch kernels call it before fanning out, after which lookups are read-only.
+ */
+void EnsureFrameGrid(double ta, double tb);
+
+/**
+ * @brief Discards the tabulated grid, e.g. after the epoch or time tables change. Not thread-safe.
+ */
+void ResetFrameGrid();
+
+/**
+ * @brief Greenwich apparent sidereal time at simulation time t (rad).
+ */
+double SiderealAngle(double t);
+
+/**
+ * @brief TEME (the SGP4 output frame) to GCRF rotation at simulation time t.
+ */
+Matrix3 TemeToCelestial(double t);
+
+/**
+ * @brief GCRF-to-ITRF rotation at simulation time t.
+ * Interpolated inside the tabulated grid and evaluated from the series outside it, so it is
+ * safe to call concurrently.
+ */
+Matrix3 CelestialToTerrestrial(double t);
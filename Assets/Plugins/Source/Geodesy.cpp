@@ -0,0 +1,154 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Budget.h"
+#include "Catalog.h"
+#include "EventDetection.h"
+#include "Frames.h"
+#include "Geodesy.h"
+#include "ThreadPool.h"
+
+namespace
+{
+    const int GEODESY_BLOCK = 1024;        ///< Points per work item of the batch kernels.
+    const double GROUND_TRACK_KNOT = 60.0; ///< Propagation step behind the ground-track dense output (s).
+}
+
+Vector3d InertialToEarthFixed(const Vector3d &r, double t)
+{
+    return CelestialToTerrestrial(t) * r;
+}
+
+GeodeticPoint EarthFixedToGeodetic(const Vector3d &r)
+{
+    const double a2 = WGS84_A_KM * WGS84_A_KM, e4 = WGS84_E2 * WGS84_E2;
+    double x = r.x * UNIT_TO_KM, y = r.y * UNIT_TO_KM, z = r.z * UNIT_TO_KM;
+    double rho2 = x * x + y * y;
+
+    double p = rho2 / a2;
+    double q = (1 - WGS84_E2) / a2 * z * z;
+    double rr = (p + q - e4) / 6;
+    double s = e4 * p * q / (4 * rr * rr * rr);
+    double t = std::cbrt(1 + s + std::sqrt(s * (2 + s)));
+    double u = rr * (1 + t + 1 / t);
+    double v = std::sqrt(u * u + e4 * q);
+    double w = WGS84_E2 * (u + v - q) / (2 * v);
+    double k = std::sqrt(u + v + w * w) - w;
+    double d = k * std::sqrt(rho2) / (k + WGS84_E2);
+    double dz = std::sqrt(d * d + z * z);
+
+    GeodeticPoint g;
+    g.latitude = 2 * std::atan2(z, d + dz);
+    g.longitude = std::atan2(y, x);
+    g.altitudeKm = (k + WGS84_E2 - 1) / k * dz;
+    return g;
+}
+
+Vector3d GeodeticToEarthFixed(const GeodeticPoint &g)
+{
+    double sl = std::sin(g.latitude), cl = std::cos(g.latitude);
+    double n = WGS84_A_KM / std::sqrt(1 - WGS84_E2 * sl * sl);
+    double rho = (n + g.altitudeKm) * cl;
+    return Vector3d{rho * std::cos(g.longitude), rho * std::sin(g.longitude),
+                    (n * (1 - WGS84_E2) + g.altitudeKm) * sl} *
+           (1.0 / UNIT_TO_KM);
+}
+
+/**
+ * @brief Converts inertial positions to geodetic coordinates in parallel blocks.
+ * @param times Simulation time of each point (s).
+ * @param positions Inertial positions relative to Earth (Z = rotation axis, sim units).
+ * @param count Number of points.
+ * @param out Output geodetic coordinates.
+ */
+extern "C" __attribute__((visibility("default"))) void InertialToGeodeticBatch(const double *times, const double3 *positions,
+                                                                              int count, GeodeticPoint *out)
+{
+    if (count <= 0)
+        return;
+    auto range = std::minmax_element(times, times + count);
+    EnsureFrameGrid(*range.first, *range.second);
+    int blocks = (count + GEODESY_BLOCK - 1) / GEODESY_BLOCK;
+    ParallelFor(blocks, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * GEODESY_BLOCK);
+        for (int k = b * GEODESY_BLOCK; k < end; ++k)
+            out[k] = EarthFixedToGeodetic(InertialToEarthFixed(ToVector3dFromDouble3(positions[k]), times[k]));
+    });
+}
+
+/**
+ * @brief Converts Earth-fixed positions to geodetic coordinates in parallel blocks.
+ * @param positions Earth-fixed positions (sim units).
+ * @param count Number of points.
+ * @param out Output geodetic coordinates.
+ */
+extern "C" __attribute__((visibility("default"))) void EarthFixedToGeodeticBatch(const double3 *positions, int count, GeodeticPoint *out)
+{
+    int blocks = (count + GEODESY_BLOCK - 1) / GEODESY_BLOCK;
+    ParallelFor(blocks, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * GEODESY_BLOCK);
+        for (int k = b * GEODESY_BLOCK; k < end; ++k)
+            out[k] = EarthFixedToGeodetic(ToVector3dFromDouble3(positions[k]));
+    });
+}
+
+/**
+ * @brief Ground tracks of catalog objects sampled uniformly over a span.
+ * Each object is propagated only at knots GROUND_TRACK_KNOT apart and the samples are taken from
+ * the cubic Hermite dense output between them (under 1 m in LEO); the Earth-fixed rotation is
+ * evaluated once per sample time for all objects. Each trail budget level doubles the knot
+ * spacing, roughly halving the propagation work (about 200 m in LEO at level 3, 5 km at level 4).
+ * @param ids Object ids.
+ * @param idCount Number of objects.
+ * @param t0 Start time (s).
+ * @param t1 End time (s).
+ * @param samples Samples per object (>= 2).
+ * @param out Output, object-major (idCount * samples); NaN where the object is unknown or decayed.
+ * @return Number of objects whose track could be computed.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogGroundTracks(const int *ids, int idCount, double t0, double t1,
+                                                                          int samples, GeodeticPoint *out)
+{
+    BudgetScope budget(BUDGET_TRAILS);
+    if (samples < 2)
+        return 0;
+    const Catalog &catalog = GetCatalog();
+    double dt = (t1 - t0) / (samples - 1);
+    double knot = GROUND_TRACK_KNOT * (1 << BudgetLevel(BUDGET_TRAILS));
+    EnsureFrameGrid(t0, t1);
+    std::vector<Matrix3> earthFixed(samples);
+    for (int k = 0; k < samples; ++k)
+        earthFixed[k] = CelestialToTerrestrial(std::min(t1, t0 + k * dt));
+
+    std::vector<char> ok(idCount, 0);
+    ParallelFor(idCount, [&](int o)
+    {
+        GeodeticPoint *track = out + (size_t)o * samples;
+        int i = catalog.Find(ids[o]);
+        HermiteSegment seg;
+        seg.t0 = seg.t1 = t0;
+        bool valid = i >= 0 && catalog.StateAt(i, t0, seg.p1, seg.v1);
+        ok[o] = valid ? 1 : 0;
+        for (int k = 0; k < samples; ++k)
+        {
+            double t = std::min(t1, t0 + k * dt);
+            while (valid && t > seg.t1)
+            {
+                seg.t0 = seg.t1, seg.p0 = seg.p1, seg.v0 = seg.v1;
+                seg.t1 = std::min(t1, seg.t0 + knot);
+                valid = catalog.StateAt(i, seg.t1, seg.p1, seg.v1);
+            }
+            if (!valid)
+            {
+                track[k] = {NAN, NAN, NAN};
+                continue;
+            }
+            Vector3d r = seg.t1 > seg.t0 ? seg.Position(t) : seg.p1;
+            track[k] = EarthFixedToGeodetic(earthFixed[k] * r);
+        }
+    });
+    return (int)std::count(ok.begin(), ok.end(), 1);
+}
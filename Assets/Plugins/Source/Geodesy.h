@@ -0,0 +1,45 @@
+#pragma once
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file Geodesy.h
+ * @brief Earth-fixed and geodetic coordinates on the WGS-84 ellipsoid.
+ *
+ * Inertial positions follow the plugin convention (GCRF axes, sim units); the Earth-fixed frame
+ * is the ITRF of Frames.h.
+ */
+
+const double WGS84_A_KM = 6378.137;             ///< Equatorial radius (km).
+const double WGS84_F = 1.0 / 298.257223563;     ///< Flattening.
+const double WGS84_E2 = WGS84_F * (2 - WGS84_F); ///< First eccentricity squared.
+
+extern "C"
+{
+    /**
+     * @struct GeodeticPoint
+     * @brief Geodetic coordinates; layout must match NativePhysics.GeodeticPoint.
+     */
+    struct GeodeticPoint
+    {
+        double latitude;   ///< Geodetic latitude (rad).
+        double longitude;  ///< East longitude in (-π, π] (rad).
+        double altitudeKm; ///< Height above the ellipsoid (km).
+    };
+}
+
+/**
+ * @brief Rotates an inertial position into the Earth-fixed frame.
+ */
+Vector3d InertialToEarthFixed(const Vector3d &r, double t);
+
+/**
+ * @brief Earth-fixed position (sim units) to geodetic coordinates, closed form (Vermeille 2004).
+ * Exact for points outside the ellipsoid's evolute, i.e. more than ~43 km from Earth's centre.
+ */
+GeodeticPoint EarthFixedToGeodetic(const Vector3d &r);
+
+/**
+ * @brief Geodetic coordinates to an Earth-fixed position (sim units).
+ */
+Vector3d GeodeticToEarthFixed(const GeodeticPoint &g);
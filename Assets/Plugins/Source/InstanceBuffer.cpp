@@ -0,0 +1,171 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "Budget.h"
+#include "Catalog.h"
+#include "ThreadPool.h"
+
+/**
+ * @file InstanceBuffer.cpp
+ * @brief Packed per-instance render data for drawing the whole catalog with one instanced call.
+ *
+ * Every catalog object is propagated to the frame time in parallel and written to a
+ * caller-owned buffer in catalog order: camera-relative position in single precision (so large
+ * orbits keep sub-metre precision near the camera), a size that keeps a constant angular extent
+ * above a floor, and a colour by orbit regime. Positions are emitted in Unity's Y-up axes so the
+ * buffer can go to the GPU unchanged. Objects that cannot be propagated get size 0.
+ *
+ * Under load the frame-time budget lowers the catalog level. At level k, each object is propagated
+ * on every 2^k-th frame only, in rotating phases. In between, its last state is extrapolated with a
+ * second-order Taylor step, which is accurate for a small fraction of an orbit. An object is always
+ * propagated if it changed in the catalog or if its last state is older than that fraction.
+ */
+
+enum OrbitRegime
+{
+    REGIME_LEO = 0,
+    REGIME_MEO = 1,
+    REGIME_GEO = 2,
+    REGIME_HEO = 3,
+    REGIME_OTHER = 4,
+};
+
+const double LEO_APOGEE_LIMIT_KM = 2000.0; ///< Apogee altitude below which an orbit is LEO.
+const double GEO_RADIUS_KM = 42164.0;      ///< Geosynchronous orbit radius.
+const double GEO_TOLERANCE_KM = 500.0;     ///< Semi-major axis band counted as GEO.
+const double HEO_MIN_ECCENTRICITY = 0.25;  ///< Eccentricity from which an orbit is highly elliptical.
+const double INSTANCE_MAX_EXTRAPOLATION = 0.01; ///< Longest extrapolation, in orbital periods (~1e-4 relative error).
+
+extern "C"
+{
+    /**
+     * @struct InstanceSettings
+     * @brief Camera and styling for an instance buffer; layout must match NativePhysics.InstanceSettings.
+     */
+    struct InstanceSettings
+    {
+        double3 camera;            ///< Camera position (Unity axes, units).
+        double angularSize;        ///< Instance size per unit of camera distance.
+        double minSize;            ///< Smallest instance size (units).
+        uint32_t regimeColors[5];  ///< Packed RGBA per regime: LEO, MEO, GEO, HEO, other.
+        int reserved;
+    };
+
+    /**
+     * @struct InstanceData
+     * @brief One rendered instance; layout must match NativePhysics.InstanceData and the shader's buffer.
+     */
+    struct InstanceData
+    {
+        float x, y, z; ///< Position relative to the camera (Unity axes, units).
+        float size;    ///< World size (units); 0 for objects that could not be propagated.
+        uint32_t color; ///< Packed RGBA.
+        int id;
+    };
+}
+
+/**
+ * @brief Orbit regime from mean elements.
+ */
+OrbitRegime ClassifyRegime(const OrbitalElements &el)
+{
+    if (!(el.a > 0) || el.e >= 1)
+        return REGIME_OTHER;
+    double aKm = el.a * UNIT_TO_KM;
+    if (el.e >= HEO_MIN_ECCENTRICITY)
+        return REGIME_HEO;
+    if (std::fabs(aKm - GEO_RADIUS_KM) < GEO_TOLERANCE_KM)
+        return REGIME_GEO;
+    if (aKm * (1 + el.e) - EARTH_RADIUS_KM < LEO_APOGEE_LIMIT_KM)
+        return REGIME_LEO;
+    return REGIME_MEO;
+}
+
+namespace
+{
+    /** Last propagated state of a catalog slot, reused while the catalog level defers propagation. */
+    struct CachedState
+    {
+        Vector3d r, v;
+        double time;
+        double maxAge; ///< Longest extrapolation from this state (s).
+        uint64_t revision;
+        int id;
+        bool valid;
+    };
+
+    /** Per-slot states and the frame counter that picks which slots refresh this frame. */
+    struct InstanceCache
+    {
+        std::vector<CachedState> states;
+        unsigned frame = 0;
+    };
+
+    InstanceCache &GetInstanceCache()
+    {
+        static InstanceCache cache;
+        return cache;
+    }
+}
+
+/**
+ * @brief Fills a packed instance buffer for every catalog object at a given time.
+ * @param time Simulation time (s).
+ * @param settings Camera and styling.
+ * @param instances Output buffer in catalog order (capacity maxInstances).
+ * @param maxInstances Capacity of the output buffer.
+ * @return Number of instances written.
+ */
+extern "C" __attribute__((visibility("default"))) int CatalogFillInstances(double time, const InstanceSettings *settings,
+                                                                           InstanceData *instances, int maxInstances)
+{
+    BudgetScope budget(BUDGET_CATALOG);
+    const Catalog &catalog = GetCatalog();
+    const InstanceSettings &s = *settings;
+    Vector3d camera{s.camera.x, s.camera.z, s.camera.y};
+    int n = std::min(catalog.Count(), maxInstances);
+    unsigned stride = 1u << BudgetLevel(BUDGET_CATALOG);
+    InstanceCache &cache = GetInstanceCache();
+    unsigned phase = cache.frame++ % stride;
+    if ((int)cache.states.size() < n)
+        cache.states.resize(n, CachedState{});
+    ParallelFor(n, [&](int i)
+    {
+        InstanceData &out = instances[i];
+        out.id = catalog.ids[i];
+        out.color = s.regimeColors[ClassifyRegime(catalog.meanElements[i])];
+        CachedState &c = cache.states[i];
+        double dt = time - c.time;
+        Vector3d r, v;
+        if (stride == 1 || (unsigned)i % stride == phase || !c.valid || c.id != out.id ||
+            c.revision != catalog.revision[i] || !(std::fabs(dt) <= c.maxAge))
+        {
+            c.valid = catalog.StateAt(i, time, r, v);
+            c.id = out.id;
+            c.revision = catalog.revision[i];
+            if (!c.valid)
+            {
+                out.x = out.y = out.z = out.size = 0;
+                return;
+            }
+            double radius = Norm(r);
+            c.r = r;
+            c.v = v;
+            c.time = time;
+            c.maxAge = INSTANCE_MAX_EXTRAPOLATION * 2 * M_PI * std::sqrt(radius * radius * radius / catalog.mu);
+        }
+        else
+        {
+            double radius = Norm(c.r);
+            r = c.r + dt * c.v - (0.5 * dt * dt * catalog.mu / (radius * radius * radius)) * c.r;
+        }
+        Vector3d d = r - camera;
+        out.x = (float)d.x;
+        out.y = (float)d.z;
+        out.z = (float)d.y;
+        out.size = (float)std::max(s.minSize, s.angularSize * Norm(d));
+    });
+    return n;
+}
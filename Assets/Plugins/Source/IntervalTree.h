@@ -0,0 +1,145 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file IntervalTree.h
+ * @brief Dynamic interval tree over half-open time intervals.
+ *
+ * A treap keyed by interval start. Each node also stores the largest end in its subtree, so an
+ * overlap query skips any subtree that ends before the query begins. Node priorities are a hash
+ * of the insertion index rather than random draws, so the tree shape and the order in which
+ * queries visit intervals are reproducible. Nodes live in one vector and link by index. Inserts
+ * and queries take expected O(log n + k) time. Not thread-safe for concurrent inserts; concurrent
+ * queries are fine.
+ */
+class IntervalTree
+{
+public:
+    struct Interval
+    {
+        double lo, hi; ///< [lo, hi)
+        int value;
+    };
+
+    void Clear()
+    {
+        nodes.clear();
+        root = -1;
+    }
+
+    void Reserve(int count) { nodes.reserve(count); }
+
+    int Size() const { return (int)nodes.size(); }
+
+    void Insert(double lo, double hi, int value)
+    {
+        uint64_t h = (uint64_t)nodes.size() + 0x9E3779B97F4A7C15ull;
+        h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+        h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+        nodes.push_back({{lo, hi, value}, hi, (uint32_t)(h ^ (h >> 31)), -1, -1});
+        root = InsertAt(root, (int)nodes.size() - 1);
+    }
+
+    /** Whether any stored interval overlaps [lo, hi). */
+    bool Overlaps(double lo, double hi) const
+    {
+        bool found = false;
+        auto stop = [&](const Interval &)
+        {
+            found = true;
+            return false;
+        };
+        Visit(root, lo, hi, stop);
+        return found;
+    }
+
+    /**
+     * @brief Calls fn for every stored interval overlapping [lo, hi), in order of start.
+     * fn returns false to stop early.
+     */
+    template <typename Fn>
+    void ForEachOverlap(double lo, double hi, Fn &&fn) const
+    {
+        Visit(root, lo, hi, fn);
+    }
+
+private:
+    struct Node
+    {
+        Interval interval;
+        double maxHi;
+        uint32_t priority;
+        int left, right;
+    };
+
+    std::vector<Node> nodes;
+    int root = -1;
+
+    void Update(int t)
+    {
+        Node &n = nodes[t];
+        n.maxHi = n.interval.hi;
+        if (n.left >= 0)
+            n.maxHi = std::max(n.maxHi, nodes[n.left].maxHi);
+        if (n.right >= 0)
+            n.maxHi = std::max(n.maxHi, nodes[n.right].maxHi);
+    }
+
+    /** Splits subtree t into starts below key (l) and the rest (r). */
+    void Split(int t, double key, int &l, int &r)
+    {
+        if (t < 0)
+        {
+            l = r = -1;
+            return;
+        }
+        if (nodes[t].interval.lo < key)
+        {
+            Split(nodes[t].right, key, nodes[t].right, r);
+            l = t;
+        }
+        else
+        {
+            Split(nodes[t].left, key, l, nodes[t].left);
+            r = t;
+        }
+        Update(t);
+    }
+
+    int InsertAt(int t, int n)
+    {
+        if (t < 0)
+            return n;
+        if (nodes[n].priority > nodes[t].priority)
+        {
+            Split(t, nodes[n].interval.lo, nodes[n].left, nodes[n].right);
+            Update(n);
+            return n;
+        }
+        if (nodes[n].interval.lo < nodes[t].interval.lo)
+            nodes[t].left = InsertAt(nodes[t].left, n);
+        else
+            nodes[t].right = InsertAt(nodes[t].right, n);
+        Update(t);
+        return t;
+    }
+
+    /** In-order walk of the overlaps in subtree t; returns false once fn asked to stop. */
+    template <typename Fn>
+    bool Visit(int t, double lo, double hi, Fn &fn) const
+    {
+        if (t < 0 || nodes[t].maxHi <= lo)
+            return true;
+        const Node &n = nodes[t];
+        if (!Visit(n.left, lo, hi, fn))
+            return false;
+        if (n.interval.lo >= hi)
+            return true;
+        if (n.interval.hi > lo && !fn(n.interval))
+            return false;
+        return Visit(n.right, lo, hi, fn);
+    }
+};
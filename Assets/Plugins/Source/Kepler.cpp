@@ -0,0 +1,151 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Kepler.h"
+
+void StumpffCS(double z, double &c, double &s)
+{
+    if (z > 1e-6)
+    {
+        double sz = std::sqrt(z);
+        c = (1.0 - std::cos(sz)) / z;
+        s = (sz - std::sin(sz)) / (sz * z);
+    }
+    else if (z < -1e-6)
+    {
+        double sz = std::sqrt(-z);
+        c = (1.0 - std::cosh(sz)) / z;
+        s = (std::sinh(sz) - sz) / (sz * -z);
+    }
+    else
+    {
+        // Series expansion around z = 0 avoids the 0/0 cancellation.
+        c = 0.5 - z / 24.0 + z * z / 720.0;
+        s = 1.0 / 6.0 - z / 120.0 + z * z / 5040.0;
+    }
+}
+
+bool KeplerPropagate(const Vector3d &r0, const Vector3d &v0, double mu, double dt,
+                     Vector3d &r, Vector3d &v, double *chi)
+{
+    if (dt == 0.0)
+    {
+        r = r0;
+        v = v0;
+        return true;
+    }
+
+    double r0Mag = Norm(r0);
+    double v0Sq = Dot(v0, v0);
+    double sqrtMu = std::sqrt(mu);
+    double rdotv = Dot(r0, v0) / sqrtMu;
+    double alpha = 2.0 / r0Mag - v0Sq / mu; ///< Reciprocal semi-major axis.
+
+    double x;
+    if (chi != nullptr && *chi != 0.0)
+    {
+        x = *chi;
+    }
+    else if (alpha > 1e-9)
+    {
+        x = sqrtMu * dt * alpha;
+    }
+    else
+    {
+        // Parabolic / hyperbolic starting guess.
+        x = sqrtMu * dt / r0Mag;
+    }
+
+    double c = 0, s = 0, rMag = r0Mag;
+    bool converged = false;
+    for (int iter = 0; iter < 50; ++iter)
+    {
+        double x2 = x * x;
+        double z = alpha * x2;
+        StumpffCS(z, c, s);
+
+        double t = rdotv * x2 * c + (1.0 - r0Mag * alpha) * x2 * x * s + r0Mag * x;
+        rMag = x2 * c + rdotv * x * (1.0 - z * s) + r0Mag * (1.0 - z * c);
+
+        double dx = (sqrtMu * dt - t) / rMag;
+        x += dx;
+        if (std::fabs(dx) < 1e-12 * std::max(1.0, std::fabs(x)))
+        {
+            converged = true;
+            break;
+        }
+    }
+
+    double x2 = x * x;
+    double z = alpha * x2;
+    StumpffCS(z, c, s);
+    rMag = x2 * c + rdotv * x * (1.0 - z * s) + r0Mag * (1.0 - z * c);
+
+    double f = 1.0 - x2 / r0Mag * c;
+    double g = dt - x2 * x / sqrtMu * s;
+    r = f * r0 + g * v0;
+
+    double fdot = sqrtMu / (rMag * r0Mag) * x * (z * s - 1.0);
+    double gdot = 1.0 - x2 / rMag * c;
+    v = fdot * r0 + gdot * v0;
+
+    if (chi != nullptr)
+        *chi = x;
+
+    return converged;
+}
+
+bool LambertSolve(const Vector3d &r1, const Vector3d &r2, double tof, double mu, const Vector3d &normal,
+                  Vector3d &v1, Vector3d &v2)
+{
+    double r1Mag = Norm(r1), r2Mag = Norm(r2);
+    if (tof <= 0.0 || r1Mag == 0.0 || r2Mag == 0.0)
+        return false;
+
+    double cosNu = Dot(r1, r2) / (r1Mag * r2Mag);
+    double dm = Dot(Cross(r1, r2), normal) >= 0.0 ? 1.0 : -1.0; ///< +1 short way, -1 long way.
+    double A = dm * std::sqrt(r1Mag * r2Mag * (1.0 + cosNu));
+    if (std::fabs(A) < 1e-12 * (r1Mag + r2Mag))
+        return false;
+
+    double sqrtMu = std::sqrt(mu);
+    double psiLow = -4.0 * M_PI, psiHigh = 4.0 * M_PI * M_PI;
+    double psi = 0.0, c2 = 0.5, c3 = 1.0 / 6.0, y = 0.0;
+
+    // Bisection on psi: time of flight increases monotonically with psi for a single revolution.
+    bool converged = false;
+    for (int i = 0; i < 200; ++i)
+    {
+        StumpffCS(psi, c2, c3);
+        y = r1Mag + r2Mag + A * (psi * c3 - 1.0) / std::sqrt(c2);
+        if (A > 0.0 && y < 0.0)
+        {
+            // y must stay positive; move the lower bound up past the invalid region.
+            psiLow = psi;
+            psi = 0.5 * (psiLow + psiHigh);
+            continue;
+        }
+
+        double chi = std::sqrt(y / c2);
+        double t = (chi * chi * chi * c3 + A * std::sqrt(y)) / sqrtMu;
+        if (std::fabs(t - tof) < 1e-10 * tof)
+        {
+            converged = true;
+            break;
+        }
+        if (t < tof)
+            psiLow = psi;
+        else
+            psiHigh = psi;
+        psi = 0.5 * (psiLow + psiHigh);
+    }
+    if (!converged || y <= 0.0)
+        return false;
+
+    double f = 1.0 - y / r1Mag;
+    double g = A * std::sqrt(y / mu);
+    double gdot = 1.0 - y / r2Mag;
+    v1 = (1.0 / g) * (r2 - f * r1);
+    v2 = (1.0 / g) * (gdot * r2 - r1);
+    return true;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file Kepler.h
+ * @brief Analytic two-body propagation shared by the reference-orbit based propagators.
+ */
+
+/**
+ * @brief Evaluates the Stumpff functions C(z) and S(z) used by the universal-variable formulation.
+ * @param z Universal variable squared times the reciprocal semi-major axis.
+ * @param c Output C(z).
+ * @param s Output S(z).
+ */
+void StumpffCS(double z, double &c, double &s);
+
+/**
+ * @brief Propagates a two-body state analytically using universal variables.
+ * Valid for elliptic, parabolic and hyperbolic orbits.
+ *
+ * @param r0 Initial position relative to the attracting body.
+ * @param v0 Initial velocity relative to the attracting body.
+ * @param mu Gravitational parameter of the attracting body (sim units).
+ * @param dt Time of flight in seconds (may be negative).
+ * @param r Output position.
+ * @param v Output velocity.
+ * @param chi Optional in/out universal anomaly, used to warm-start repeated solves.
+ * @return False if the Newton iteration did not converge.
+ */
+bool KeplerPropagate(const Vector3d &r0, const Vector3d &v0, double mu, double dt,
+                     Vector3d &r, Vector3d &v, double *chi = nullptr);
+
+/**
+ * @brief Solves Lambert's problem (single revolution) with universal variables.
+ * The transfer direction is the one whose angular momentum agrees with the given normal,
+ * so the same call covers short- and long-way transfers.
+ *
+ * @param r1 Departure position.
+ * @param r2 Arrival position.
+ * @param tof Time of flight in seconds (> 0).
+ * @param mu Gravitational parameter (sim units).
+ * @param normal Reference orbit normal (e.g. the departure orbit's angular momentum).
+ * @param v1 Output departure velocity.
+ * @param v2 Output arrival velocity.
+ * @return False if no solution was found (e.g. collinear positions or no convergence).
+ */
+bool LambertSolve(const Vector3d &r1, const Vector3d &r2, double tof, double mu, const Vector3d &normal,
+                  Vector3d &v1, Vector3d &v2);
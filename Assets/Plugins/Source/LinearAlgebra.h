@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+/**
+ * @file LinearAlgebra.h
+ * @brief Small dense linear algebra used by the correctors and optimizers.
+ * Matrices are row-major arrays of doubles.
+ */
+
+/**
+ * @brief Solves A x = b in place with Gaussian elimination and partial pivoting.
+ * @param A n x n matrix (destroyed).
+ * @param b Right-hand side; overwritten with the solution.
+ * @param n System size.
+ * @return False if the matrix is numerically singular.
+ */
+inline bool SolveLinearSystem(double *A, double *b, int n)
+{
+    for (int k = 0; k < n; ++k)
+    {
+        int pivot = k;
+        double best = std::fabs(A[k * n + k]);
+        for (int i = k + 1; i < n; ++i)
+        {
+            double v = std::fabs(A[i * n + k]);
+            if (v > best)
+            {
+                best = v;
+                pivot = i;
+            }
+        }
+        if (best < 1e-300)
+            return false;
+
+        if (pivot != k)
+        {
+            for (int j = 0; j < n; ++j)
+                std::swap(A[k * n + j], A[pivot * n + j]);
+            std::swap(b[k], b[pivot]);
+        }
+
+        double inv = 1.0 / A[k * n + k];
+        for (int i = k + 1; i < n; ++i)
+        {
+            double f = A[i * n + k] * inv;
+            if (f == 0.0)
+                continue;
+            for (int j = k; j < n; ++j)
+                A[i * n + j] -= f * A[k * n + j];
+            b[i] -= f * b[k];
+        }
+    }
+
+    for (int i = n - 1; i >= 0; --i)
+    {
+        double s = b[i];
+        for (int j = i + 1; j < n; ++j)
+            s -= A[i * n + j] * b[j];
+        b[i] = s / A[i * n + i];
+    }
+    return true;
+}
+
+/**
+ * @brief Minimum-norm solution of the underdetermined system A x = b (m <= n).
+ * Computes x = A^T (A A^T + eps I)^-1 b; the small regularisation keeps the update
+ * well defined when constraints are redundant.
+ * @param A m x n matrix.
+ * @param b Right-hand side (length m).
+ * @param m Number of equations.
+ * @param n Number of unknowns.
+ * @param x Output solution (length n).
+ * @return False if the normal matrix could not be factored.
+ */
+inline bool SolveMinimumNorm(const double *A, const double *b, int m, int n, double *x)
+{
+    std::vector<double> AAt(m * m, 0.0);
+    double trace = 0.0;
+    for (int i = 0; i < m; ++i)
+    {
+        for (int j = 0; j <= i; ++j)
+        {
+            double s = 0.0;
+            for (int k = 0; k < n; ++k)
+                s += A[i * n + k] * A[j * n + k];
+            AAt[i * m + j] = s;
+            AAt[j * m + i] = s;
+        }
+        trace += AAt[i * m + i];
+    }
+    double eps = 1e-14 * trace / std::max(m, 1);
+    for (int i = 0; i < m; ++i)
+        AAt[i * m + i] += eps;
+
+    std::vector<double> y(b, b + m);
+    if (!SolveLinearSystem(AAt.data(), y.data(), m))
+        return false;
+
+    for (int k = 0; k < n; ++k)
+    {
+        double s = 0.0;
+        for (int i = 0; i < m; ++i)
+            s += A[i * n + k] * y[i];
+        x[k] = s;
+    }
+    return true;
+}
+
+/**
+ * @brief C = A B for row-major matrices (A: m x k, B: k x n).
+ */
+inline void MatMul(const double *A, const double *B, double *C, int m, int k, int n)
+{
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j)
+        {
+            double s = 0.0;
+            for (int p = 0; p < k; ++p)
+                s += A[i * k + p] * B[p * n + j];
+            C[i * n + j] = s;
+        }
+}
+
+/**
+ * @brief Banded matrix with lower bandwidth kl and upper bandwidth ku, stored with room for
+ * the kl extra superdiagonals that partial pivoting can fill in.
+ */
+struct BandedMatrix
+{
+    int n = 0, kl = 0, ku = 0, width = 0;
+    std::vector<double> data;
+
+    BandedMatrix(int size, int lower, int upper)
+        : n(size), kl(lower), ku(upper), width(2 * lower + upper + 1), data((size_t)size * (2 * lower + upper + 1), 0.0) {}
+
+    /** Entry (i, j); requires -kl <= j - i <= kl + ku. */
+    double &At(int i, int j) { return data[(size_t)i * width + (j - i + kl)]; }
+};
+
+/**
+ * @brief Solves A x = b in place for a banded A with partial pivoting (A is destroyed).
+ * Cost is O(n kl (kl + ku)) instead of O(n^3).
+ * @return False if the matrix is numerically singular.
+ */
+inline bool SolveBandedSystem(BandedMatrix &A, double *b)
+{
+    int n = A.n, kl = A.kl, reach = A.kl + A.ku;
+    for (int k = 0; k < n; ++k)
+    {
+        int last = std::min(n - 1, k + kl);
+        int pivot = k;
+        double best = std::fabs(A.At(k, k));
+        for (int i = k + 1; i <= last; ++i)
+        {
+            double v = std::fabs(A.At(i, k));
+            if (v > best)
+            {
+                best = v;
+                pivot = i;
+            }
+        }
+        if (best < 1e-300)
+            return false;
+
+        int lastCol = std::min(n - 1, k + reach);
+        if (pivot != k)
+        {
+            for (int j = k; j <= lastCol; ++j)
+                std::swap(A.At(k, j), A.At(pivot, j));
+            std::swap(b[k], b[pivot]);
+        }
+
+        double inv = 1.0 / A.At(k, k);
+        for (int i = k + 1; i <= last; ++i)
+        {
+            double f = A.At(i, k) * inv;
+            if (f == 0.0)
+                continue;
+            for (int j = k; j <= lastCol; ++j)
+                A.At(i, j) -= f * A.At(k, j);
+            b[i] -= f * b[k];
+        }
+    }
+
+    for (int i = n - 1; i >= 0; --i)
+    {
+        double s = b[i];
+        int lastCol = std::min(n - 1, i + reach);
+        for (int j = i + 1; j <= lastCol; ++j)
+            s -= A.At(i, j) * b[j];
+        b[i] = s / A.At(i, i);
+    }
+    return true;
+}
@@ -0,0 +1,124 @@
+#include "Catalog.h"
+#include "ManeuverSchedule.h"
+
+int ManeuverSchedule::Add(int objectId, double time, const Vector3d &deltaV)
+{
+    int handle = nextHandle++;
+    pending.emplace(time, ScheduledManeuver{handle, objectId, time, deltaV});
+    pendingCount[objectId]++;
+    return handle;
+}
+
+bool ManeuverSchedule::Cancel(int handle)
+{
+    for (auto it = pending.begin(); it != pending.end(); ++it)
+    {
+        if (it->second.handle == handle)
+        {
+            if (--pendingCount[it->second.objectId] == 0)
+                pendingCount.erase(it->second.objectId);
+            pending.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+int ManeuverSchedule::CancelObject(int objectId)
+{
+    int removed = 0;
+    for (auto it = pending.begin(); it != pending.end();)
+    {
+        if (it->second.objectId == objectId)
+        {
+            it = pending.erase(it);
+            ++removed;
+        }
+        else
+            ++it;
+    }
+    pendingCount.erase(objectId);
+    return removed;
+}
+
+int ManeuverSchedule::Execute(double time, std::vector<ScheduledManeuver> *executed)
+{
+    Catalog &catalog = GetCatalog();
+    int count = 0;
+    while (!pending.empty() && pending.begin()->first <= time)
+    {
+        ScheduledManeuver m = pending.begin()->second;
+        pending.erase(pending.begin());
+        if (--pendingCount[m.objectId] == 0)
+            pendingCount.erase(m.objectId);
+
+        int i = catalog.Find(m.objectId);
+        Vector3d r, v;
+        if (i < 0 || !catalog.StateAt(i, m.time, r, v))
+            continue;
+        catalog.Upsert(m.objectId, r, v + m.deltaV, m.time, catalog.radius[i]);
+        if (executed)
+            executed->push_back(m);
+        ++count;
+    }
+    return count;
+}
+
+void ManeuverSchedule::Clear()
+{
+    pending.clear();
+    pendingCount.clear();
+}
+
+ManeuverSchedule &GetManeuverSchedule()
+{
+    static ManeuverSchedule schedule;
+    return schedule;
+}
+
+/**
+ * @brief Queues an impulsive maneuver for a catalog object.
+ * @param id Object id.
+ * @param time Burn time (s).
+ * @param deltaV Impulse in the inertial frame (units/s).
+ * @return Handle of the maneuver.
+ */
+extern "C" __attribute__((visibility("default"))) int ManeuverScheduleAdd(int id, double time, double3 deltaV)
+{
+    return GetManeuverSchedule().Add(id, time, ToVector3dFromDouble3(deltaV));
+}
+
+/**
+ * @brief Cancels a queued maneuver.
+ * @return 1 if the maneuver was pending.
+ */
+extern "C" __attribute__((visibility("default"))) int ManeuverScheduleCancel(int handle)
+{
+    return GetManeuverSchedule().Cancel(handle) ? 1 : 0;
+}
+
+/**
+ * @brief Cancels every queued maneuver of an object.
+ * @return Number of maneuvers removed.
+ */
+extern "C" __attribute__((visibility("default"))) int ManeuverScheduleCancelObject(int id)
+{
+    return GetManeuverSchedule().CancelObject(id);
+}
+
+/**
+ * @brief Number of queued maneuvers (all objects).
+ */
+extern "C" __attribute__((visibility("default"))) int ManeuverSchedulePendingCount()
+{
+    return (int)GetManeuverSchedule().pending.size();
+}
+
+/**
+ * @brief Applies every maneuver due at or before the given time.
+ * @return Number of maneuvers applied.
+ */
+extern "C" __attribute__((visibility("default"))) int ManeuverScheduleExecute(double time)
+{
+    return GetManeuverSchedule().Execute(time);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file ManeuverSchedule.h
+ * @brief Time-ordered queue of impulsive maneuvers applied to catalog objects.
+ *
+ * A maneuver is executed by propagating the object's catalog state to the burn time, adding the
+ * impulse and re-epoching the entry there, so everything that reads the catalog afterwards
+ * (screening, controllers, rendering) sees the maneuvered orbit.
+ */
+
+struct ScheduledManeuver
+{
+    int handle;
+    int objectId;
+    double time;     ///< Burn time (s).
+    Vector3d deltaV; ///< Impulse in the inertial frame (units/s).
+};
+
+struct ManeuverSchedule
+{
+    std::multimap<double, ScheduledManeuver> pending; ///< Keyed by burn time.
+    std::unordered_map<int, int> pendingCount;       ///< Pending maneuvers per object id.
+    int nextHandle = 1;
+
+    /** Queues a maneuver; returns its handle. */
+    int Add(int objectId, double time, const Vector3d &deltaV);
+
+    /** Cancels one maneuver; returns false if the handle is not pending. */
+    bool Cancel(int handle);
+
+    /** Cancels every pending maneuver of an object; returns how many were removed. */
+    int CancelObject(int objectId);
+
+    /** Number of pending maneuvers of an object. */
+    int Pending(int objectId) const
+    {
+        auto it = pendingCount.find(objectId);
+        return it == pendingCount.end() ? 0 : it->second;
+    }
+
+    /**
+     * @brief Applies every maneuver due at or before time, in time order.
+     * Maneuvers of objects no longer in the catalog are dropped.
+     * @param executed Optional list receiving the maneuvers that were applied.
+     * @return Number of maneuvers applied.
+     */
+    int Execute(double time, std::vector<ScheduledManeuver> *executed = nullptr);
+
+    void Clear();
+};
+
+/** The plugin-wide maneuver schedule. */
+ManeuverSchedule &GetManeuverSchedule();
@@ -0,0 +1,265 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+#include "CR3BP.h"
+#include "EventDetection.h"
+#include "LinearAlgebra.h"
+#include "ThreadPool.h"
+
+/**
+ * @file Manifolds.cpp
+ * @brief Stable/unstable invariant manifolds of CR3BP periodic orbits and their Poincaré sections.
+ *
+ * The dominant eigenvector of the monodromy matrix (of its inverse for the stable manifold)
+ * is transported along the orbit with the STM to each seed point. Each seed is displaced
+ * along ± that direction and propagated (forward for unstable, backward for stable), and
+ * every crossing of the section plane is located on the step's Hermite dense output and
+ * then re-integrated exactly from the start of the step.
+ *
+ * Section file layout (little-endian):
+ *   header  : char magic[4] = "MSEC", uint32 version, uint32 recordCount, uint32 trajectoryCount,
+ *             double mu, int32 stable, int32 sectionAxis, double sectionValue
+ *   records : uint32 trajectory, uint16 crossing, uint16 branch, float time, float state[6]
+ * Trajectory k uses seed k / 2 on branch k % 2 (0 = +eigenvector, 1 = -eigenvector).
+ */
+
+const uint32_t MANIFOLD_FILE_VERSION = 1;
+const int MANIFOLD_POWER_ITERATIONS = 200;  ///< Power-iteration cap for the dominant eigenvector.
+const double MANIFOLD_EVENT_TIME_TOL = 1e-12;
+
+namespace
+{
+    struct SectionCrossing
+    {
+        uint32_t trajectory;
+        uint16_t crossing;
+        uint16_t branch;
+        float time;
+        float state[6];
+    };
+
+    /**
+     * @brief Dominant eigenvector of M (or of M⁻¹ when inverse is set) by power iteration.
+     * @return False if M is singular.
+     */
+    bool DominantEigenvector(const double *M, bool inverse, double *v)
+    {
+        for (int i = 0; i < 6; ++i)
+            v[i] = 1.0 / std::sqrt(6.0) * (i % 2 == 0 ? 1.0 : 0.5);
+
+        for (int iter = 0; iter < MANIFOLD_POWER_ITERATIONS; ++iter)
+        {
+            double w[6];
+            if (inverse)
+            {
+                double A[36];
+                std::copy(M, M + 36, A);
+                std::copy(v, v + 6, w);
+                if (!SolveLinearSystem(A, w, 6))
+                    return false;
+            }
+            else
+            {
+                MatMul(M, v, w, 6, 6, 1);
+            }
+
+            double n = 0.0;
+            for (double c : w)
+                n += c * c;
+            n = std::sqrt(n);
+            if (n == 0.0)
+                return false;
+
+            double change = 0.0;
+            for (int i = 0; i < 6; ++i)
+            {
+                w[i] /= n;
+                change = std::max(change, std::fabs(w[i] - v[i]));
+                v[i] = w[i];
+            }
+            if (change < 1e-13)
+                break;
+        }
+        return true;
+    }
+
+    double SectionValue(const double *x, int axis, double value) { return x[axis] - value; }
+
+    /** Whether a state lies inside either primary (radii in units of the primary separation). */
+    bool InsidePrimary(double mu, const double *x, double radius1, double radius2)
+    {
+        double r1 = std::sqrt((x[0] + mu) * (x[0] + mu) + x[1] * x[1] + x[2] * x[2]);
+        double r2 = std::sqrt((x[0] - 1.0 + mu) * (x[0] - 1.0 + mu) + x[1] * x[1] + x[2] * x[2]);
+        return r1 <= radius1 || r2 <= radius2;
+    }
+
+    /**
+     * @brief Propagates one manifold trajectory and records its section crossings.
+     * The trajectory stops when it enters a primary; crossings inside a primary are not recorded.
+     */
+    void TraceTrajectory(double mu, double *state, double maxTime, int axis, double value, int direction,
+                         int maxCrossings, double radius1, double radius2, uint32_t trajectory, uint16_t branch,
+                         std::vector<SectionCrossing> &out)
+    {
+        int crossings = 0;
+        Cr3bpPropagateObserved(mu, state, maxTime, [&](double ta, const double *xa, const double *dxa, double tb, const double *xb, const double *dxb)
+                               {
+            double ga = SectionValue(xa, axis, value);
+            double gb = SectionValue(xb, axis, value);
+            bool crossed = (ga < 0.0 && gb >= 0.0 && direction >= 0) || (ga > 0.0 && gb <= 0.0 && direction <= 0);
+            if (crossed)
+            {
+                // The section may involve a velocity component; interpolate position and velocity
+                // with separate Hermite cubics (velocity uses the acceleration as its derivative).
+                HermiteSegment pos{ta, tb, {xa[0], xa[1], xa[2]}, {dxa[0], dxa[1], dxa[2]}, {xb[0], xb[1], xb[2]}, {dxb[0], dxb[1], dxb[2]}};
+                HermiteSegment vel{ta, tb, {xa[3], xa[4], xa[5]}, {dxa[3], dxa[4], dxa[5]}, {xb[3], xb[4], xb[5]}, {dxb[3], dxb[4], dxb[5]}};
+                double tEvent = LocateEvent([&](double t)
+                                            {
+                    Vector3d p = pos.Position(t), v = vel.Position(t);
+                    double x[6] = {p.x, p.y, p.z, v.x, v.y, v.z};
+                    return SectionValue(x, axis, value); },
+                                            ta, tb, ga, gb, MANIFOLD_EVENT_TIME_TOL);
+
+                // Re-integrate from the start of the step so the recorded state is not interpolated.
+                double exact[6];
+                std::copy(xa, xa + 6, exact);
+                Cr3bpPropagateState(mu, exact, tEvent - ta, nullptr);
+                if (InsidePrimary(mu, exact, radius1, radius2))
+                    return false;
+
+                SectionCrossing c;
+                c.trajectory = trajectory;
+                c.crossing = (uint16_t)crossings;
+                c.branch = branch;
+                c.time = (float)tEvent;
+                for (int i = 0; i < 6; ++i)
+                    c.state[i] = (float)exact[i];
+                out.push_back(c);
+                if (++crossings >= maxCrossings)
+                    return false;
+            }
+
+            return !InsidePrimary(mu, xb, radius1, radius2); });
+    }
+
+    bool WriteSectionFile(const char *path, double mu, int stable, int axis, double value,
+                          uint32_t trajectoryCount, const std::vector<SectionCrossing> &records)
+    {
+        FILE *f = std::fopen(path, "wb");
+        if (!f)
+            return false;
+
+        uint32_t count = (uint32_t)records.size();
+        int32_t stable32 = stable, axis32 = axis;
+        bool ok = std::fwrite("MSEC", 1, 4, f) == 4 &&
+                  std::fwrite(&MANIFOLD_FILE_VERSION, sizeof(uint32_t), 1, f) == 1 &&
+                  std::fwrite(&count, sizeof(uint32_t), 1, f) == 1 &&
+                  std::fwrite(&trajectoryCount, sizeof(uint32_t), 1, f) == 1 &&
+                  std::fwrite(&mu, sizeof(double), 1, f) == 1 &&
+                  std::fwrite(&stable32, sizeof(int32_t), 1, f) == 1 &&
+                  std::fwrite(&axis32, sizeof(int32_t), 1, f) == 1 &&
+                  std::fwrite(&value, sizeof(double), 1, f) == 1;
+
+        for (size_t i = 0; ok && i < records.size(); ++i)
+        {
+            const SectionCrossing &r = records[i];
+            ok = std::fwrite(&r.trajectory, sizeof(uint32_t), 1, f) == 1 &&
+                 std::fwrite(&r.crossing, sizeof(uint16_t), 1, f) == 1 &&
+                 std::fwrite(&r.branch, sizeof(uint16_t), 1, f) == 1 &&
+                 std::fwrite(&r.time, sizeof(float), 1, f) == 1 &&
+                 std::fwrite(r.state, sizeof(float), 6, f) == 6;
+        }
+        return std::fclose(f) == 0 && ok;
+    }
+}
+
+/**
+ * @brief Generates the stable or unstable manifold of a periodic orbit and writes its Poincaré section.
+ *
+ * Seeds are spaced evenly in time along the orbit; both branches (±eigenvector) are
+ * propagated, so 2 * numSeeds trajectories are traced in parallel.
+ *
+ * @param mu Mass ratio.
+ * @param orbit Periodic orbit (see Cr3bpGenerateFamily / Cr3bpCorrectPeriodic).
+ * @param numSeeds Number of seed points along the orbit.
+ * @param stable 0 for the unstable manifold (forward time), 1 for the stable manifold (backward time).
+ * @param perturbation Position displacement along the eigenvector (nondimensional, e.g. 1e-4).
+ * @param maxTime Propagation time per trajectory (nondimensional, positive).
+ * @param sectionAxis State component defining the section plane (0-2 position, 3-5 velocity).
+ * @param sectionValue Section plane: state[sectionAxis] = sectionValue.
+ * @param crossingDirection +1 for increasing, -1 for decreasing (along the direction of propagation), 0 for both.
+ * @param maxCrossings Crossings recorded per trajectory before it is stopped.
+ * @param primaryRadius Radius of the larger primary in units of the separation (e.g. 0.0166 for Earth in Earth–Moon).
+ * @param secondaryRadius Radius of the smaller primary in units of the separation (e.g. 0.0045 for the Moon).
+ *        Trajectories entering either primary are stopped there; 0 treats a primary as a point mass.
+ * @param outputPath Section file to write.
+ * @return Number of crossings written, or -1 on failure.
+ */
+extern "C" __attribute__((visibility("default"))) int Cr3bpManifoldSection(
+    double mu,
+    const Cr3bpOrbit *orbit,
+    int numSeeds,
+    int stable,
+    double perturbation,
+    double maxTime,
+    int sectionAxis,
+    double sectionValue,
+    int crossingDirection,
+    int maxCrossings,
+    double primaryRadius,
+    double secondaryRadius,
+    const char *outputPath)
+{
+    if (numSeeds <= 0 || sectionAxis < 0 || sectionAxis > 5 || maxCrossings <= 0 || maxCrossings > 65535 ||
+        !(primaryRadius >= 0) || !(secondaryRadius >= 0))
+        return -1;
+
+    double M[36], eig[6];
+    Cr3bpMonodromy(mu, *orbit, M);
+    if (!DominantEigenvector(M, stable != 0, eig))
+    {
+        LogDebug("[Manifolds] Monodromy matrix is singular, no manifold generated.");
+        return -1;
+    }
+
+    double direction = stable ? -1.0 : 1.0;
+    int trajectories = 2 * numSeeds;
+    std::vector<std::vector<SectionCrossing>> perTrajectory(trajectories);
+
+    ParallelFor(trajectories, [&](int k)
+                {
+        int seed = k / 2;
+        double sign = (k % 2 == 0) ? 1.0 : -1.0;
+
+        double x[6] = {orbit->x0, 0.0, orbit->z0, 0.0, orbit->vy0, 0.0};
+        double phi[36];
+        double tSeed = orbit->period * seed / numSeeds;
+        if (!Cr3bpPropagateState(mu, x, tSeed, phi))
+            return;
+
+        // Transport the eigenvector to the seed and scale it by its position part.
+        double v[6];
+        MatMul(phi, eig, v, 6, 6, 1);
+        double posNorm = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+        if (posNorm == 0.0)
+            return;
+        for (int i = 0; i < 6; ++i)
+            x[i] += sign * perturbation / posNorm * v[i];
+
+        TraceTrajectory(mu, x, direction * maxTime, sectionAxis, sectionValue, crossingDirection,
+                        maxCrossings, primaryRadius, secondaryRadius, (uint32_t)k, (uint16_t)(k % 2), perTrajectory[k]); });
+
+    std::vector<SectionCrossing> records;
+    for (const auto &t : perTrajectory)
+        records.insert(records.end(), t.begin(), t.end());
+
+    if (!WriteSectionFile(outputPath, mu, stable, sectionAxis, sectionValue, (uint32_t)trajectories, records))
+    {
+        LogDebug(std::string("[Manifolds] Failed to write section file: ") + outputPath);
+        return -1;
+    }
+    return (int)records.size();
+}
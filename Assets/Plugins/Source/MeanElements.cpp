@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Catalog.h"
+#include "MeanElements.h"
+#include "ThreadPool.h"
+
+const int MEAN_ELEMENT_ITERATIONS = 10;   ///< Fixed-point refinements of the inverse map.
+const double MEAN_ELEMENT_TOLERANCE = 1e-13; ///< Convergence on the equinoctial variables.
+const double CRITICAL_GUARD = 1e-3;       ///< Smallest |1 - 5cos²i| used by the long-period terms.
+
+static double Wrap2Pi(double angle)
+{
+    angle = std::fmod(angle, 2 * M_PI);
+    return angle < 0 ? angle + 2 * M_PI : angle;
+}
+
+static double WrapPi(double angle)
+{
+    return std::remainder(angle, 2 * M_PI);
+}
+
+/** Solves Kepler's equation M = E - e sin E. */
+static double EccentricAnomaly(double M, double e)
+{
+    double E = e < 0.8 ? M : M_PI;
+    for (int iter = 0; iter < 50; ++iter)
+    {
+        double dE = (E - e * std::sin(E) - M) / (1 - e * std::cos(E));
+        E -= dE;
+        if (std::fabs(dE) < 1e-15)
+            break;
+    }
+    return E;
+}
+
+bool StateToElements(const Vector3d &r, const Vector3d &v, double mu, OrbitalElements &el)
+{
+    double rn = Norm(r);
+    Vector3d h = Cross(r, v);
+    double hn = Norm(h);
+    double energy = 0.5 * Dot(v, v) - mu / rn;
+    if (energy >= 0 || hn < 1e-12 * rn * Norm(v))
+        return false;
+
+    Vector3d eVec = Cross(v, h) * (1.0 / mu) - r * (1.0 / rn);
+    el.a = -mu / (2 * energy);
+    el.e = Norm(eVec);
+    el.i = std::acos(std::clamp(h.z / hn, -1.0, 1.0));
+
+    Vector3d node = Cross(Vector3d{0, 0, 1}, h);
+    double nn = Norm(node);
+    Vector3d nodeHat = nn > 1e-12 * hn ? node * (1.0 / nn) : Vector3d{1, 0, 0};
+    Vector3d hHat = h * (1.0 / hn);
+    Vector3d inPlane = Cross(hHat, nodeHat);
+    el.raan = Wrap2Pi(std::atan2(nodeHat.y, nodeHat.x));
+
+    // Argument of latitude, argument of perigee, then true -> eccentric -> mean anomaly.
+    double u = std::atan2(Dot(r, inPlane), Dot(r, nodeHat));
+    el.argp = el.e > 1e-12 ? Wrap2Pi(std::atan2(Dot(eVec, inPlane), Dot(eVec, nodeHat))) : 0.0;
+    double f = u - el.argp;
+    double E = 2 * std::atan2(std::sqrt(1 - el.e) * std::sin(f / 2), std::sqrt(1 + el.e) * std::cos(f / 2));
+    el.meanAnomaly = Wrap2Pi(E - el.e * std::sin(E));
+    return true;
+}
+
+void ElementsToState(const OrbitalElements &el, double mu, Vector3d &r, Vector3d &v)
+{
+    double E = EccentricAnomaly(el.meanAnomaly, el.e);
+    double eta = std::sqrt(1 - el.e * el.e);
+    double cosE = std::cos(E), sinE = std::sin(E);
+
+    // Perifocal position and velocity.
+    double xp = el.a * (cosE - el.e), yp = el.a * eta * sinE;
+    double rn = el.a * (1 - el.e * cosE);
+    double vScale = std::sqrt(mu * el.a) / rn;
+    double vxp = -vScale * sinE, vyp = vScale * eta * cosE;
+
+    double cO = std::cos(el.raan), sO = std::sin(el.raan);
+    double cw = std::cos(el.argp), sw = std::sin(el.argp);
+    double ci = std::cos(el.i), si = std::sin(el.i);
+    Vector3d P{cO * cw - sO * sw * ci, sO * cw + cO * sw * ci, sw * si};
+    Vector3d Q{-cO * sw - sO * cw * ci, -sO * sw + cO * cw * ci, cw * si};
+    r = P * xp + Q * yp;
+    v = P * vxp + Q * vyp;
+}
+
+/**
+ * @brief Brouwer–Lyddane short- and long-period J2 corrections.
+ * With gamma2 = +J2/2 (R/a)² the map takes mean to osculating elements; with the sign flipped
+ * it is the first-order inverse.
+ */
+static OrbitalElements BrouwerLyddane(const OrbitalElements &in, double gamma2)
+{
+    double a = in.a, e = in.e, i = in.i, raan = in.raan, w = in.argp, M = in.meanAnomaly;
+    double eta = std::sqrt(1 - e * e);
+    double eta2 = eta * eta, eta3 = eta2 * eta, eta6 = eta3 * eta3;
+    double g2p = gamma2 / (eta2 * eta2);
+
+    double E = EccentricAnomaly(M, e);
+    double f = 2 * std::atan2(std::sqrt(1 + e) * std::sin(E / 2), std::sqrt(1 - e) * std::cos(E / 2));
+    double cf = std::cos(f), sf = std::sin(f);
+    double ar = (1 + e * cf) / eta2; // a / r
+    double ar3 = ar * ar * ar;
+
+    double c = std::cos(i), c2 = c * c, c4 = c2 * c2, c6 = c4 * c2;
+    double s = std::sin(i);
+    double crit = 1 - 5 * c2;
+    if (std::fabs(crit) < CRITICAL_GUARD)
+        crit = std::copysign(CRITICAL_GUARD, crit);
+
+    double cos2w2f = std::cos(2 * w + 2 * f), sin2w2f = std::sin(2 * w + 2 * f);
+    double cos2wf = std::cos(2 * w + f), sin2wf = std::sin(2 * w + f);
+    double cos2w3f = std::cos(2 * w + 3 * f), sin2w3f = std::sin(2 * w + 3 * f);
+    double cos2w = std::cos(2 * w), sin2w = std::sin(2 * w);
+    double centre = f - M + e * sf; // equation of the centre plus e sin f
+
+    double aOut = a + a * gamma2 * ((3 * c2 - 1) * (ar3 - 1 / eta3) + 3 * (1 - c2) * ar3 * cos2w2f);
+
+    double de1 = g2p / 8 * e * eta2 * (1 - 11 * c2 - 40 * c4 / crit) * cos2w;
+    double de = de1 + eta2 / 2 * (gamma2 * ((3 * c2 - 1) / eta6 * (e * eta + e / (1 + eta) + 3 * cf + 3 * e * cf * cf + e * e * cf * cf * cf) + 3 * (1 - c2) / eta6 * (e + 3 * cf + 3 * e * cf * cf + e * e * cf * cf * cf) * cos2w2f) - g2p * (1 - c2) * (3 * cos2wf + cos2w3f));
+
+    double di = g2p / 2 * c * s * (3 * cos2w2f + 3 * e * cos2wf + e * cos2w3f);
+    if (s > 1e-6)
+        di -= e * de1 / (eta2 * std::tan(i));
+
+    double longitude = M + w + raan + g2p / 8 * eta3 * (1 - 11 * c2 - 40 * c4 / crit) * sin2w - g2p / 16 * (2 + e * e - 11 * (2 + 3 * e * e) * c2 - 40 * (2 + 5 * e * e) * c4 / crit - 400 * e * e * c6 / (crit * crit)) * sin2w + g2p / 4 * (-6 * (1 - 5 * c2) * centre + (3 - 5 * c2) * (3 * sin2w2f + 3 * e * sin2wf + e * sin2w3f)) - g2p / 8 * e * e * c * (11 + 80 * c2 / crit + 200 * c4 / (crit * crit)) * sin2w - g2p / 2 * c * (6 * centre - 3 * sin2w2f - 3 * e * sin2wf - e * sin2w3f);
+
+    double eDM = g2p / 8 * e * eta3 * (1 - 11 * c2 - 40 * c4 / crit) * sin2w - g2p / 4 * eta3 * (2 * (3 * c2 - 1) * (ar * ar * eta2 + ar + 1) * sf + 3 * (1 - c2) * ((-ar * ar * eta2 - ar + 1) * sin2wf + (ar * ar * eta2 + ar + 1.0 / 3) * sin2w3f));
+
+    double dRaan = -g2p / 8 * e * e * c * (11 + 80 * c2 / crit + 200 * c4 / (crit * crit)) * sin2w - g2p / 2 * c * (6 * centre - 3 * sin2w2f - 3 * e * sin2wf - e * sin2w3f);
+
+    // Lyddane's non-singular recombination.
+    double d1 = (e + de) * std::sin(M) + eDM * std::cos(M);
+    double d2 = (e + de) * std::cos(M) - eDM * std::sin(M);
+    double si2 = std::sin(i / 2), ci2 = std::cos(i / 2);
+    double d3 = (si2 + ci2 * di / 2) * std::sin(raan) + si2 * dRaan * std::cos(raan);
+    double d4 = (si2 + ci2 * di / 2) * std::cos(raan) - si2 * dRaan * std::sin(raan);
+
+    OrbitalElements out;
+    out.a = aOut;
+    out.e = std::sqrt(d1 * d1 + d2 * d2);
+    out.meanAnomaly = Wrap2Pi(std::atan2(d1, d2));
+    out.raan = Wrap2Pi(std::atan2(d3, d4));
+    out.i = 2 * std::asin(std::min(1.0, std::sqrt(d3 * d3 + d4 * d4)));
+    out.argp = Wrap2Pi(longitude - out.meanAnomaly - out.raan);
+    return out;
+}
+
+static double Gamma2(double a)
+{
+    return 0.5 * EARTH_J2 * (EARTH_RADIUS / a) * (EARTH_RADIUS / a);
+}
+
+OrbitalElements MeanToOsculating(const OrbitalElements &mean)
+{
+    return BrouwerLyddane(mean, Gamma2(mean.a));
+}
+
+/** Equinoctial variables (a, h, k, p, q, mean longitude), non-singular at e = 0 and i = 0. */
+static void ToEquinoctial(const OrbitalElements &el, double q[6])
+{
+    double lon = el.argp + el.raan;
+    double t = std::tan(el.i / 2);
+    q[0] = el.a;
+    q[1] = el.e * std::sin(lon);
+    q[2] = el.e * std::cos(lon);
+    q[3] = t * std::sin(el.raan);
+    q[4] = t * std::cos(el.raan);
+    q[5] = el.meanAnomaly + lon;
+}
+
+static OrbitalElements FromEquinoctial(const double q[6])
+{
+    OrbitalElements el;
+    el.a = q[0];
+    el.e = std::sqrt(q[1] * q[1] + q[2] * q[2]);
+    el.i = 2 * std::atan(std::sqrt(q[3] * q[3] + q[4] * q[4]));
+    el.raan = Wrap2Pi(std::atan2(q[3], q[4]));
+    double lon = std::atan2(q[1], q[2]);
+    el.argp = Wrap2Pi(lon - el.raan);
+    el.meanAnomaly = Wrap2Pi(q[5] - lon);
+    return el;
+}
+
+bool OsculatingToMean(const OrbitalElements &osc, OrbitalElements &mean)
+{
+    if (osc.a * (1 - osc.e) < EARTH_RADIUS || osc.e >= 0.9)
+        return false;
+
+    double target[6];
+    ToEquinoctial(osc, target);
+    mean = BrouwerLyddane(osc, -Gamma2(osc.a));
+
+    for (int iter = 0; iter < MEAN_ELEMENT_ITERATIONS; ++iter)
+    {
+        double x[6], y[6];
+        ToEquinoctial(mean, x);
+        ToEquinoctial(MeanToOsculating(mean), y);
+
+        double change = 0;
+        for (int k = 0; k < 6; ++k)
+        {
+            double d = target[k] - y[k];
+            if (k == 5)
+                d = WrapPi(d);
+            x[k] += d;
+            change = std::max(change, std::fabs(k == 0 ? d / osc.a : d));
+        }
+        if (!(x[0] > 0) || x[1] * x[1] + x[2] * x[2] >= 1)
+            return false;
+        mean = FromEquinoctial(x);
+        if (change < MEAN_ELEMENT_TOLERANCE)
+            break;
+    }
+    return std::isfinite(mean.a);
+}
+
+/**
+ * @brief Converts one osculating state to Brouwer–Lyddane mean elements.
+ * @param position Position relative to Earth (inertial, Z = rotation axis, sim units).
+ * @param velocity Velocity (units/s).
+ * @param mu Gravitational parameter (sim units).
+ * @param mean Output mean elements.
+ * @return 1 on success, 0 for unbound or sub-surface orbits.
+ */
+extern "C" __attribute__((visibility("default"))) int OsculatingToMeanSingle(double3 position, double3 velocity, double mu, OrbitalElements *mean)
+{
+    OrbitalElements osc;
+    if (!StateToElements(ToVector3dFromDouble3(position), ToVector3dFromDouble3(velocity), mu, osc))
+        return 0;
+    return OsculatingToMean(osc, *mean) ? 1 : 0;
+}
+
+/**
+ * @brief Converts a batch of osculating states to mean elements in parallel.
+ * @param positions Positions relative to Earth.
+ * @param velocities Velocities.
+ * @param count Number of states.
+ * @param mu Gravitational parameter (sim units).
+ * @param mean Output mean elements.
+ * @param ok Output success flags, or null.
+ * @return Number of states converted.
+ */
+extern "C" __attribute__((visibility("default"))) int OsculatingToMeanBatch(const double3 *positions, const double3 *velocities, int count,
+                                                                            double mu, OrbitalElements *mean, int *ok)
+{
+    std::vector<int> flags(count);
+    ParallelFor(count, [&](int k)
+    {
+        flags[k] = OsculatingToMeanSingle(positions[k], velocities[k], mu, &mean[k]);
+        if (ok)
+            ok[k] = flags[k];
+    });
+    int converted = 0;
+    for (int f : flags)
+        converted += f;
+    return converted;
+}
+
+/**
+ * @brief Converts a batch of mean elements to osculating states in parallel.
+ * @param mean Mean elements.
+ * @param count Number of element sets.
+ * @param mu Gravitational parameter (sim units).
+ * @param positions Output positions.
+ * @param velocities Output velocities.
+ */
+extern "C" __attribute__((visibility("default"))) void MeanToOsculatingBatch(const OrbitalElements *mean, int count, double mu,
+                                                                             double3 *positions, double3 *velocities)
+{
+    ParallelFor(count, [&](int k)
+    {
+        Vector3d r, v;
+        ElementsToState(MeanToOsculating(mean[k]), mu, r, v);
+        positions[k] = ToDouble3(r);
+        velocities[k] = ToDouble3(v);
+    });
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file MeanElements.h
+ * @brief Classical elements and Brouwer–Lyddane (J2) conversion between osculating and mean elements.
+ *
+ * Frames are inertial with Z along Earth's rotation axis; angles are radians and lengths sim units.
+ */
+
+extern "C"
+{
+    /**
+     * @struct OrbitalElements
+     * @brief Classical Keplerian elements; layout must match NativePhysics.OrbitalElements.
+     */
+    struct OrbitalElements
+    {
+        double a;           ///< Semi-major axis (units).
+        double e;           ///< Eccentricity.
+        double i;           ///< Inclination (rad).
+        double raan;        ///< Right ascension of the ascending node (rad).
+        double argp;        ///< Argument of perigee (rad).
+        double meanAnomaly; ///< Mean anomaly (rad).
+    };
+}
+
+/**
+ * @brief Classical elements of an elliptic state.
+ * The node is measured from +X for equatorial orbits and perigee from the node for circular ones.
+ * @return False for unbound or degenerate (rectilinear) states.
+ */
+bool StateToElements(const Vector3d &r, const Vector3d &v, double mu, OrbitalElements &el);
+
+/**
+ * @brief State from classical elements.
+ */
+void ElementsToState(const OrbitalElements &el, double mu, Vector3d &r, Vector3d &v);
+
+/**
+ * @brief Brouwer–Lyddane mean elements to osculating elements (first order in J2).
+ */
+OrbitalElements MeanToOsculating(const OrbitalElements &mean);
+
+/**
+ * @brief Osculating elements to Brouwer–Lyddane mean elements.
+ * Starts from the first-order inverse and refines by fixed-point iteration on MeanToOsculating
+ * in equinoctial variables, so the result is consistent with the forward map.
+ * @return False if the orbit is too low or eccentric for the theory, or the iteration diverged.
+ */
+bool OsculatingToMean(const OrbitalElements &osc, OrbitalElements &mean);
@@ -0,0 +1,536 @@
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+
+#include "Catalog.h"
+#include "EventDetection.h"
+#include "ManeuverSchedule.h"
+#include "MeanElements.h"
+#include "Mission.h"
+
+/**
+ * @file Mission.cpp
+ * @brief Mission engine: wake-up queue, event prediction and location, and the sequence script.
+ *
+ * When a script waits for an orbit event, the osculating elements at the current time give the
+ * time of the next occurrence:
+ * - apsides from the mean anomaly,
+ * - nodes from the argument of latitude,
+ * - altitude crossings by solving r = a(1 - e cos E).
+ * The wake-up is queued a little after that prediction. When it is due, the switching function
+ * (r·v, z or |r| - r_target) is sampled on the catalog state across a bracket around the
+ * prediction. The crossing in the required direction is then found with LocateEvent, so J2 and
+ * drag are included in the event time.
+ *
+ * The prediction is redone in two cases:
+ * - another system has changed the object's orbit in the meantime (its catalog revision moved);
+ * - no crossing lies in the bracket.
+ * An altitude below the perigee of a decaying orbit is re-checked once per revolution.
+ */
+
+const double MISSION_EVENT_BRACKET = 0.01; ///< Half-width of the event search bracket (fraction of a period).
+const double MISSION_EVENT_GAP = 0.02;     ///< Events closer than this after the current time are skipped (fraction of a period).
+const int MISSION_EVENT_SAMPLES = 8;       ///< Switching-function samples across a bracket.
+const double MISSION_EVENT_TOLERANCE = 1e-3; ///< Time tolerance of located events (s).
+const double MISSION_BURN_SEGMENT = 5.0;   ///< Finite burns are applied as one impulse per segment (s).
+
+enum MissionState
+{
+    MISSION_NONE = 0,
+    MISSION_WAITING = 1,
+    MISSION_FINISHED = 2,
+    MISSION_FAILED = 3,
+};
+
+extern "C"
+{
+    /**
+     * @struct MissionStatus
+     * @brief State of one object's script; layout must match NativePhysics.MissionStatus.
+     */
+    struct MissionStatus
+    {
+        int state;            ///< MissionState.
+        int step;             ///< Sequence step being executed.
+        int waitEvent;        ///< MissionEvent being waited for, -1 if none.
+        int burns;            ///< Impulses applied.
+        double nextEventTime; ///< Predicted time of the awaited event (s), NaN if none.
+        double lastEventTime; ///< Time the script was last resumed (s).
+        double totalDeltaV;   ///< Sum of applied impulses (units/s).
+    };
+}
+
+namespace
+{
+    struct Mission
+    {
+        MissionContext context;
+        MissionTask task;
+        int state = MISSION_NONE;
+        uint64_t revision = 0; ///< Catalog revision the prediction was made from.
+    };
+
+    struct Wake
+    {
+        double time;
+        int objectId;
+        uint64_t generation;
+
+        bool operator>(const Wake &o) const { return time != o.time ? time > o.time : objectId > o.objectId; }
+    };
+
+    struct MissionEngine
+    {
+        std::unordered_map<int, std::unique_ptr<Mission>> missions;
+        std::priority_queue<Wake, std::vector<Wake>, std::greater<Wake>> wakes;
+        uint64_t generation = 0; ///< Tags wake-ups, so superseded ones (re-predicted, cancelled, replaced) are skipped.
+    };
+
+    MissionEngine &GetMissionEngine()
+    {
+        static MissionEngine engine;
+        return engine;
+    }
+
+    Mission *MissionOf(const MissionContext &m)
+    {
+        auto &missions = GetMissionEngine().missions;
+        auto it = missions.find(m.objectId);
+        return it == missions.end() ? nullptr : it->second.get();
+    }
+
+    double Period(const OrbitalElements &el, double mu)
+    {
+        return 2 * M_PI * std::sqrt(el.a * el.a * el.a / mu);
+    }
+
+    double TrueToMean(double nu, double e)
+    {
+        double E = 2 * std::atan(std::sqrt((1 - e) / (1 + e)) * std::tan(nu / 2));
+        return E - e * std::sin(E);
+    }
+
+    /** Switching function whose sign change marks an event. */
+    double Switching(int event, double radius, const Vector3d &r, const Vector3d &v)
+    {
+        switch (event)
+        {
+        case MISSION_EVENT_APOAPSIS:
+        case MISSION_EVENT_PERIAPSIS:
+            return Dot(r, v);
+        case MISSION_EVENT_ASCENDING_NODE:
+        case MISSION_EVENT_DESCENDING_NODE:
+            return r.z;
+        default:
+            return Norm(r) - radius;
+        }
+    }
+
+    /** Direction of the sign change that marks an event: +1 rising, -1 falling, 0 either. */
+    int Crossing(int event, int direction)
+    {
+        switch (event)
+        {
+        case MISSION_EVENT_APOAPSIS:
+        case MISSION_EVENT_DESCENDING_NODE:
+            return -1;
+        case MISSION_EVENT_PERIAPSIS:
+        case MISSION_EVENT_ASCENDING_NODE:
+            return 1;
+        default:
+            return direction == 1 ? 1 : direction == 2 ? -1 : 0;
+        }
+    }
+
+    /**
+     * Predicts the next occurrence after from of the context's awaited event. Returns the wake
+     * time, or NaN if the event cannot occur. Sets m.predicted; for an altitude that drag may
+     * still bring into reach, the wake is a re-check one period later with m.predicted NaN.
+     */
+    double Predict(MissionContext &m, double from)
+    {
+        m.predicted = NAN;
+        if (m.waitEvent == MISSION_EVENT_TIME)
+        {
+            m.predicted = std::max(m.waitValue, from);
+            return m.predicted;
+        }
+
+        const Catalog &catalog = GetCatalog();
+        int i = catalog.Find(m.objectId);
+        Vector3d r, v;
+        OrbitalElements el;
+        if (i < 0 || !catalog.StateAt(i, from, r, v) || !StateToElements(r, v, catalog.mu, el) || el.e >= 1 || el.a <= 0)
+            return NAN;
+        double period = Period(el, catalog.mu), n = 2 * M_PI / period;
+
+        std::vector<double> targets; // Mean anomalies at which the event occurs.
+        switch (m.waitEvent)
+        {
+        case MISSION_EVENT_APOAPSIS:
+            targets.push_back(M_PI);
+            break;
+        case MISSION_EVENT_PERIAPSIS:
+            targets.push_back(0);
+            break;
+        case MISSION_EVENT_ASCENDING_NODE:
+        case MISSION_EVENT_DESCENDING_NODE:
+            if (std::sin(el.i) < 1e-6)
+                return NAN;
+            targets.push_back(TrueToMean((m.waitEvent == MISSION_EVENT_ASCENDING_NODE ? 0 : M_PI) - el.argp, el.e));
+            break;
+        case MISSION_EVENT_ALTITUDE:
+        {
+            double rp = el.a * (1 - el.e), ra = el.a * (1 + el.e);
+            if (m.waitValue < rp || m.waitValue > ra || el.e < 1e-9)
+            {
+                // A decaying orbit may still come down to the altitude: look again in one revolution.
+                if (m.waitValue < rp && m.waitDirection != 1 && catalog.ballistic[i] > 0)
+                    return from + period;
+                return NAN;
+            }
+            double E = std::acos(std::clamp((1 - m.waitValue / el.a) / el.e, -1.0, 1.0));
+            if (m.waitDirection != 2)
+                targets.push_back(E - el.e * std::sin(E));
+            if (m.waitDirection != 1)
+                targets.push_back(-E + el.e * std::sin(E));
+            break;
+        }
+        default:
+            return NAN;
+        }
+
+        double best = INFINITY;
+        for (double target : targets)
+        {
+            double dt = std::fmod(target - el.meanAnomaly, 2 * M_PI);
+            dt = (dt < 0 ? dt + 2 * M_PI : dt) / n;
+            if (dt < MISSION_EVENT_GAP * period)
+                dt += period;
+            best = std::min(best, dt);
+        }
+        m.predicted = from + best;
+        return m.predicted + MISSION_EVENT_BRACKET * period;
+    }
+
+    /** Registers the context's wait with the engine; false if the event cannot occur. */
+    bool Schedule(MissionContext &m, double from)
+    {
+        MissionEngine &engine = GetMissionEngine();
+        Mission *mission = MissionOf(m);
+        const Catalog &catalog = GetCatalog();
+        int i = catalog.Find(m.objectId);
+        if (!mission || i < 0)
+            return false;
+        m.waitFrom = from;
+        mission->revision = catalog.revision[i];
+        double wake = Predict(m, from);
+        if (std::isnan(wake))
+            return false;
+        m.generation = ++engine.generation;
+        engine.wakes.push({wake, m.objectId, m.generation});
+        return true;
+    }
+
+    /**
+     * Locates the awaited orbit event in the bracket around the prediction.
+     * @return The event time, or NaN if there is no crossing in the bracket.
+     */
+    double Locate(const MissionContext &m, double wake)
+    {
+        const Catalog &catalog = GetCatalog();
+        int i = catalog.Find(m.objectId);
+        if (i < 0)
+            return NAN;
+        double width = wake - m.predicted;
+        double ta = std::max(m.predicted - width, m.waitFrom + width), tb = wake;
+        if (tb <= ta)
+            return NAN;
+        int sign = Crossing(m.waitEvent, m.waitDirection);
+        auto g = [&](double t)
+        {
+            Vector3d r, v;
+            catalog.StateAt(i, t, r, v);
+            return Switching(m.waitEvent, m.waitValue, r, v);
+        };
+
+        double t0 = ta, g0 = g(ta);
+        for (int k = 1; k <= MISSION_EVENT_SAMPLES; ++k)
+        {
+            double t1 = ta + (tb - ta) * k / MISSION_EVENT_SAMPLES, g1 = g(t1);
+            bool crossed = sign > 0 ? g0 < 0 && g1 >= 0 : sign < 0 ? g0 > 0 && g1 <= 0 : (g0 < 0) != (g1 < 0);
+            if (crossed)
+                return LocateEvent(g, t0, t1, g0, g1, MISSION_EVENT_TOLERANCE);
+            t0 = t1;
+            g0 = g1;
+        }
+        return NAN;
+    }
+
+    /** Resumes a script at an event; marks the mission done when the script returns. */
+    void Resume(Mission &mission, double time, bool occurred)
+    {
+        MissionContext &m = mission.context;
+        m.time = time;
+        m.occurred = occurred;
+        m.waitEvent = -1;
+        m.predicted = NAN;
+        mission.state = MISSION_WAITING;
+        mission.task.handle.resume();
+        if (mission.task.handle.done())
+        {
+            mission.state = m.failed ? MISSION_FAILED : MISSION_FINISHED;
+            mission.task = MissionTask();
+        }
+    }
+}
+
+bool MissionAwait::await_suspend(std::coroutine_handle<>) const
+{
+    MissionContext &m = *context;
+    m.waitEvent = event;
+    m.waitValue = value;
+    m.waitDirection = direction;
+    m.occurred = Schedule(m, m.time);
+    if (!m.occurred)
+        m.waitEvent = -1;
+    return m.occurred;
+}
+
+bool MissionAwait::await_resume() const
+{
+    return context->occurred;
+}
+
+MissionAwait MissionContext::Altitude(double km, int direction)
+{
+    return {this, MISSION_EVENT_ALTITUDE, (EARTH_RADIUS_KM + km) / UNIT_TO_KM, direction};
+}
+
+MissionAwait MissionContext::Orbits(double revolutions)
+{
+    Vector3d r, v;
+    OrbitalElements el;
+    const Catalog &catalog = GetCatalog();
+    if (!State(r, v) || !StateToElements(r, v, catalog.mu, el) || el.e >= 1)
+        return {this, MISSION_EVENT_TIME, NAN, 0};
+    return Wait(revolutions * Period(el, catalog.mu));
+}
+
+bool MissionContext::State(Vector3d &r, Vector3d &v) const
+{
+    const Catalog &catalog = GetCatalog();
+    int i = catalog.Find(objectId);
+    return i >= 0 && catalog.StateAt(i, time, r, v);
+}
+
+bool MissionContext::ImpulseInertial(const Vector3d &deltaV)
+{
+    if (GetCatalog().Find(objectId) < 0)
+        return false;
+    ManeuverSchedule &schedule = GetManeuverSchedule();
+    schedule.Add(objectId, time, deltaV);
+    schedule.Execute(time);
+    burns++;
+    totalDeltaV += Norm(deltaV);
+    return true;
+}
+
+bool MissionContext::Impulse(const Vector3d &local)
+{
+    Vector3d r, v;
+    if (!State(r, v))
+        return false;
+    Vector3d prograde = v * (1.0 / Norm(v));
+    Vector3d normal = Cross(r, v);
+    normal = normal * (1.0 / Norm(normal));
+    Vector3d radial = Cross(prograde, normal);
+    return ImpulseInertial(local.x * prograde + local.y * normal + local.z * radial);
+}
+
+bool MissionContext::Circularize()
+{
+    Vector3d r, v;
+    if (!State(r, v))
+        return false;
+    Vector3d normal = Cross(r, v);
+    normal = normal * (1.0 / Norm(normal));
+    double radius = Norm(r);
+    Vector3d along = Cross(normal, r * (1.0 / radius));
+    return ImpulseInertial(std::sqrt(GetCatalog().mu / radius) * along - v);
+}
+
+bool MissionStart(int objectId, double time, MissionTask (*script)(MissionContext &), std::vector<MissionStep> steps)
+{
+    if (GetCatalog().Find(objectId) < 0)
+        return false;
+    auto &slot = GetMissionEngine().missions[objectId];
+    slot = std::make_unique<Mission>();
+    slot->context.objectId = objectId;
+    slot->context.time = time;
+    slot->context.steps = std::move(steps);
+    slot->task = script(slot->context);
+    Resume(*slot, time, true);
+    return true;
+}
+
+MissionTask MissionRunSequence(MissionContext &m)
+{
+    for (m.step = 0; m.step < (int)m.steps.size(); ++m.step)
+    {
+        const MissionStep &s = m.steps[m.step];
+        Vector3d vector = ToVector3dFromDouble3(s.vector);
+        bool ok = true;
+        switch (s.op)
+        {
+        case MISSION_OP_WAIT:
+            ok = co_await m.Wait(s.value);
+            break;
+        case MISSION_OP_WAIT_UNTIL:
+            ok = co_await m.Until(s.value);
+            break;
+        case MISSION_OP_WAIT_ORBITS:
+            ok = co_await m.Orbits(s.value);
+            break;
+        case MISSION_OP_WAIT_EVENT:
+            if (s.event == MISSION_EVENT_ALTITUDE)
+                ok = co_await m.Altitude(s.value, s.direction);
+            else if (s.event == MISSION_EVENT_TIME)
+                ok = co_await m.Until(s.value);
+            else
+                ok = co_await MissionAwait{&m, s.event, 0, 0};
+            break;
+        case MISSION_OP_IMPULSE:
+            ok = m.Impulse(vector);
+            break;
+        case MISSION_OP_BURN:
+        {
+            // One impulse at the middle of each segment, along the local frame at that time.
+            int segments = std::max(1, (int)std::ceil(s.value / MISSION_BURN_SEGMENT));
+            double dt = s.value / segments;
+            for (int k = 0; ok && k < segments; ++k)
+            {
+                ok = co_await m.Wait(dt / 2) && m.Impulse(vector * dt);
+                if (ok)
+                    ok = co_await m.Wait(dt / 2);
+            }
+            break;
+        }
+        case MISSION_OP_CIRCULARIZE:
+            ok = m.Circularize();
+            break;
+        default:
+            ok = false;
+        }
+        if (!ok)
+        {
+            m.failed = true;
+            co_return;
+        }
+    }
+}
+
+/**
+ * @brief Starts a mission sequence on a catalog object, replacing any running script.
+ * The sequence runs immediately up to its first wait.
+ * @param id Object id.
+ * @param steps Sequence steps.
+ * @param count Number of steps.
+ * @param time Current simulation time (s).
+ * @return 1 if started, 0 if the object is not in the catalog, -1 for invalid input.
+ */
+extern "C" __attribute__((visibility("default"))) int MissionLoadSequence(int id, const MissionStep *steps, int count, double time)
+{
+    if (!steps || count <= 0)
+        return -1;
+    return MissionStart(id, time, MissionRunSequence, std::vector<MissionStep>(steps, steps + count)) ? 1 : 0;
+}
+
+/**
+ * @brief Stops an object's script. Impulses already applied stay applied.
+ * @return 1 if the object had a script.
+ */
+extern "C" __attribute__((visibility("default"))) int MissionCancel(int id)
+{
+    return GetMissionEngine().missions.erase(id) > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Resumes every script whose awaited event has occurred by the given time, in event order.
+ * Scripts may wait again within the same call, so several events of one script can be handled
+ * in a single large step.
+ * @param time Simulation time (s).
+ * @return Number of events delivered to scripts.
+ */
+extern "C" __attribute__((visibility("default"))) int MissionUpdate(double time)
+{
+    MissionEngine &engine = GetMissionEngine();
+    const Catalog &catalog = GetCatalog();
+    int delivered = 0;
+    while (!engine.wakes.empty() && engine.wakes.top().time <= time)
+    {
+        Wake wake = engine.wakes.top();
+        engine.wakes.pop();
+        auto it = engine.missions.find(wake.objectId);
+        if (it == engine.missions.end() || !it->second->task.handle || it->second->context.generation != wake.generation)
+            continue;
+        Mission &mission = *it->second;
+        MissionContext &m = mission.context;
+
+        int i = catalog.Find(m.objectId);
+        if (i < 0)
+        {
+            Resume(mission, wake.time, false);
+            ++delivered;
+            continue;
+        }
+        if (m.waitEvent == MISSION_EVENT_TIME)
+        {
+            Resume(mission, m.predicted, true);
+            ++delivered;
+            continue;
+        }
+
+        // Predict again if the orbit was changed since, or after a re-check of an unreachable altitude.
+        // A changed orbit only holds from its new epoch, so the search cannot start before that.
+        bool changed = catalog.revision[i] != mission.revision;
+        double eventTime = changed || std::isnan(m.predicted) ? NAN : Locate(m, wake.time);
+        if (std::isnan(eventTime))
+        {
+            if (!Schedule(m, changed ? std::max(m.waitFrom, catalog.epoch[i]) : wake.time))
+            {
+                Resume(mission, wake.time, false);
+                ++delivered;
+            }
+            continue;
+        }
+        Resume(mission, eventTime, true);
+        ++delivered;
+    }
+    return delivered;
+}
+
+/**
+ * @brief Reads the script state of an object.
+ * @return 1 if the object has or had a script.
+ */
+extern "C" __attribute__((visibility("default"))) int MissionGetStatus(int id, MissionStatus *status)
+{
+    auto &missions = GetMissionEngine().missions;
+    auto it = missions.find(id);
+    if (it == missions.end())
+        return 0;
+    const Mission &mission = *it->second;
+    const MissionContext &m = mission.context;
+    status->state = mission.state;
+    status->step = m.step;
+    status->waitEvent = m.waitEvent;
+    status->burns = m.burns;
+    status->nextEventTime = m.predicted;
+    status->lastEventTime = m.time;
+    status->totalDeltaV = m.totalDeltaV;
+    return 1;
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include <vector>
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file Mission.h
+ * @brief Per-satellite mission scripts written as C++20 coroutines that co_await simulation events.
+ *
+ * A script is a coroutine taking the MissionContext of its catalog object, e.g.
+ *
+ *     MissionTask RaiseApogee(MissionContext &m)
+ *     {
+ *         if (!co_await m.Apoapsis())
+ *             co_return;
+ *         m.Impulse({0.01, 0, 0});
+ *         co_await m.Orbits(2);
+ *         co_await m.Apoapsis();
+ *         m.Circularize();
+ *     }
+ *
+ * Each co_await registers a single wake-up with the mission engine and suspends. The engine
+ * predicts the event time from the object's orbit and keeps suspended scripts in a queue ordered
+ * by that time. MissionUpdate pops only the wake-ups that are due, locates the event on the
+ * catalog state and resumes the script at that time. Idle scripts cost nothing per frame.
+ * Impulses go through the maneuver schedule, so everything downstream sees the new orbit.
+ */
+
+extern "C"
+{
+    /**
+     * @struct MissionStep
+     * @brief One step of a data-driven mission sequence; layout must match NativePhysics.MissionStep.
+     */
+    struct MissionStep
+    {
+        int op;        ///< MissionOp.
+        int event;     ///< MISSION_OP_WAIT_EVENT: MissionEvent.
+        int direction; ///< MISSION_EVENT_ALTITUDE: 1 rising, 2 falling, 3 either.
+        int reserved;
+        double value;  ///< Seconds, absolute time, revolutions, altitude (km) or burn duration (s), by op.
+        double3 vector; ///< Impulse (units/s) or acceleration (units/s²) as (prograde, normal, radial-out).
+    };
+}
+
+enum MissionOp
+{
+    MISSION_OP_WAIT = 0,        ///< Wait value seconds.
+    MISSION_OP_WAIT_UNTIL = 1,  ///< Wait until the absolute time value.
+    MISSION_OP_WAIT_ORBITS = 2, ///< Wait value revolutions of the current orbit.
+    MISSION_OP_WAIT_EVENT = 3,  ///< Wait for the next event of the given kind.
+    MISSION_OP_IMPULSE = 4,     ///< Apply vector as an impulse.
+    MISSION_OP_BURN = 5,        ///< Thrust at vector (acceleration) for value seconds.
+    MISSION_OP_CIRCULARIZE = 6, ///< Impulse to a circular orbit at the current radius.
+};
+
+enum MissionEvent
+{
+    MISSION_EVENT_TIME = 0,
+    MISSION_EVENT_APOAPSIS = 1,
+    MISSION_EVENT_PERIAPSIS = 2,
+    MISSION_EVENT_ASCENDING_NODE = 3,
+    MISSION_EVENT_DESCENDING_NODE = 4,
+    MISSION_EVENT_ALTITUDE = 5,
+};
+
+struct MissionContext;
+
+/** Coroutine type of a mission script. The engine owns the frame and resumes it. */
+struct MissionTask
+{
+    struct promise_type
+    {
+        MissionTask get_return_object() { return MissionTask{std::coroutine_handle<promise_type>::from_promise(*this)}; }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    std::coroutine_handle<promise_type> handle;
+
+    MissionTask() = default;
+    explicit MissionTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    MissionTask(MissionTask &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+    MissionTask &operator=(MissionTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    MissionTask(const MissionTask &) = delete;
+    MissionTask &operator=(const MissionTask &) = delete;
+    ~MissionTask()
+    {
+        if (handle)
+            handle.destroy();
+    }
+};
+
+/**
+ * @brief Awaitable that suspends a script until an event.
+ * co_await yields true when the event occurred, or false if it cannot occur. That happens for
+ * a node of an equatorial orbit, an altitude outside the orbit, or an object that left the catalog.
+ */
+struct MissionAwait
+{
+    MissionContext *context;
+    int event;
+    double value; ///< Absolute time for MISSION_EVENT_TIME, radius (units) for MISSION_EVENT_ALTITUDE.
+    int direction;
+
+    bool await_ready() const noexcept { return false; }
+    bool await_suspend(std::coroutine_handle<>) const;
+    bool await_resume() const;
+};
+
+/**
+ * @struct MissionContext
+ * @brief What a script sees of its object, and the engine's bookkeeping for it.
+ */
+struct MissionContext
+{
+    int objectId = 0;
+    double time = 0; ///< Time of the event that last resumed the script (s).
+    std::vector<MissionStep> steps; ///< Sequence run by MissionRunSequence.
+    int step = 0;                   ///< Step being executed, for status reporting.
+    bool failed = false;            ///< Set by a script that gives up.
+
+    // Engine state.
+    int waitEvent = -1;
+    double waitValue = 0;
+    int waitDirection = 0;
+    double waitFrom = 0;    ///< Time the wait was registered or last re-predicted (s).
+    double predicted = NAN; ///< Predicted event time (s).
+    uint64_t generation = 0;
+    bool occurred = false;
+    int burns = 0;
+    double totalDeltaV = 0;
+
+    MissionAwait Wait(double seconds) { return {this, MISSION_EVENT_TIME, time + seconds, 0}; }
+    MissionAwait Until(double t) { return {this, MISSION_EVENT_TIME, t, 0}; }
+    MissionAwait Apoapsis() { return {this, MISSION_EVENT_APOAPSIS, 0, 0}; }
+    MissionAwait Periapsis() { return {this, MISSION_EVENT_PERIAPSIS, 0, 0}; }
+    MissionAwait AscendingNode() { return {this, MISSION_EVENT_ASCENDING_NODE, 0, 0}; }
+    MissionAwait DescendingNode() { return {this, MISSION_EVENT_DESCENDING_NODE, 0, 0}; }
+
+    /** Crossing of an altitude above the spherical Earth; direction 1 rising, 2 falling, 3 either. */
+    MissionAwait Altitude(double km, int direction = 3);
+
+    /** Waits a number of revolutions of the orbit at the current time. */
+    MissionAwait Orbits(double revolutions);
+
+    /** Catalog state at the current time; false if the object is gone. */
+    bool State(Vector3d &r, Vector3d &v) const;
+
+    /** Applies an impulse now, given as (prograde, normal, radial-out) components (units/s). */
+    bool Impulse(const Vector3d &local);
+
+    /** Applies an impulse now, in the inertial frame (units/s). */
+    bool ImpulseInertial(const Vector3d &deltaV);
+
+    /** Applies the impulse that makes the orbit circular at the current radius. */
+    bool Circularize();
+};
+
+/**
+ * @brief Starts a script on a catalog object, replacing any script it already runs.
+ * The script runs immediately up to its first co_await.
+ * @return false if the object is not in the catalog.
+ */
+bool MissionStart(int objectId, double time, MissionTask (*script)(MissionContext &),
+                  std::vector<MissionStep> steps = {});
+
+/** Script that runs the context's MissionStep sequence. */
+MissionTask MissionRunSequence(MissionContext &m);
@@ -0,0 +1,249 @@
+#include <cmath>
+#include <algorithm>
+
+#include "Budget.h"
+#include "PhysicsCommon.h"
+#include "EventDetection.h"
+
+/**
+ * @file PatchedConic.cpp
+ * @brief Sphere-of-influence aware propagation with automatic switching of the integration origin.
+ *
+ * The body is integrated relative to its current primary. Every other body acts as a
+ * perturbation (direct term) and the primary's own acceleration is removed (indirect
+ * term), so near the Moon the integration is Moon-relative with Earth as a perturbation.
+ * Sphere-of-influence boundaries are switching functions; when one is crossed inside a
+ * step the crossing is located on the Hermite dense output, the step is split there and
+ * the remainder is integrated about the new primary.
+ *
+ * bodies[0] is the fixed central body (Earth): it has no sphere-of-influence boundary and,
+ * as elsewhere in the simulation, does not accelerate.
+ */
+
+const double SOI_EXPONENT = 0.4;          ///< Laplace sphere of influence: r = a (m / M)^(2/5).
+const double SOI_EVENT_TIME_TOL = 1e-9;   ///< Time tolerance when locating a boundary crossing (s).
+
+namespace
+{
+    /** Snapshot of the massive bodies at the start of a step; bodies move linearly within it. */
+    struct BodySet
+    {
+        const Vector3d *positions;
+        const Vector3d *velocities;
+        const double *masses;
+        int count;
+
+        Vector3d PositionAt(int i, double t) const { return positions[i] + t * velocities[i]; }
+    };
+
+    /** Sphere-of-influence radius of body i about the central body (infinite for the central body). */
+    double SoiRadius(const BodySet &b, int i)
+    {
+        if (i == 0)
+            return HUGE_VAL;
+        double d = Norm(b.positions[i] - b.positions[0]);
+        return d * std::pow(b.masses[i] / b.masses[0], SOI_EXPONENT);
+    }
+
+    /** Gravitational acceleration of body j due to all other massive bodies at time t. */
+    Vector3d BodyAcceleration(const BodySet &b, int j, double t)
+    {
+        if (j == 0)
+            return {0, 0, 0};
+
+        Vector3d a{0, 0, 0};
+        Vector3d pj = b.PositionAt(j, t);
+        for (int k = 0; k < b.count; k++)
+        {
+            if (k == j)
+                continue;
+            Vector3d d = b.PositionAt(k, t) - pj;
+            double r2 = Dot(d, d);
+            if (r2 < minDistSq)
+                continue;
+            a += (G * b.masses[k] / (r2 * std::sqrt(r2))) * d;
+        }
+        return a;
+    }
+
+    /**
+     * @brief Acceleration of the propagated body relative to the primary.
+     * @param rel Position relative to the primary.
+     * @param t Time since the start of the step.
+     */
+    Vector3d RelativeAcceleration(const BodySet &b, int primary, const Vector3d &rel, double t, const Vector3d &thrustAcc)
+    {
+        Vector3d pp = b.PositionAt(primary, t);
+        Vector3d absPos = pp + rel;
+
+        double r2 = Dot(rel, rel);
+        Vector3d a = (-G * b.masses[primary] / (r2 * std::sqrt(r2))) * rel;
+
+        for (int k = 0; k < b.count; k++)
+        {
+            if (k == primary)
+                continue;
+            Vector3d d = b.PositionAt(k, t) - absPos;
+            double d2 = Dot(d, d);
+            if (d2 < minDistSq)
+                continue;
+            a += (G * b.masses[k] / (d2 * std::sqrt(d2))) * d;
+        }
+
+        return a - BodyAcceleration(b, primary, t) + thrustAcc;
+    }
+
+    /**
+     * @brief Selects the primary whose sphere of influence contains the absolute position.
+     * The smallest enclosing sphere wins; the central body is the fallback.
+     */
+    int SelectPrimary(const BodySet &b, const Vector3d &absPos)
+    {
+        int best = 0;
+        double bestRadius = HUGE_VAL;
+        for (int i = 1; i < b.count; i++)
+        {
+            double soi = SoiRadius(b, i);
+            if (Norm(absPos - b.positions[i]) < soi && soi < bestRadius)
+            {
+                best = i;
+                bestRadius = soi;
+            }
+        }
+        return best;
+    }
+
+    /**
+     * @brief Switching function for the current primary at time t.
+     * Negative means the transition condition has been met: the body has left the
+     * primary's sphere (primary != 0) or entered a secondary's sphere (primary == 0).
+     * @param target Output index of the body the switch leads to.
+     */
+    double SoiSwitch(const BodySet &b, int primary, const Vector3d &absPos, double t, int &target)
+    {
+        if (primary != 0)
+        {
+            target = 0;
+            return SoiRadius(b, primary) - Norm(absPos - b.PositionAt(primary, t));
+        }
+
+        double g = HUGE_VAL;
+        target = 0;
+        for (int i = 1; i < b.count; i++)
+        {
+            double gi = Norm(absPos - b.PositionAt(i, t)) - SoiRadius(b, i);
+            if (gi < g)
+            {
+                g = gi;
+                target = i;
+            }
+        }
+        return g;
+    }
+
+    /** Integrates the relative state about the given primary over [t0, t0 + dt]. */
+    void StepAbout(const BodySet &b, int primary, Vector3d &rel, Vector3d &relVel, double t0, double dt, const Vector3d &thrustAcc)
+    {
+        DormandPrinceStepFn(rel, relVel, dt, [&](double tau, const Vector3d &p, const Vector3d &)
+                            { return RelativeAcceleration(b, primary, p, t0 + tau, thrustAcc); });
+    }
+}
+
+/**
+ * @brief Public C-callable patched-conic propagation step.
+ * Integrates relative to the current primary and switches primary at sphere-of-influence
+ * boundaries. At most one switch is performed per call.
+ *
+ * @param position Pointer to absolute position vector (in/out).
+ * @param velocity Pointer to absolute velocity vector (in/out).
+ * @param primaryIndex Pointer to the index of the current primary (in/out). Negative values
+ *                     request automatic selection from the current position.
+ * @param mass Mass of the object.
+ * @param bodies Array of massive body positions (double), central body first.
+ * @param bodyVelocities Array of massive body velocities.
+ * @param masses Array of massive body masses.
+ * @param numBodies Number of massive bodies.
+ * @param dt Timestep in seconds.
+ * @param thrustImpulse Impulse applied (force * dt).
+ * @return 1 if the primary changed during this step, 0 otherwise.
+ */
+extern "C" __attribute__((visibility("default"))) int PatchedConicSingle(
+    double3 *position,
+    double3 *velocity,
+    int *primaryIndex,
+    double mass,
+    double3 *bodies,
+    double3 *bodyVelocities,
+    double *masses,
+    int numBodies,
+    float dt,
+    Vector3 thrustImpulse)
+{
+    BudgetScope budget(BUDGET_PHYSICS);
+    if (mass <= 1e-6f || numBodies <= 0)
+        return 0;
+
+    Vector3d bodiesD[256];
+    Vector3d bodyVelD[256];
+    double massesD[256];
+    int n = std::min(numBodies, 256);
+    for (int i = 0; i < n; i++)
+    {
+        bodiesD[i] = ToVector3dFromDouble3(bodies[i]);
+        bodyVelD[i] = ToVector3dFromDouble3(bodyVelocities[i]);
+        massesD[i] = masses[i];
+    }
+    BodySet b{bodiesD, bodyVelD, massesD, n};
+
+    Vector3d absPos = ToVector3dFromDouble3(*position);
+    Vector3d absVel = ToVector3dFromDouble3(*velocity);
+    Vector3d th{thrustImpulse.x / mass, thrustImpulse.y / mass, thrustImpulse.z / mass};
+
+    int primary = *primaryIndex;
+    if (primary < 0 || primary >= n)
+        primary = SelectPrimary(b, absPos);
+
+    double h = (double)dt;
+    Vector3d rel = absPos - b.positions[primary];
+    Vector3d relVel = absVel - b.velocities[primary];
+
+    int target;
+    double g0 = SoiSwitch(b, primary, absPos, 0.0, target);
+
+    Vector3d relEnd = rel, relVelEnd = relVel;
+    StepAbout(b, primary, relEnd, relVelEnd, 0.0, h, th);
+
+    Vector3d absEnd = b.PositionAt(primary, h) + relEnd;
+    Vector3d absVelEnd = b.velocities[primary] + relVelEnd;
+    double g1 = SoiSwitch(b, primary, absEnd, h, target);
+
+    int switched = 0;
+    if (g0 > 0.0 && g1 <= 0.0)
+    {
+        // Boundary crossed inside the step: locate it on the dense output, then split the step.
+        HermiteSegment seg{0.0, h, absPos, absVel, absEnd, absVelEnd};
+        int unusedTarget;
+        double tEvent = LocateEvent([&](double t)
+                                    { return SoiSwitch(b, primary, seg.Position(t), t, unusedTarget); },
+                                    0.0, h, g0, g1, SOI_EVENT_TIME_TOL);
+
+        Vector3d relEvent = rel, relVelEvent = relVel;
+        StepAbout(b, primary, relEvent, relVelEvent, 0.0, tEvent, th);
+        Vector3d absEvent = b.PositionAt(primary, tEvent) + relEvent;
+        Vector3d absVelEvent = b.velocities[primary] + relVelEvent;
+
+        primary = target;
+        relEnd = absEvent - b.PositionAt(primary, tEvent);
+        relVelEnd = absVelEvent - b.velocities[primary];
+        StepAbout(b, primary, relEnd, relVelEnd, tEvent, h - tEvent, th);
+
+        absEnd = b.PositionAt(primary, h) + relEnd;
+        absVelEnd = b.velocities[primary] + relVelEnd;
+        switched = 1;
+    }
+
+    *primaryIndex = primary;
+    *position = ToDouble3(absEnd);
+    *velocity = ToDouble3(absVelEnd);
+    return switched;
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <cmath>
+#include <string>
+
+/**
+ * @file PhysicsCommon.h
+ * @brief Types, constants and helpers shared by every translation unit of the physics plugin.
+ */
+
+/**
+ * @struct Vector3
+ * @brief 3D vector using single-precision floats.
+ */
+struct Vector3
+{
+    float x, y, z;
+};
+
+/**
+ * @struct Vector3d
+ * @brief 3D vector using double-precision floats.
+ */
+struct Vector3d
+{
+    double x, y, z;
+};
+
+/**
+ * @struct double3
+ * @brief Unity-compatible 3D double-precision vector.
+ */
+struct double3
+{
+    double x, y, z;
+};
+
+/** Converts Vector3 to Vector3d */
+inline Vector3d ToVector3dFromVector3(const Vector3 &v) { return {v.x, v.y, v.z}; }
+
+/** Converts double3 to Vector3d */
+inline Vector3d ToVector3dFromDouble3(const double3 &v) { return {v.x, v.y, v.z}; }
+
+/** Converts Vector3d to double3 */
+inline double3 ToDouble3(const Vector3d &v) { return {v.x, v.y, v.z}; }
+
+/** Component-wise vector arithmetic used by the propagators. */
+inline Vector3d operator+(const Vector3d &a, const Vector3d &b) { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+inline Vector3d operator-(const Vector3d &a, const Vector3d &b) { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+inline Vector3d operator-(const Vector3d &a) { return {-a.x, -a.y, -a.z}; }
+inline Vector3d operator*(double s, const Vector3d &a) { return {s * a.x, s * a.y, s * a.z}; }
+inline Vector3d operator*(const Vector3d &a, double s) { return {s * a.x, s * a.y, s * a.z}; }
+inline Vector3d &operator+=(Vector3d &a, const Vector3d &b)
+{
+    a.x += b.x;
+    a.y += b.y;
+    a.z += b.z;
+    return a;
+}
+
+/** Dot product. */
+inline double Dot(const Vector3d &a, const Vector3d &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+/** Cross product. */
+inline Vector3d Cross(const Vector3d &a, const Vector3d &b)
+{
+    return {a.y * b.z - a.z * b.y,
+            a.z * b.x - a.x * b.z,
+            a.x * b.y - a.y * b.x};
+}
+
+/** Euclidean length. */
+inline double Norm(const Vector3d &a) { return std::sqrt(Dot(a, a)); }
+
+// Constants
+const double G = 6.67430e-23;                ///< Gravitational constant (scaled for sim units).
+const double minDistSq = 1e-20;              ///< Minimum distance squared to avoid singularities.
+const double maxForce = 1;                   ///< Cap on maximum gravitational force per object.
+const double UNIT_TO_KM = 10.0;              ///< Unit conversion: 1 sim unit = 10 km.
+const double EARTH_RADIUS_KM = 637.8 * 10.0; ///< Earth's radius in sim units.
+const double OMEGA_EARTH = 7.2921150e-5;     ///< Earth's angular velocity (rad/s).
+const double DENSITY_SCALE = 1.0;            ///< Global scaling for atmosphere density.
+
+/** Dormand-Prince 5(4) Butcher tableau (nodes, stage weights, 5th-order solution weights). */
+inline constexpr double c_dp[7] = {0.0, 1. / 5, 3. / 10, 4. / 5, 8. / 9, 1.0, 1.0};
+inline constexpr double a_dp[7][6] = {
+    {}, {1. / 5}, {3. / 40, 9. / 40}, {44. / 45, -56. / 15, 32. / 9}, {19372. / 6561, -25360. / 2187, 64448. / 6561, -212. / 729}, {9017. / 3168, -355. / 33, 46732. / 5247, 49. / 176, -5103. / 18656}, {35. / 384, 0, 500. / 1113, 125. / 192, -2187. / 6784, 11. / 84}};
+inline constexpr double b_dp[7] = {35. / 384, 0, 500. / 1113, 125. / 192, -2187. / 6784, 11. / 84, 0};
+
+/**
+ * @brief Generic Dormand-Prince 5(4) step for a second-order system.
+ * @param pos Position (input/output).
+ * @param vel Velocity (input/output).
+ * @param dt Timestep.
+ * @param accel Callable (tOffset, pos, vel) -> acceleration.
+ */
+template <typename AccelFn>
+void DormandPrinceStepFn(Vector3d &pos, Vector3d &vel, double dt, AccelFn accel)
+{
+    Vector3d kx[7], kv[7];
+    kx[0] = vel;
+    kv[0] = accel(0.0, pos, vel);
+
+    for (int i = 1; i < 7; i++)
+    {
+        Vector3d pi = pos, vi = vel;
+        for (int j = 0; j < i; j++)
+        {
+            pi += (dt * a_dp[i][j]) * kx[j];
+            vi += (dt * a_dp[i][j]) * kv[j];
+        }
+        kx[i] = vi;
+        kv[i] = accel(c_dp[i] * dt, pi, vi);
+    }
+
+    for (int i = 0; i < 7; i++)
+    {
+        pos += (dt * b_dp[i]) * kx[i];
+        vel += (dt * b_dp[i]) * kv[i];
+    }
+}
+
+extern "C"
+{
+    /**
+     * @brief Appends a message to the debug log file.
+     * @param msg Message to write.
+     */
+    void LogDebug(const std::string &msg);
+
+    /**
+     * @brief Computes atmospheric density at a given altitude using exponential interpolation.
+     * @param altKm Altitude in kilometers.
+     * @return Density in kg/km³ (zero above 500 km).
+     */
+    double ComputeAtmosphericDensity(double altKm);
+
+    /**
+     * @brief Atmospheric density from the same profile without the orbital-decay cap below 130 km,
+     * for flight through the lower atmosphere.
+     * @param altKm Altitude in kilometers.
+     * @return Density in kg/km³ (zero above 500 km).
+     */
+    double ComputeAtmosphericDensityUncapped(double altKm);
+
+    /**
+     * @brief Computes gravitational acceleration from multiple bodies.
+     * @param pos Current position of the body.
+     * @param masses Array of body masses.
+     * @param bodies Array of body positions.
+     * @param n Number of other bodies.
+     * @param mass Mass of the target body.
+     * @return Acceleration vector.
+     */
+    Vector3d ComputeAcceleration(Vector3d pos, double *masses, Vector3d *bodies, int n, double mass);
+}
@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Bvh.h"
+
+/**
+ * @file Picking.cpp
+ * @brief Screen-ray picking of objects over a BVH of their render positions.
+ *
+ * The caller hands over the render positions once per frame. While the set of ids is unchanged
+ * the hierarchy is refitted in place (one linear sweep) instead of rebuilt; it is rebuilt when the
+ * ids change or when motion has inflated the inner nodes to twice their surface area at build
+ * time. A pick is a cone around the screen ray: an object qualifies when its distance from the
+ * ray is within the pixel tolerance at its range, and the one closest to the ray in pixels wins.
+ */
+
+const double PICK_REBUILD_COST_RATIO = 2.0; ///< Rebuild once refitting has grown the tree cost this much.
+
+extern "C"
+{
+    /**
+     * @struct PickHit
+     * @brief Result of a pick; layout must match NativePhysics.PickHit.
+     */
+    struct PickHit
+    {
+        double distance; ///< Range along the ray.
+        double offset;   ///< Distance from the ray.
+        int id;
+        int reserved;
+    };
+}
+
+namespace
+{
+    struct PickIndex
+    {
+        Bvh bvh;
+        std::vector<int> ids;
+        std::vector<Aabb> boxes;
+        double builtCost = 0;
+    };
+
+    PickIndex &GetPickIndex()
+    {
+        static PickIndex index;
+        return index;
+    }
+}
+
+/**
+ * @brief Sets the current render positions of the pickable objects.
+ * Refits the hierarchy when the ids match the previous call, otherwise rebuilds it.
+ * @param ids Object ids.
+ * @param positions Render positions (any frame, as long as rays use the same one).
+ * @param count Number of objects.
+ */
+extern "C" __attribute__((visibility("default"))) void PickSetPositions(const int *ids, const double3 *positions, int count)
+{
+    PickIndex &index = GetPickIndex();
+    bool sameIds = (int)index.ids.size() == count && std::equal(ids, ids + count, index.ids.begin());
+    index.boxes.resize(count);
+    for (int k = 0; k < count; ++k)
+    {
+        Vector3d p = ToVector3dFromDouble3(positions[k]);
+        index.boxes[k] = {p, p};
+    }
+
+    if (sameIds && count > 0 && index.bvh.Refit(index.boxes) <= PICK_REBUILD_COST_RATIO * index.builtCost)
+        return;
+
+    index.ids.assign(ids, ids + count);
+    index.bvh.Build(index.boxes);
+    index.builtCost = index.bvh.Refit(index.boxes);
+}
+
+/**
+ * @brief Picks the object closest to a screen ray.
+ * @param origin Ray origin (camera position).
+ * @param direction Ray direction (need not be normalised).
+ * @param tanTolerance Tangent of the angular pick tolerance (pixels times the angle per pixel).
+ * @param minRadius Pick radius at the origin, so objects close to the camera stay easy to hit.
+ * @param hit Output hit.
+ * @return 1 if an object lies within the tolerance, 0 otherwise.
+ */
+extern "C" __attribute__((visibility("default"))) int PickRay(double3 origin, double3 direction, double tanTolerance,
+                                                              double minRadius, PickHit *hit)
+{
+    const PickIndex &index = GetPickIndex();
+    Vector3d o = ToVector3dFromDouble3(origin), d = ToVector3dFromDouble3(direction);
+    double len = Norm(d);
+    if (!(len > 0))
+        return 0;
+    d = d * (1.0 / len);
+
+    // Score = distance from the ray over the allowed radius at that range; a hit needs <= 1.
+    double bestScore = 1.0;
+    int best = -1;
+    double bestT = 0, bestOffset = 0;
+    index.bvh.Traverse(
+        [&](const Aabb &box)
+        {
+            Vector3d c = box.Center() - o;
+            double rho = 0.5 * Norm(box.hi - box.lo);
+            double t = Dot(c, d);
+            if (t + rho <= 0)
+                return false;
+            double offset = std::max(0.0, Norm(c - t * d) - rho);
+            return offset <= bestScore * (minRadius + (t + rho) * tanTolerance);
+        },
+        [&](int item)
+        {
+            Vector3d p = index.boxes[item].lo - o;
+            double t = Dot(p, d);
+            if (t <= 0)
+                return;
+            double offset = Norm(p - t * d);
+            double score = offset / (minRadius + t * tanTolerance);
+            if (score <= bestScore)
+            {
+                bestScore = score;
+                best = item;
+                bestT = t;
+                bestOffset = offset;
+            }
+        });
+
+    if (best < 0)
+        return 0;
+    *hit = {bestT, bestOffset, index.ids[best], 0};
+    return 1;
+}
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Catalog.h"
+#include "EventDetection.h"
+#include "Frames.h"
+#include "Geodesy.h"
+#include "ThreadPool.h"
+
+/**
+ * @file SensorCrossings.cpp
+ * @brief Detections of catalog objects by ground radar fences and optical fields of view.
+ *
+ * A fan-beam fence is the vertical plane through the site along a given azimuth, cut to the
+ * sensor's range and elevation mask. An object is detected when it crosses the plane inside
+ * that region. The switching function is the signed distance to the plane. An optical sensor
+ * is a cone about a fixed boresight. Its switching function is the rate of change of the cosine
+ * of the angle off boresight. That function goes from positive to negative at the object's
+ * closest approach to the boresight, once per pass, so a coarse step does not miss a fast
+ * transit of a narrow field. The pass is a detection if that closest point lies inside the
+ * cone and range.
+ *
+ * Objects are sampled at knots and interpolated with cubic Hermite dense output. Knots fall on
+ * a shared SENSOR_KNOT grid, with a stride that keeps about SENSOR_KNOTS_PER_REV per orbit, so
+ * high orbits are sampled more sparsely. Sign changes are refined with LocateEvent. Pruning
+ * with the orbit geometry means only a small part of the catalog and of each day is propagated:
+ * - The radius band [perigee, apogee], the sensor range and the elevation mask together bound
+ *   the geocentric angle from the site at which the orbit can be detected (the sensor's reach).
+ * - The orbit plane only sweeps latitudes up to the inclination, so an orbit that cannot reach
+ *   the site's latitude band is skipped entirely.
+ * - For the rest, the direction from the drifting mean elements is cheap. Only knots where that
+ *   direction lies within reach of the site, allowing for eccentricity and motion over a knot,
+ *   are propagated.
+ * The sensors are Earth-fixed, so their inertial geometry at every knot is computed once and
+ * shared by all objects.
+ */
+
+const double SENSOR_KNOT = 60.0;            ///< Knot grid and the shortest step behind the dense output (s).
+const double SENSOR_KNOTS_PER_REV = 90.0;   ///< Knots per orbit above which the stride is lengthened.
+const double SENSOR_EVENT_TOLERANCE = 1e-3; ///< Time tolerance of located crossings (s).
+const double SENSOR_PRUNE_MARGIN = 0.02;    ///< Angular margin of the prunes, covering J2 short-period terms and frame bias (rad).
+const int SENSOR_OBJECT_BLOCK = 64;         ///< Objects per work item.
+
+enum SensorType
+{
+    SENSOR_FENCE = 0,
+    SENSOR_OPTICAL = 1,
+};
+
+extern "C"
+{
+    /**
+     * @struct SensorSpec
+     * @brief A ground sensor; layout must match NativePhysics.SensorSpec.
+     */
+    struct SensorSpec
+    {
+        double latitude;     ///< Geodetic latitude of the site (rad).
+        double longitude;    ///< East longitude of the site (rad).
+        double altitudeKm;   ///< Site height above the ellipsoid (km).
+        double azimuth;      ///< Fence: azimuth of the fan plane; optical: boresight azimuth (rad from north).
+        double elevation;    ///< Optical: boresight elevation (rad); unused for fences.
+        double halfAngle;    ///< Optical: field-of-view half-angle (rad); unused for fences.
+        double minElevation; ///< Elevation mask (rad).
+        double maxRangeKm;   ///< Detection range (km).
+        int type;            ///< SensorType.
+        int reserved;
+    };
+
+    /**
+     * @struct SensorDetection
+     * @brief One detection; layout must match NativePhysics.SensorDetection.
+     */
+    struct SensorDetection
+    {
+        double time;      ///< Fence crossing or closest approach to the boresight (s).
+        double rangeKm;
+        double azimuth;   ///< Topocentric azimuth, clockwise from north (rad).
+        double elevation; ///< Topocentric elevation (rad).
+        int objectId;
+        int sensor;       ///< Index into the sensor array.
+    };
+}
+
+namespace
+{
+    /** Earth-fixed geometry of one sensor (sim units). */
+    struct SensorFrame
+    {
+        Vector3d site, up, north, east;
+        Vector3d axis;     ///< Fence plane normal or optical boresight.
+        double siteRadius; ///< Geocentric distance of the site (units).
+        double siteLatitude; ///< Geocentric latitude of the site (rad).
+        double range;      ///< (units)
+        double cosHalfAngle;
+        double sinMinElevation;
+    };
+
+    /** Sensor geometry rotated into the inertial frame at one time. */
+    struct InertialSensor
+    {
+        Vector3d site, axis, omega;
+        Vector3d zenith; ///< Unit vector towards the site from Earth's centre.
+    };
+
+    SensorFrame MakeFrame(const SensorSpec &s)
+    {
+        SensorFrame f;
+        f.site = GeodeticToEarthFixed({s.latitude, s.longitude, s.altitudeKm});
+        double sl = std::sin(s.latitude), cl = std::cos(s.latitude);
+        double so = std::sin(s.longitude), co = std::cos(s.longitude);
+        f.up = {cl * co, cl * so, sl};
+        f.north = {-sl * co, -sl * so, cl};
+        f.east = {-so, co, 0};
+        Vector3d along = std::cos(s.azimuth) * f.north + std::sin(s.azimuth) * f.east;
+        if (s.type == SENSOR_FENCE)
+            f.axis = Cross(f.up, along);
+        else
+            f.axis = std::cos(s.elevation) * along + std::sin(s.elevation) * f.up;
+        f.siteRadius = Norm(f.site);
+        f.siteLatitude = std::asin(f.site.z / f.siteRadius);
+        f.range = s.maxRangeKm / UNIT_TO_KM;
+        f.cosHalfAngle = std::cos(s.halfAngle);
+        f.sinMinElevation = std::sin(s.minElevation);
+        return f;
+    }
+
+    InertialSensor ToInertial(const SensorFrame &f, const Matrix3 &earthFixed)
+    {
+        Matrix3 toInertial = earthFixed.Transposed();
+        Vector3d site = toInertial * f.site;
+        return {site, toInertial * f.axis, toInertial * Vector3d{0, 0, OMEGA_EARTH}, site * (1.0 / f.siteRadius)};
+    }
+
+    /** Switching function of a sensor for an inertial state. */
+    double Switching(int type, const InertialSensor &s, const Vector3d &p, const Vector3d &v)
+    {
+        Vector3d u = p - s.site;
+        if (type == SENSOR_FENCE)
+            return Dot(s.axis, u);
+        // d/dt of cos(angle off boresight), with the site and boresight turning with Earth.
+        Vector3d du = v - Cross(s.omega, s.site);
+        double bu = Dot(s.axis, u);
+        double uu = Dot(u, u);
+        double dbu = Dot(Cross(s.omega, s.axis), u) + Dot(s.axis, du);
+        return (dbu * uu - bu * Dot(u, du)) / (uu * std::sqrt(uu));
+    }
+
+    /**
+     * Largest geocentric angle from the site at which the orbit can be detected (rad), or -1 if
+     * it never comes within range. At radius r the range limits that angle to gammaR(r). This
+     * rises to its peak at r* = sqrt(s² - R²) and falls after it. The elevation mask limits it
+     * to gammaE(r), which rises with r. Their minimum is therefore unimodal, with its peak at r*
+     * or where the two curves cross.
+     */
+    double Reach(const SensorFrame &f, double minElevation, const OrbitalElements &el)
+    {
+        double s = f.siteRadius;
+        double lo = std::max(el.a * (1 - el.e), s - f.range), hi = std::min(el.a * (1 + el.e), s + f.range);
+        if (lo > hi)
+            return -1;
+        auto gammaR = [&](double r)
+        { return std::acos(std::clamp((r * r + s * s - f.range * f.range) / (2 * r * s), -1.0, 1.0)); };
+        auto gammaE = [&](double r)
+        { return std::acos(std::min(1.0, s / r * std::cos(minElevation))) - minElevation; };
+        auto reach = [&](double r) { return std::min(gammaR(r), gammaE(r)); };
+
+        double best = std::max(reach(lo), reach(hi));
+        double rStar = std::sqrt(std::max(0.0, s * s - f.range * f.range));
+        double a = std::max(lo, rStar), b = hi;
+        if (rStar > lo && rStar < hi)
+            best = std::max(best, reach(rStar));
+        if (a < b && gammaR(a) > gammaE(a) && gammaR(b) < gammaE(b))
+        {
+            for (int iter = 0; iter < 50; ++iter)
+            {
+                double m = 0.5 * (a + b);
+                (gammaR(m) > gammaE(m) ? a : b) = m;
+            }
+            best = std::max(best, reach(0.5 * (a + b)));
+        }
+        return best;
+    }
+
+    /** Unit vector towards the object from its mean orbit, ignoring the equation of centre. */
+    Vector3d MeanDirection(double raan, double inclination, double argumentOfLatitude)
+    {
+        double cu = std::cos(argumentOfLatitude), su = std::sin(argumentOfLatitude);
+        double co = std::cos(raan), so = std::sin(raan), ci = std::cos(inclination), si = std::sin(inclination);
+        return {co * cu - so * su * ci, so * cu + co * su * ci, su * si};
+    }
+
+    /** Fills a detection if the Earth-fixed offset from the site passes the sensor's limits. */
+    bool Detect(const SensorFrame &f, int type, const Vector3d &offset, SensorDetection &d)
+    {
+        double range = Norm(offset);
+        if (range > f.range || range <= 0)
+            return false;
+        double sinElevation = Dot(offset, f.up) / range;
+        if (sinElevation < f.sinMinElevation)
+            return false;
+        if (type == SENSOR_OPTICAL && Dot(offset, f.axis) / range < f.cosHalfAngle)
+            return false;
+        d.rangeKm = range * UNIT_TO_KM;
+        d.elevation = std::asin(std::clamp(sinElevation, -1.0, 1.0));
+        d.azimuth = std::fmod(std::atan2(Dot(offset, f.east), Dot(offset, f.north)) + 2 * M_PI, 2 * M_PI);
+        return true;
+    }
+}
+
+/**
+ * @brief Detects every catalog object crossing the detection surfaces of a set of sensors.
+ * Fences report each crossing of the fan inside range and above the mask. Optical sensors report
+ * each pass whose closest approach to the boresight falls inside the field of view. Illumination
+ * is not modelled.
+ * @param sensors Sensor definitions.
+ * @param sensorCount Number of sensors.
+ * @param t0 Window start (s).
+ * @param t1 Window end (s).
+ * @param detections Output detections sorted by time (capacity maxDetections).
+ * @param maxDetections Capacity of the output buffer.
+ * @return Number of detections (may exceed maxDetections; only the first maxDetections are written).
+ */
+extern "C" __attribute__((visibility("default"))) int SensorDetectCrossings(const SensorSpec *sensors, int sensorCount, double t0,
+                                                                            double t1, SensorDetection *detections,
+                                                                            int maxDetections)
+{
+    const Catalog &catalog = GetCatalog();
+    if (sensorCount <= 0 || t1 <= t0 || catalog.Count() == 0)
+        return 0;
+
+    std::vector<SensorFrame> frames(sensorCount);
+    for (int s = 0; s < sensorCount; ++s)
+        frames[s] = MakeFrame(sensors[s]);
+
+    // Sensor geometry at every knot, shared by all objects.
+    int knots = (int)std::ceil((t1 - t0) / SENSOR_KNOT) + 1;
+    EnsureFrameGrid(t0, t1);
+    std::vector<double> knotTime(knots);
+    std::vector<InertialSensor> atKnot((size_t)knots * sensorCount);
+    ParallelFor(knots, [&](int k)
+    {
+        knotTime[k] = std::min(t1, t0 + k * SENSOR_KNOT);
+        Matrix3 earthFixed = CelestialToTerrestrial(knotTime[k]);
+        for (int s = 0; s < sensorCount; ++s)
+            atKnot[(size_t)k * sensorCount + s] = ToInertial(frames[s], earthFixed);
+    });
+
+    int count = catalog.Count();
+    int blocks = (count + SENSOR_OBJECT_BLOCK - 1) / SENSOR_OBJECT_BLOCK;
+    std::vector<std::vector<SensorDetection>> found(blocks);
+    ParallelFor(blocks, [&](int b)
+    {
+        std::vector<int> active;
+        std::vector<double> reach(sensorCount);
+        std::vector<int> path;         // knot index of each of the object's samples
+        std::vector<char> near, state; // per sample: within reach of the sensor; 0 unset, 1 valid, 2 failed
+        std::vector<Vector3d> pos, vel, direction;
+        int end = std::min(count, (b + 1) * SENSOR_OBJECT_BLOCK);
+        for (int i = b * SENSOR_OBJECT_BLOCK; i < end; ++i)
+        {
+            OrbitalElements el = catalog.MeanElementsAt(i, t0);
+            if (el.a <= 0)
+                continue;
+            active.clear();
+            for (int s = 0; s < sensorCount; ++s)
+            {
+                reach[s] = Reach(frames[s], sensors[s].minElevation, el);
+                double maxLatitude = std::min(el.i, M_PI - el.i);
+                if (reach[s] >= 0 && std::fabs(frames[s].siteLatitude) - reach[s] <= maxLatitude + SENSOR_PRUNE_MARGIN)
+                    active.push_back(s);
+            }
+            if (active.empty())
+                continue;
+
+            double n = std::sqrt(catalog.mu / (el.a * el.a * el.a));
+            int stride = std::max(1, (int)(2 * M_PI / n / (SENSOR_KNOTS_PER_REV * SENSOR_KNOT)));
+            path.clear();
+            for (int k = 0; k < knots; k += stride)
+                path.push_back(k);
+            if (path.back() != knots - 1)
+                path.push_back(knots - 1);
+            int samples = (int)path.size();
+            near.assign(samples, 0);
+            state.assign(samples, 0);
+            pos.resize(samples);
+            vel.resize(samples);
+            direction.resize(samples);
+
+            // The catalog's mean elements drift linearly, so the mean direction is cheap at every knot.
+            const OrbitalElements &atEpoch = catalog.meanElements[i];
+            double raanDot, argpDot, meanAnomalyDot;
+            J2SecularRates(atEpoch.a, atEpoch.e, atEpoch.i, catalog.mu, raanDot, argpDot, meanAnomalyDot);
+            double latitudeRate = argpDot + std::sqrt(catalog.mu / (atEpoch.a * atEpoch.a * atEpoch.a)) + meanAnomalyDot;
+            for (int j = 0; j < samples; ++j)
+            {
+                double dt = knotTime[path[j]] - t0;
+                direction[j] = MeanDirection(el.raan + raanDot * dt, el.i, el.argp + el.meanAnomaly + latitudeRate * dt);
+            }
+
+            // The mean direction is within 2e of the true one; a step moves it by up to (n + Ω)·Δt.
+            double slack = 2 * el.e + (n + OMEGA_EARTH) * stride * SENSOR_KNOT + SENSOR_PRUNE_MARGIN;
+            auto sample = [&](int j)
+            {
+                if (state[j] == 0)
+                    state[j] = catalog.StateAt(i, knotTime[path[j]], pos[j], vel[j]) ? 1 : 2;
+                return state[j] == 1;
+            };
+
+            for (int s : active)
+            {
+                const SensorFrame &f = frames[s];
+                int type = sensors[s].type;
+                double cosReach = std::cos(std::min(M_PI, reach[s] + slack));
+                for (int j = 0; j < samples; ++j)
+                    near[j] = Dot(direction[j], atKnot[(size_t)path[j] * sensorCount + s].zenith) >= cosReach;
+                for (int j = 1; j < samples; ++j)
+                {
+                    if (!near[j - 1] && !near[j])
+                        continue;
+                    if (!sample(j - 1) || !sample(j))
+                        break;
+                    const InertialSensor &sa = atKnot[(size_t)path[j - 1] * sensorCount + s];
+                    const InertialSensor &sb = atKnot[(size_t)path[j] * sensorCount + s];
+                    double ga = Switching(type, sa, pos[j - 1], vel[j - 1]);
+                    double gb = Switching(type, sb, pos[j], vel[j]);
+                    bool crossed = type == SENSOR_FENCE ? (ga > 0) != (gb > 0) : (ga > 0 && gb <= 0);
+                    if (!crossed)
+                        continue;
+
+                    // Skip segments that stay farther from the site than the range plus their length.
+                    double reachUnits = f.range + Norm(pos[j] - pos[j - 1]);
+                    if (Norm(pos[j - 1] - sa.site) >= reachUnits && Norm(pos[j] - sb.site) >= reachUnits)
+                        continue;
+                    HermiteSegment seg{knotTime[path[j - 1]], knotTime[path[j]], pos[j - 1], vel[j - 1], pos[j], vel[j]};
+                    auto g = [&](double t)
+                    {
+                        InertialSensor st = ToInertial(f, CelestialToTerrestrial(t));
+                        return Switching(type, st, seg.Position(t), seg.Velocity(t));
+                    };
+                    double t = LocateEvent(g, seg.t0, seg.t1, ga, gb, SENSOR_EVENT_TOLERANCE);
+                    SensorDetection d;
+                    if (Detect(f, type, CelestialToTerrestrial(t) * seg.Position(t) - f.site, d))
+                    {
+                        d.time = t;
+                        d.objectId = catalog.ids[i];
+                        d.sensor = s;
+                        found[b].push_back(d);
+                    }
+                }
+            }
+        }
+    });
+
+    std::vector<SensorDetection> all;
+    for (auto &block : found)
+        all.insert(all.end(), block.begin(), block.end());
+    std::sort(all.begin(), all.end(), [](const SensorDetection &a, const SensorDetection &b)
+              { return a.time < b.time || (a.time == b.time && a.objectId < b.objectId); });
+    std::copy(all.begin(), all.begin() + std::min((int)all.size(), std::max(0, maxDetections)), detections);
+    return (int)all.size();
+}
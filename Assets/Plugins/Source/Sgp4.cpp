@@ -0,0 +1,303 @@
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#include "Frames.h"
+#include "Sgp4.h"
+
+namespace
+{
+    // WGS-72 constants, as the element sets are fitted with them.
+    const double SGP4_MU = 398600.8;         ///< km³/s²
+    const double SGP4_RE = 6378.135;         ///< km
+    const double SGP4_J2 = 0.001082616;
+    const double SGP4_J3 = -0.00000253881;
+    const double SGP4_J4 = -0.00000165597;
+    const double SGP4_XKE = 60.0 / std::sqrt(SGP4_RE * SGP4_RE * SGP4_RE / SGP4_MU); ///< sqrt(mu) in Earth radii and minutes.
+    const double SGP4_J3OJ2 = SGP4_J3 / SGP4_J2;
+    const double X2O3 = 2.0 / 3.0;
+    const double TWO_PI = 2 * M_PI;
+    const double DEG = M_PI / 180.0;
+
+    /** Parses columns [start, start + width) (0-based) as a plain number. */
+    bool Field(const char *line, int start, int width, double &value)
+    {
+        std::string s(line + start, width);
+        char *end = nullptr;
+        value = std::strtod(s.c_str(), &end);
+        return end != s.c_str();
+    }
+
+    /** Parses an implied-decimal field with an exponent, e.g. " 28098-4" = 0.28098e-4. */
+    bool ExponentField(const char *line, int start, double &value)
+    {
+        std::string s(line + start, 8);
+        if (s.find_first_not_of(' ') == std::string::npos)
+        {
+            value = 0;
+            return true;
+        }
+        double mantissa, exponent;
+        std::string m = s.substr(0, 6), e = s.substr(6, 2);
+        size_t sign = m.find_first_of("+-");
+        std::string digits = m.substr(sign == std::string::npos ? 0 : sign + 1);
+        digits.erase(0, digits.find_first_not_of(' '));
+        char *end = nullptr;
+        mantissa = std::strtod(("0." + digits).c_str(), &end);
+        if (sign != std::string::npos && m[sign] == '-')
+            mantissa = -mantissa;
+        exponent = std::strtod(e.c_str(), &end);
+        if (end == e.c_str())
+            return false;
+        value = mantissa * std::pow(10.0, exponent);
+        return true;
+    }
+
+    /** Catalog number, including the Alpha-5 form (a leading letter stands for 10-33, skipping I and O). */
+    bool CatalogNumber(const char *line, int &number)
+    {
+        char c = (char)std::toupper((unsigned char)line[2]);
+        double rest;
+        if (std::isalpha((unsigned char)c))
+        {
+            if (c == 'I' || c == 'O' || !Field(line, 3, 4, rest))
+                return false;
+            int lead = 10 + (c - 'A') - (c > 'I') - (c > 'O');
+            number = lead * 10000 + (int)rest;
+            return true;
+        }
+        if (!Field(line, 2, 5, rest))
+            return false;
+        number = (int)rest;
+        return true;
+    }
+}
+
+bool ParseTle(const char *line1, const char *line2, ElementSet &set)
+{
+    if (std::strlen(line1) < 64 || std::strlen(line2) < 63 || line1[0] != '1' || line2[0] != '2')
+        return false;
+
+    double year, day, bstar, incl, raan, ecc, argp, mean, motion;
+    if (!CatalogNumber(line1, set.catalogNumber) || !Field(line1, 18, 2, year) || !Field(line1, 20, 12, day) ||
+        !ExponentField(line1, 53, bstar) || !Field(line2, 8, 8, incl) || !Field(line2, 17, 8, raan) ||
+        !Field(line2, 34, 8, argp) || !Field(line2, 43, 8, mean) || !Field(line2, 52, 11, motion))
+        return false;
+    if (!Field(line2, 25, 8, ecc))
+        return false;
+    std::string eccDigits(line2 + 26, 7);
+    ecc = std::strtod(("0." + eccDigits).c_str(), nullptr);
+
+    int y = (int)year < 57 ? 2000 + (int)year : 1900 + (int)year;
+    double jan0 = 367.0 * y - std::floor(7.0 * y / 4.0) + 30 + 1721013.5; // 0h on 31 December of y - 1, valid 1901-2099
+    set.epoch = NormalizeDate(jan0 + std::floor(day), day - std::floor(day));
+    set.bstar = bstar;
+    set.inclination = incl * DEG;
+    set.raan = raan * DEG;
+    set.eccentricity = ecc;
+    set.argPerigee = argp * DEG;
+    set.meanAnomaly = mean * DEG;
+    set.meanMotion = motion * TWO_PI / 1440.0;
+    return true;
+}
+
+bool Sgp4Init(const ElementSet &set, Sgp4State &s)
+{
+    if (!(set.meanMotion > 0) || set.eccentricity < 0 || set.eccentricity >= 1)
+        return false;
+
+    s.bstar = set.bstar;
+    s.ecco = set.eccentricity;
+    s.argpo = set.argPerigee;
+    s.inclo = set.inclination;
+    s.mo = set.meanAnomaly;
+    s.nodeo = set.raan;
+
+    // Recover the Brouwer mean motion and semi-major axis from the Kozai mean motion.
+    double eccsq = s.ecco * s.ecco, omeosq = 1 - eccsq, rteosq = std::sqrt(omeosq);
+    double cosio = std::cos(s.inclo), cosio2 = cosio * cosio, sinio = std::sin(s.inclo);
+    double ak = std::pow(SGP4_XKE / set.meanMotion, X2O3);
+    double d1 = 0.75 * SGP4_J2 * (3 * cosio2 - 1) / (rteosq * omeosq);
+    double del = d1 / (ak * ak);
+    double adel = ak * (1 - del * del - del * (1.0 / 3.0 + 134 * del * del / 81.0));
+    del = d1 / (adel * adel);
+    s.no = set.meanMotion / (1 + del);
+    double ao = std::pow(SGP4_XKE / s.no, X2O3);
+    double po = ao * omeosq, posq = po * po, rp = ao * (1 - s.ecco);
+    double con42 = 1 - 5 * cosio2;
+    s.con41 = -con42 - cosio2 - cosio2;
+
+    // Density function parameters, lowered for perigees below 156 km.
+    double ss = 78.0 / SGP4_RE + 1, qzms2t = std::pow((120.0 - 78.0) / SGP4_RE, 4);
+    s.isimp = rp < 220.0 / SGP4_RE + 1;
+    double sfour = ss, qzms24 = qzms2t, perige = (rp - 1) * SGP4_RE;
+    if (perige < 156)
+    {
+        sfour = perige < 98 ? 20 : perige - 78;
+        qzms24 = std::pow((120 - sfour) / SGP4_RE, 4);
+        sfour = sfour / SGP4_RE + 1;
+    }
+
+    double pinvsq = 1 / posq, tsi = 1 / (ao - sfour);
+    s.eta = ao * s.ecco * tsi;
+    double etasq = s.eta * s.eta, eeta = s.ecco * s.eta, psisq = std::fabs(1 - etasq);
+    double coef = qzms24 * std::pow(tsi, 4), coef1 = coef / std::pow(psisq, 3.5);
+    double cc2 = coef1 * s.no *
+                 (ao * (1 + 1.5 * etasq + eeta * (4 + etasq)) +
+                  0.375 * SGP4_J2 * tsi / psisq * s.con41 * (8 + 3 * etasq * (8 + etasq)));
+    s.cc1 = s.bstar * cc2;
+    double cc3 = s.ecco > 1e-4 ? -2 * coef * tsi * SGP4_J3OJ2 * s.no * sinio / s.ecco : 0;
+    s.x1mth2 = 1 - cosio2;
+    s.cc4 = 2 * s.no * coef1 * ao * omeosq *
+            (s.eta * (2 + 0.5 * etasq) + s.ecco * (0.5 + 2 * etasq) -
+             SGP4_J2 * tsi / (ao * psisq) *
+                 (-3 * s.con41 * (1 - 2 * eeta + etasq * (1.5 - 0.5 * eeta)) +
+                  0.75 * s.x1mth2 * (2 * etasq - eeta * (1 + etasq)) * std::cos(2 * s.argpo)));
+    s.cc5 = 2 * coef1 * ao * omeosq * (1 + 2.75 * (etasq + eeta) + eeta * etasq);
+
+    // Secular rates.
+    double cosio4 = cosio2 * cosio2;
+    double temp1 = 1.5 * SGP4_J2 * pinvsq * s.no;
+    double temp2 = 0.5 * temp1 * SGP4_J2 * pinvsq;
+    double temp3 = -0.46875 * SGP4_J4 * pinvsq * pinvsq * s.no;
+    s.mdot = s.no + 0.5 * temp1 * rteosq * s.con41 + 0.0625 * temp2 * rteosq * (13 - 78 * cosio2 + 137 * cosio4);
+    s.argpdot = -0.5 * temp1 * con42 + 0.0625 * temp2 * (7 - 114 * cosio2 + 395 * cosio4) +
+                temp3 * (3 - 36 * cosio2 + 49 * cosio4);
+    double xhdot1 = -temp1 * cosio;
+    s.nodedot = xhdot1 + (0.5 * temp2 * (4 - 19 * cosio2) + 2 * temp3 * (3 - 7 * cosio2)) * cosio;
+    s.omgcof = s.bstar * cc3 * std::cos(s.argpo);
+    s.xmcof = s.ecco > 1e-4 ? -X2O3 * coef * s.bstar / eeta : 0;
+    s.nodecf = 3.5 * omeosq * xhdot1 * s.cc1;
+    s.t2cof = 1.5 * s.cc1;
+    double onePlusCos = std::fabs(cosio + 1) > 1.5e-12 ? 1 + cosio : 1.5e-12;
+    s.xlcof = -0.25 * SGP4_J3OJ2 * sinio * (3 + 5 * cosio) / onePlusCos;
+    s.aycof = -0.5 * SGP4_J3OJ2 * sinio;
+    s.delmo = std::pow(1 + s.eta * std::cos(s.mo), 3);
+    s.sinmao = std::sin(s.mo);
+    s.x7thm1 = 7 * cosio2 - 1;
+
+    s.d2 = s.d3 = s.d4 = s.t3cof = s.t4cof = s.t5cof = 0;
+    if (!s.isimp)
+    {
+        double cc1sq = s.cc1 * s.cc1;
+        s.d2 = 4 * ao * tsi * cc1sq;
+        double temp = s.d2 * tsi * s.cc1 / 3;
+        s.d3 = (17 * ao + sfour) * temp;
+        s.d4 = 0.5 * temp * ao * tsi * (221 * ao + 31 * sfour) * s.cc1;
+        s.t3cof = s.d2 + 2 * cc1sq;
+        s.t4cof = 0.25 * (3 * s.d3 + s.cc1 * (12 * s.d2 + 10 * cc1sq));
+        s.t5cof = 0.2 * (3 * s.d4 + 12 * s.cc1 * s.d3 + 6 * s.d2 * s.d2 + 15 * cc1sq * (2 * s.d2 + cc1sq));
+    }
+    return true;
+}
+
+bool Sgp4Propagate(const Sgp4State &s, double t, Vector3d &r, Vector3d &v)
+{
+    // Secular gravity and drag.
+    double xmdf = s.mo + s.mdot * t;
+    double argpdf = s.argpo + s.argpdot * t;
+    double nodedf = s.nodeo + s.nodedot * t;
+    double argpm = argpdf, mm = xmdf, t2 = t * t;
+    double nodem = nodedf + s.nodecf * t2;
+    double tempa = 1 - s.cc1 * t, tempe = s.bstar * s.cc4 * t, templ = s.t2cof * t2;
+    if (!s.isimp)
+    {
+        double delomg = s.omgcof * t;
+        double delm = s.xmcof * (std::pow(1 + s.eta * std::cos(xmdf), 3) - s.delmo);
+        mm = xmdf + delomg + delm;
+        argpm = argpdf - delomg - delm;
+        double t3 = t2 * t, t4 = t3 * t;
+        tempa -= s.d2 * t2 + s.d3 * t3 + s.d4 * t4;
+        tempe += s.bstar * s.cc5 * (std::sin(mm) - s.sinmao);
+        templ += s.t3cof * t3 + t4 * (s.t4cof + t * s.t5cof);
+    }
+
+    double am = std::pow(SGP4_XKE / s.no, X2O3) * tempa * tempa;
+    double nm = SGP4_XKE / std::pow(am, 1.5);
+    double em = s.ecco - tempe;
+    if (!(am > 0) || em >= 1 || em < -0.001)
+        return false;
+    em = std::max(em, 1e-6);
+    mm += s.no * templ;
+    double xlm = mm + argpm + nodem;
+    nodem = std::fmod(nodem, TWO_PI);
+    argpm = std::fmod(argpm, TWO_PI);
+    xlm = std::fmod(xlm, TWO_PI);
+    mm = std::fmod(xlm - argpm - nodem, TWO_PI);
+
+    // Long-period periodics.
+    double sinip = std::sin(s.inclo), cosip = std::cos(s.inclo);
+    double axnl = em * std::cos(argpm);
+    double temp = 1 / (am * (1 - em * em));
+    double aynl = em * std::sin(argpm) + temp * s.aycof;
+    double xl = mm + argpm + nodem + temp * s.xlcof * axnl;
+
+    // Kepler's equation in the modified variables.
+    double u = std::fmod(xl - nodem, TWO_PI);
+    double eo1 = u, sineo1 = 0, coseo1 = 1, step = 1;
+    for (int k = 0; k < 10 && std::fabs(step) >= 1e-12; ++k)
+    {
+        sineo1 = std::sin(eo1);
+        coseo1 = std::cos(eo1);
+        step = (u - aynl * coseo1 + axnl * sineo1 - eo1) / (1 - coseo1 * axnl - sineo1 * aynl);
+        step = std::clamp(step, -0.95, 0.95);
+        eo1 += step;
+    }
+
+    // Short-period periodics.
+    double ecose = axnl * coseo1 + aynl * sineo1;
+    double esine = axnl * sineo1 - aynl * coseo1;
+    double el2 = axnl * axnl + aynl * aynl;
+    double pl = am * (1 - el2);
+    if (pl < 0)
+        return false;
+    double rl = am * (1 - ecose);
+    double rdotl = std::sqrt(am) * esine / rl;
+    double rvdotl = std::sqrt(pl) / rl;
+    double betal = std::sqrt(1 - el2);
+    temp = esine / (1 + betal);
+    double sinu = am / rl * (sineo1 - aynl - axnl * temp);
+    double cosu = am / rl * (coseo1 - axnl + aynl * temp);
+    double su = std::atan2(sinu, cosu);
+    double sin2u = 2 * cosu * sinu, cos2u = 1 - 2 * sinu * sinu;
+    temp = 1 / pl;
+    double temp1 = 0.5 * SGP4_J2 * temp, temp2 = temp1 * temp;
+
+    double mrt = rl * (1 - 1.5 * temp2 * betal * s.con41) + 0.5 * temp1 * s.x1mth2 * cos2u;
+    su -= 0.25 * temp2 * s.x7thm1 * sin2u;
+    double xnode = nodem + 1.5 * temp2 * cosip * sin2u;
+    double xinc = s.inclo + 1.5 * temp2 * cosip * sinip * cos2u;
+    double mvt = rdotl - nm * temp1 * s.x1mth2 * sin2u / SGP4_XKE;
+    double rvdot = rvdotl + nm * temp1 * (s.x1mth2 * cos2u + 1.5 * s.con41) / SGP4_XKE;
+    if (mrt < 1)
+        return false;
+
+    double sinsu = std::sin(su), cossu = std::cos(su), snod = std::sin(xnode), cnod = std::cos(xnode);
+    double sini = std::sin(xinc), cosi = std::cos(xinc);
+    double xmx = -snod * cosi, xmy = cnod * cosi;
+    Vector3d uv{xmx * sinsu + cnod * cossu, xmy * sinsu + snod * cossu, sini * sinsu};
+    Vector3d vv{xmx * cossu - cnod * sinsu, xmy * cossu - snod * sinsu, sini * cossu};
+    double vkmpersec = SGP4_RE * SGP4_XKE / 60.0;
+    r = uv * (mrt * SGP4_RE);
+    v = (uv * mvt + vv * rvdot) * vkmpersec;
+    return true;
+}
+
+double ElementSetTime(const ElementSet &set)
+{
+    return SecondsBetween(ConvertTime(set.epoch, SCALE_UTC, SCALE_TT), SimulationEpoch());
+}
+
+bool ElementSetStateAt(const ElementSet &set, const Sgp4State &state, double t, Vector3d &r, Vector3d &v)
+{
+    Vector3d rTeme, vTeme;
+    if (!Sgp4Propagate(state, (t - ElementSetTime(set)) / 60.0, rTeme, vTeme))
+        return false;
+    Matrix3 m = TemeToCelestial(t);
+    r = m * rTeme * (1.0 / UNIT_TO_KM);
+    v = m * vTeme * (1.0 / UNIT_TO_KM);
+    return true;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "PhysicsCommon.h"
+#include "TimeScales.h"
+
+/**
+ * @file Sgp4.h
+ * @brief Two-line element sets and the SGP4 propagator (Vallado et al. 2006 revision, WGS-72).
+ *
+ * Only the near-Earth theory is implemented. Deep-space element sets (period >= 225 min) are
+ * accepted and propagated with the same secular and short-period terms. The SDP4 lunar-solar and
+ * resonance terms are left out, so away from the epoch they drift by km per day in GEO.
+ * SGP4 output is in TEME; ElementSetStateAt rotates it into the plugin's inertial (GCRF) frame.
+ */
+
+const double SGP4_DEEP_SPACE_PERIOD = 225.0; ///< Period (min) from which SGP4 switches to SDP4.
+
+/**
+ * @struct ElementSet
+ * @brief Mean elements of one TLE.
+ */
+struct ElementSet
+{
+    int catalogNumber = 0;
+    JulianDate epoch{};      ///< UTC.
+    double meanMotion = 0;   ///< Kozai mean motion (rad/min).
+    double eccentricity = 0;
+    double inclination = 0;  ///< (rad)
+    double raan = 0;         ///< (rad)
+    double argPerigee = 0;   ///< (rad)
+    double meanAnomaly = 0;  ///< (rad)
+    double bstar = 0;        ///< Drag term (1/Earth radii).
+};
+
+/**
+ * @struct Sgp4State
+ * @brief Initialised SGP4 coefficients for one element set.
+ */
+struct Sgp4State
+{
+    double bstar, ecco, argpo, inclo, mo, nodeo, no;
+    double aycof, con41, cc1, cc4, cc5, d2, d3, d4, delmo, eta, argpdot, omgcof, sinmao;
+    double t2cof, t3cof, t4cof, t5cof, x1mth2, x7thm1, mdot, nodedot, xlcof, xmcof, nodecf;
+    bool isimp;
+};
+
+/**
+ * @brief Parses the two lines of a TLE (checksums are not enforced).
+ * @return False if a line is too short or a field is malformed.
+ */
+bool ParseTle(const char *line1, const char *line2, ElementSet &set);
+
+/**
+ * @brief Computes the SGP4 coefficients of an element set.
+ * @return False for elements SGP4 cannot propagate (e >= 1, non-positive mean motion).
+ */
+bool Sgp4Init(const ElementSet &set, Sgp4State &state);
+
+/**
+ * @brief Propagates with SGP4.
+ * @param minutes Time since the element set epoch (min).
+ * @param r Output TEME position (km).
+ * @param v Output TEME velocity (km/s).
+ * @return False if the orbit decayed or the elements became invalid.
+ */
+bool Sgp4Propagate(const Sgp4State &state, double minutes, Vector3d &r, Vector3d &v);
+
+/** Simulation time (s) of an element set's epoch. */
+double ElementSetTime(const ElementSet &set);
+
+/**
+ * @brief State of an element set at simulation time t, in the catalog frame (GCRF, sim units).
+ * @return False if SGP4 failed.
+ */
+bool ElementSetStateAt(const ElementSet &set, const Sgp4State &state, double t, Vector3d &r, Vector3d &v);
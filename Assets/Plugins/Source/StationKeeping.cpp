@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "Catalog.h"
+#include "EventDetection.h"
+#include "Frames.h"
+#include "Geodesy.h"
+#include "ManeuverSchedule.h"
+#include "ThreadPool.h"
+
+/**
+ * @file StationKeeping.cpp
+ * @brief Dead-band station keeping for catalog objects, planned in batch and executed through
+ * the maneuver schedule.
+ *
+ * Both regimes reduce to an along-track error x measured against a reference slot: for GEO the
+ * Earth-fixed longitude error times the GEO radius, for LEO the argument-of-latitude error
+ * against a reference circular orbit times its radius. With Δa the semi-major axis offset from
+ * the drift-free value, x drifts at dx/dt = -1.5 n Δa, and drag adds d²x/dt² = -1.5 n da/dt.
+ *
+ * - With drag, each burn raises the orbit just enough that x runs back to the far edge of the
+ *   box and returns under decay (the usual parabolic profile).
+ * - Without drag, a burn sets a drift back towards the centre and a second burn stops it.
+ *
+ * Tangential corrections are split into two equal burns half an orbit apart so the orbit stays
+ * circular. GEO inclination is removed with a single burn at the next node.
+ */
+
+const double STATION_KEEPING_CHECKS_PER_ORBIT = 8.0; ///< Controller evaluations per orbit.
+const int STATION_KEEPING_MAX_ROUNDS = 256;          ///< Evaluation rounds per update call.
+const int STATION_KEEPING_NODE_SAMPLES = 16;         ///< Samples per orbit when searching for a node.
+
+extern "C"
+{
+    /**
+     * @struct StationKeepingBox
+     * @brief Dead-band box and limits for one satellite; layout must match NativePhysics.StationKeepingBox.
+     */
+    struct StationKeepingBox
+    {
+        int regime;                 ///< 0 = GEO (longitude/inclination), 1 = LEO (along-track/altitude).
+        int reserved;
+        double longitude;           ///< GEO: target longitude (rad, Earth-fixed).
+        double longitudeHalfWidth;  ///< GEO: half-width of the longitude box (rad).
+        double inclinationMax;      ///< GEO: inclination that triggers a plane correction (rad), 0 to disable.
+        double semiMajorAxis;       ///< LEO: reference semi-major axis (units).
+        double altitudeHalfWidth;   ///< LEO: half-width of the semi-major axis box (units).
+        double referenceEpoch;      ///< LEO: time at which the slot is at argumentOfLatitude (s).
+        double argumentOfLatitude;  ///< LEO: slot argument of latitude at referenceEpoch (rad).
+        double alongTrackHalfWidth; ///< LEO: half-width of the along-track box (units).
+        double driftTime;           ///< Drag-free regimes: time to drift back across half the box (s).
+        double minBurnSpacing;      ///< Minimum time between planned corrections (s).
+        double maxBurn;             ///< Largest single impulse (units/s).
+    };
+
+    /**
+     * @struct StationKeepingStatus
+     * @brief Controller state for one satellite; layout must match NativePhysics.StationKeepingStatus.
+     */
+    struct StationKeepingStatus
+    {
+        double alongTrackError;    ///< x at the last evaluation (units).
+        double alongTrackRate;     ///< dx/dt at the last evaluation (units/s).
+        double semiMajorAxisError; ///< a minus the reference (LEO) or GEO radius (units).
+        double inclination;        ///< Inclination at the last evaluation (rad).
+        double totalDeltaV;        ///< Sum of executed impulses (units/s).
+        double lastBurnTime;       ///< Time of the last executed impulse (s).
+        int burns;                 ///< Executed impulses.
+        int pending;               ///< Impulses still in the maneuver schedule.
+    };
+}
+
+namespace
+{
+    struct Controller
+    {
+        int id;
+        StationKeepingBox box;
+        StationKeepingStatus status;
+        double nextCheck;
+        std::vector<ScheduledManeuver> plan; ///< Filled during a parallel round.
+    };
+
+    struct StationKeeping
+    {
+        std::vector<Controller> controllers;
+        std::unordered_map<int, int> slotOf;
+        double lastUpdate = NAN;
+    };
+
+    StationKeeping &GetStationKeeping()
+    {
+        static StationKeeping sk;
+        return sk;
+    }
+
+    double WrapPi(double angle)
+    {
+        return std::remainder(angle, 2 * M_PI);
+    }
+
+    double GeoRadius(double mu)
+    {
+        return std::cbrt(mu / (OMEGA_EARTH * OMEGA_EARTH));
+    }
+
+    /** Along-track angle error of a state against the box's reference slot (rad). */
+    double SlotAngle(const StationKeepingBox &box, double mu, double t, const Vector3d &r, const Vector3d &v)
+    {
+        if (box.regime == 0)
+        {
+            Vector3d e = InertialToEarthFixed(r, t);
+            return WrapPi(std::atan2(e.y, e.x) - box.longitude);
+        }
+
+        Vector3d h = Cross(r, v);
+        Vector3d node = Cross(Vector3d{0, 0, 1}, h);
+        if (Norm(node) < 1e-12 * Norm(h))
+            node = {1, 0, 0};
+        node = node * (1.0 / Norm(node));
+        Vector3d inPlane = Cross(h, node);
+        inPlane = inPlane * (1.0 / Norm(inPlane));
+        double u = std::atan2(Dot(r, inPlane), Dot(r, node));
+
+        double inc = std::acos(std::clamp(h.z / Norm(h), -1.0, 1.0));
+        double raanDot, argpDot, meanAnomalyDot;
+        J2SecularRates(box.semiMajorAxis, 0.0, inc, mu, raanDot, argpDot, meanAnomalyDot);
+        double rate = std::sqrt(mu / std::pow(box.semiMajorAxis, 3)) + argpDot + meanAnomalyDot;
+        return WrapPi(u - box.argumentOfLatitude - rate * (t - box.referenceEpoch));
+    }
+
+    /** Tangential impulse of size dv, split in two halves half an orbit apart. */
+    void PlanTangential(const Catalog &catalog, int i, int id, double t, double period, double dv,
+                        std::vector<ScheduledManeuver> &plan)
+    {
+        for (int k = 0; k < 2; ++k)
+        {
+            double tb = t + 0.5 * period * k;
+            Vector3d r, v;
+            if (!catalog.StateAt(i, tb, r, v))
+                return;
+            plan.push_back({0, id, tb, v * (0.5 * dv / Norm(v))});
+        }
+    }
+
+    /** Plane change to the equator at the next node after t. */
+    bool PlanInclination(const Catalog &catalog, int i, int id, double t, double period,
+                         std::vector<ScheduledManeuver> &plan)
+    {
+        double step = period / STATION_KEEPING_NODE_SAMPLES;
+        Vector3d r, v;
+        if (!catalog.StateAt(i, t, r, v))
+            return false;
+        double za = r.z;
+        for (int k = 1; k <= STATION_KEEPING_NODE_SAMPLES; ++k)
+        {
+            double tb = t + k * step;
+            if (!catalog.StateAt(i, tb, r, v))
+                return false;
+            if ((za < 0) != (r.z < 0))
+            {
+                auto z = [&](double s)
+                {
+                    Vector3d rs, vs;
+                    catalog.StateAt(i, s, rs, vs);
+                    return rs.z;
+                };
+                double tn = LocateEvent(z, tb - step, tb, za, r.z, 1e-3);
+                catalog.StateAt(i, tn, r, v);
+                Vector3d rHat = r * (1.0 / Norm(r));
+                double radial = Dot(v, rHat);
+                double horizontal = Norm(v - rHat * radial);
+                double sign = Cross(r, v).z >= 0 ? 1.0 : -1.0;
+                Vector3d east = Cross(Vector3d{0, 0, 1}, rHat);
+                east = east * (sign / Norm(east));
+                Vector3d target = rHat * radial + east * horizontal;
+                plan.push_back({0, id, tn, target - v});
+                return true;
+            }
+            za = r.z;
+        }
+        return false;
+    }
+
+    /** Evaluates one controller at time t and fills its plan. */
+    void Evaluate(Controller &c, const Catalog &catalog, double t)
+    {
+        c.plan.clear();
+        int i = catalog.Find(c.id);
+        Vector3d r, v;
+        if (i < 0 || !catalog.StateAt(i, t, r, v))
+            return;
+
+        const StationKeepingBox &box = c.box;
+        double mu = catalog.mu;
+        double aRef = box.regime == 0 ? GeoRadius(mu) : box.semiMajorAxis;
+        double n = std::sqrt(mu / (aRef * aRef * aRef));
+        double period = box.regime == 0 ? 2 * M_PI / OMEGA_EARTH : 2 * M_PI / n;
+        c.nextCheck = t + period / STATION_KEEPING_CHECKS_PER_ORBIT;
+
+        // Orbit-averaged drift from the error one period apart.
+        Vector3d r1, v1;
+        if (!catalog.StateAt(i, t + period, r1, v1))
+            return;
+        double angle = SlotAngle(box, mu, t, r, v);
+        double x = aRef * angle;
+        double xDot = aRef * WrapPi(SlotAngle(box, mu, t + period, r1, v1) - angle) / period;
+        double a = -mu / (2 * (0.5 * Dot(v, v) - mu / Norm(r)));
+        double da = a - aRef;
+        double xDDot = -1.5 * n * DragDecayRate(a, catalog.ballistic[i], mu);
+
+        Vector3d h = Cross(r, v);
+        c.status.alongTrackError = x;
+        c.status.alongTrackRate = xDot;
+        c.status.semiMajorAxisError = da;
+        c.status.inclination = std::acos(std::clamp(h.z / Norm(h), -1.0, 1.0));
+
+        if (t - c.status.lastBurnTime < box.minBurnSpacing)
+            return;
+
+        double w = box.regime == 0 ? aRef * box.longitudeHalfWidth : box.alongTrackHalfWidth;
+        double hBox = box.regime == 0 ? INFINITY : box.altitudeHalfWidth;
+        double k = 1.5 * n;
+        bool fire = false;
+        double xDotTarget = xDot;
+        if (xDDot > 0)
+        {
+            // Drag: run back to the far edge and return, or stop running away behind the box.
+            if ((x >= 0.9 * w && xDot >= 0) || da < -hBox)
+            {
+                xDotTarget = -std::sqrt(2 * xDDot * std::max(0.0, x + w));
+                fire = true;
+            }
+            else if (x < -w && xDot < 0)
+            {
+                xDotTarget = 0;
+                fire = true;
+            }
+        }
+        else
+        {
+            double rate = w / std::max(box.driftTime, period);
+            if (std::fabs(x) > w && x * xDot >= 0)
+            {
+                xDotTarget = -std::copysign(rate, x);
+                fire = true;
+            }
+            else if ((std::fabs(x) < 0.25 * w && x * xDot < 0 && std::fabs(xDot) > 0.05 * rate) || std::fabs(da) > hBox)
+            {
+                xDotTarget = 0;
+                fire = true;
+            }
+        }
+
+        if (fire)
+        {
+            double daTarget = std::clamp(da - (xDotTarget - xDot) / k, -hBox, hBox);
+            double dv = std::clamp(0.5 * n * (daTarget - da), -box.maxBurn, box.maxBurn);
+            if (std::fabs(dv) > 1e-12)
+            {
+                PlanTangential(catalog, i, c.id, t, period, dv, c.plan);
+                return;
+            }
+        }
+
+        if (box.regime == 0 && box.inclinationMax > 0 && c.status.inclination > box.inclinationMax)
+            PlanInclination(catalog, i, c.id, t, period, c.plan);
+    }
+}
+
+/**
+ * @brief Places a catalog object under station keeping (or replaces its box).
+ * @param id Catalog id.
+ * @param box Dead-band box and limits.
+ * @return 1 on success, 0 if the id is not in the catalog.
+ */
+extern "C" __attribute__((visibility("default"))) int StationKeepingAssign(int id, const StationKeepingBox *box)
+{
+    if (GetCatalog().Find(id) < 0)
+        return 0;
+
+    StationKeeping &sk = GetStationKeeping();
+    auto it = sk.slotOf.find(id);
+    if (it == sk.slotOf.end())
+    {
+        it = sk.slotOf.emplace(id, (int)sk.controllers.size()).first;
+        sk.controllers.push_back({});
+        sk.controllers.back().status.lastBurnTime = -INFINITY;
+    }
+    Controller &c = sk.controllers[it->second];
+    c.id = id;
+    c.box = *box;
+    c.nextCheck = -INFINITY;
+    return 1;
+}
+
+/**
+ * @brief Removes an object from station keeping and cancels its pending maneuvers.
+ * @return 1 if the object was controlled.
+ */
+extern "C" __attribute__((visibility("default"))) int StationKeepingRemove(int id)
+{
+    StationKeeping &sk = GetStationKeeping();
+    auto it = sk.slotOf.find(id);
+    if (it == sk.slotOf.end())
+        return 0;
+
+    int slot = it->second, last = (int)sk.controllers.size() - 1;
+    if (slot != last)
+    {
+        sk.controllers[slot] = std::move(sk.controllers[last]);
+        sk.slotOf[sk.controllers[slot].id] = slot;
+    }
+    sk.controllers.pop_back();
+    sk.slotOf.erase(id);
+    GetManeuverSchedule().CancelObject(id);
+    return 1;
+}
+
+/**
+ * @brief Advances station keeping to the given time.
+ * Controllers are evaluated in parallel at their own cadence (several times per orbit) across the
+ * interval since the previous call, so large warp steps still see every check; planned burns go
+ * through the maneuver schedule, which is executed up to each evaluation time.
+ * @param time Simulation time (s).
+ * @return Number of maneuvers executed.
+ */
+extern "C" __attribute__((visibility("default"))) int StationKeepingUpdate(double time)
+{
+    StationKeeping &sk = GetStationKeeping();
+    ManeuverSchedule &schedule = GetManeuverSchedule();
+    const Catalog &catalog = GetCatalog();
+    double start = std::isnan(sk.lastUpdate) ? time : std::min(sk.lastUpdate, time);
+    sk.lastUpdate = time;
+
+    // Round length: the shortest check interval, coarsened if the step is very large.
+    double interval = INFINITY;
+    for (const Controller &c : sk.controllers)
+    {
+        double a = c.box.regime == 0 ? GeoRadius(catalog.mu) : c.box.semiMajorAxis;
+        interval = std::min(interval, 2 * M_PI * std::sqrt(a * a * a / catalog.mu) / STATION_KEEPING_CHECKS_PER_ORBIT);
+    }
+    interval = std::max(interval, (time - start) / STATION_KEEPING_MAX_ROUNDS);
+    EnsureFrameGrid(start, time + SECONDS_PER_DAY);
+
+    // Executes due maneuvers and books them against their controllers.
+    std::vector<ScheduledManeuver> executed;
+    auto execute = [&](double t)
+    {
+        size_t first = executed.size();
+        schedule.Execute(t, &executed);
+        for (size_t k = first; k < executed.size(); ++k)
+        {
+            const ScheduledManeuver &m = executed[k];
+            auto it = sk.slotOf.find(m.objectId);
+            if (it == sk.slotOf.end())
+                continue;
+            StationKeepingStatus &s = sk.controllers[it->second].status;
+            s.totalDeltaV += Norm(m.deltaV);
+            s.lastBurnTime = m.time;
+            s.burns++;
+        }
+    };
+
+    int rounds = std::isfinite(interval) && interval > 0 ? (int)std::ceil((time - start) / interval) : 0;
+    for (int round = 0; round <= rounds; ++round)
+    {
+        double t = std::min(time, start + round * interval);
+        execute(t);
+
+        ParallelFor((int)sk.controllers.size(), [&](int k)
+        {
+            Controller &c = sk.controllers[k];
+            c.plan.clear();
+            if (c.nextCheck <= t && schedule.Pending(c.id) == 0)
+                Evaluate(c, catalog, t);
+        });
+
+        for (Controller &c : sk.controllers)
+            for (const ScheduledManeuver &m : c.plan)
+                schedule.Add(m.objectId, m.time, m.deltaV);
+        execute(t);
+    }
+    return (int)executed.size();
+}
+
+/**
+ * @brief Reads the controller state of a station-kept object.
+ * @return 1 if the object is controlled.
+ */
+extern "C" __attribute__((visibility("default"))) int StationKeepingGetStatus(int id, StationKeepingStatus *status)
+{
+    StationKeeping &sk = GetStationKeeping();
+    auto it = sk.slotOf.find(id);
+    if (it == sk.slotOf.end())
+        return 0;
+    *status = sk.controllers[it->second].status;
+    status->pending = GetManeuverSchedule().Pending(id);
+    return 1;
+}
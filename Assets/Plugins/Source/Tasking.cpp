@@ -0,0 +1,332 @@
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#include "IntervalTree.h"
+#include "ThreadPool.h"
+
+/**
+ * @file Tasking.cpp
+ * @brief Greedy sensor tasking over access windows to maximise catalog custody.
+ *
+ * An object is in custody for revisitSeconds after the start of each observation of it. The
+ * schedule maximises the priority-weighted time in custody over the horizon. An observation
+ * takes a fixed slot on one sensor, and its sensor must be idle for a settle time on both sides.
+ * The objective is submodular, because an extra observation adds less once the object is
+ * already in custody. It is maximised greedily: each step takes the window and slot start that
+ * add the most weighted custody, then updates the sensor's timeline and the object's custody.
+ *
+ * Each access window is one candidate. Its score is the best gain over the slot starts that fit
+ * the window and the sensor's free time. The gain is piecewise linear in the start, so only the
+ * gaps' ends and the custody boundaries need evaluating. Sensor timelines and custody spans are
+ * interval trees, so these overlap checks touch only nearby intervals. Scores only fall as the
+ * schedule fills, so a stale score is an upper bound. This allows lazy evaluation: candidates
+ * sit in a max-heap, and the top is taken only if it is still current. Otherwise, the stale
+ * entries at the top are rescored together in parallel. The initial scoring of every window is
+ * parallel too.
+ */
+
+const int TASKING_RESCORE_BATCH = 256;   ///< Stale candidates rescored together when the best is out of date.
+const double TASKING_TIME_EPSILON = 1e-6; ///< Slack on slot clearance checks, so back-to-back slots are not lost to rounding (s).
+
+extern "C"
+{
+    /**
+     * @struct TaskingSensor
+     * @brief Observation timing of one sensor; layout must match NativePhysics.TaskingSensor.
+     */
+    struct TaskingSensor
+    {
+        double slotSeconds;   ///< Duration of one observation (s).
+        double settleSeconds; ///< Idle time required before and after each observation (s).
+    };
+
+    /**
+     * @struct TaskingObject
+     * @brief Custody requirement of one object; layout must match NativePhysics.TaskingObject.
+     */
+    struct TaskingObject
+    {
+        double priority;       ///< Weight of this object's custody time.
+        double revisitSeconds; ///< Custody lasts this long after an observation starts (s).
+        double lastObserved;   ///< Start of the last observation before the horizon (s); -inf if none.
+        int objectId;
+        int reserved;
+    };
+
+    /**
+     * @struct TaskingWindow
+     * @brief Interval in which a sensor can observe an object; layout must match NativePhysics.TaskingWindow.
+     */
+    struct TaskingWindow
+    {
+        double start, end; ///< (s)
+        int objectId;
+        int sensor; ///< Index into the sensor array.
+    };
+
+    /**
+     * @struct TaskingAssignment
+     * @brief One scheduled observation; layout must match NativePhysics.TaskingAssignment.
+     */
+    struct TaskingAssignment
+    {
+        double start, end; ///< (s)
+        double gain;       ///< Priority-weighted custody time added (s).
+        int objectId;
+        int sensor;
+    };
+}
+
+namespace
+{
+    struct Candidate
+    {
+        double score;
+        double start;
+        int window;
+        int version; ///< Custody version of the object when scored.
+    };
+
+    /** Heap order: higher score first, then earlier start, then lower window index. */
+    bool Below(const Candidate &a, const Candidate &b)
+    {
+        if (a.score != b.score)
+            return a.score < b.score;
+        if (a.start != b.start)
+            return a.start > b.start;
+        return a.window > b.window;
+    }
+
+    struct Scheduler
+    {
+        const TaskingSensor *sensors;
+        const TaskingObject *objects;
+        const TaskingWindow *windows;
+        std::vector<int> objectOf; ///< Object index of each window, -1 if unusable.
+        double t0, t1;
+
+        std::vector<IntervalTree> busy = {};    ///< Per sensor: scheduled slots.
+        std::vector<IntervalTree> custody = {}; ///< Per object: custody spans.
+        std::vector<int> version = {};          ///< Per object: bumped whenever its custody grows.
+
+        /** Whether a slot starting at start is still free on the window's sensor. */
+        bool Free(int w, double start) const
+        {
+            const TaskingSensor &s = sensors[windows[w].sensor];
+            return !busy[windows[w].sensor].Overlaps(start - s.settleSeconds + TASKING_TIME_EPSILON,
+                                                     start + s.slotSeconds + s.settleSeconds - TASKING_TIME_EPSILON);
+        }
+
+        bool Current(const Candidate &c) const
+        {
+            return c.version == version[objectOf[c.window]] && Free(c.window, c.start);
+        }
+
+        /** Best priority-weighted custody gain of window w, with its slot start. */
+        Candidate Score(int w) const
+        {
+            Candidate c{0, 0, w, 0};
+            int o = objectOf[w];
+            if (o < 0)
+                return c;
+            c.version = version[o];
+            const TaskingWindow &win = windows[w];
+            const TaskingSensor &sensor = sensors[win.sensor];
+            const TaskingObject &object = objects[o];
+            double slot = sensor.slotSeconds, settle = sensor.settleSeconds, revisit = object.revisitSeconds;
+            double lo = std::max(win.start, t0), hi = std::min(win.end, t1) - slot;
+            if (hi < lo)
+                return c;
+
+            // Starts allowed by the sensor timeline: [lo, hi] minus a neighbourhood of each slot.
+            // Busy slots are disjoint, so the blocked ranges arrive sorted.
+            std::vector<std::pair<double, double>> allowed;
+            double from = lo;
+            busy[win.sensor].ForEachOverlap(lo - settle, hi + slot + settle, [&](const IntervalTree::Interval &b)
+            {
+                double blockLo = b.lo - slot - settle, blockHi = b.hi + settle;
+                if (blockLo >= from)
+                    allowed.push_back({from, std::min(blockLo, hi)});
+                from = std::max(from, blockHi);
+                return from <= hi;
+            });
+            if (from <= hi)
+                allowed.push_back({from, hi});
+            allowed.erase(std::remove_if(allowed.begin(), allowed.end(), [](const std::pair<double, double> &a)
+                                         { return a.second < a.first; }),
+                          allowed.end());
+            if (allowed.empty())
+                return c;
+
+            // Existing custody near the window, merged into disjoint spans.
+            std::vector<std::pair<double, double>> held;
+            custody[o].ForEachOverlap(lo, hi + revisit, [&](const IntervalTree::Interval &s)
+            {
+                if (!held.empty() && s.lo <= held.back().second)
+                    held.back().second = std::max(held.back().second, s.hi);
+                else
+                    held.push_back({s.lo, s.hi});
+                return true;
+            });
+            auto gain = [&](double start)
+            {
+                double end = std::min(start + revisit, t1), g = end - start;
+                for (const auto &h : held)
+                    g -= std::max(0.0, std::min(end, h.second) - std::max(start, h.first));
+                return g;
+            };
+
+            // The gain is piecewise linear, with breaks where the start or the custody end meets a boundary.
+            std::vector<double> breaks{t1 - revisit};
+            for (const auto &h : held)
+                breaks.insert(breaks.end(), {h.first, h.second, h.first - revisit, h.second - revisit});
+            double best = 0, bestStart = 0;
+            auto consider = [&](double start)
+            {
+                double g = gain(start);
+                if (g > best || (g == best && g > 0 && start < bestStart))
+                {
+                    best = g;
+                    bestStart = start;
+                }
+            };
+            for (const auto &a : allowed)
+            {
+                consider(a.first);
+                consider(a.second);
+                for (double b : breaks)
+                    if (b > a.first && b < a.second)
+                        consider(b);
+            }
+            c.score = object.priority * best;
+            c.start = bestStart;
+            return c;
+        }
+    };
+}
+
+/**
+ * @brief Schedules observations over access windows, greedily maximising priority-weighted custody.
+ * Windows whose object id is not in objects, or whose sensor index is out of range, are ignored.
+ * @param sensors Sensor timing (sensorCount).
+ * @param objects Objects to keep in custody (objectCount).
+ * @param windows Access windows, e.g. from visibility predictions (windowCount).
+ * @param t0 Horizon start (s).
+ * @param t1 Horizon end (s).
+ * @param assignments Output observations sorted by start time (capacity maxAssignments).
+ * @param maxAssignments Capacity of the output buffer.
+ * @param custodyFraction Optional output per object: fraction of the horizon in custody (objectCount, or null).
+ * @return Number of scheduled observations (may exceed maxAssignments; only the first maxAssignments
+ * are written), or -1 for invalid input.
+ */
+extern "C" __attribute__((visibility("default"))) int TaskingSchedule(const TaskingSensor *sensors, int sensorCount,
+                                                                      const TaskingObject *objects, int objectCount,
+                                                                      const TaskingWindow *windows, int windowCount,
+                                                                      double t0, double t1, TaskingAssignment *assignments,
+                                                                      int maxAssignments, double *custodyFraction)
+{
+    if (!sensors || !objects || !windows || sensorCount <= 0 || objectCount <= 0 || windowCount < 0 || !(t1 > t0))
+        return -1;
+
+    Scheduler sc{sensors, objects, windows, std::vector<int>(windowCount, -1), t0, t1};
+    sc.busy.resize(sensorCount);
+    sc.custody.resize(objectCount);
+    sc.version.assign(objectCount, 0);
+
+    std::unordered_map<int, int> indexOf;
+    for (int o = 0; o < objectCount; ++o)
+    {
+        indexOf.emplace(objects[o].objectId, o);
+        double last = objects[o].lastObserved;
+        if (std::isfinite(last) && last + objects[o].revisitSeconds > t0)
+            sc.custody[o].Insert(last, last + objects[o].revisitSeconds, -1);
+    }
+    for (int w = 0; w < windowCount; ++w)
+    {
+        auto it = indexOf.find(windows[w].objectId);
+        int s = windows[w].sensor;
+        if (it != indexOf.end() && s >= 0 && s < sensorCount && sensors[s].slotSeconds > 0 &&
+            objects[it->second].priority > 0 && objects[it->second].revisitSeconds > 0)
+            sc.objectOf[w] = it->second;
+    }
+
+    std::vector<Candidate> heap(windowCount);
+    ParallelFor(windowCount, [&](int w) { heap[w] = sc.Score(w); });
+    heap.erase(std::remove_if(heap.begin(), heap.end(), [](const Candidate &c) { return c.score <= 0; }), heap.end());
+    std::make_heap(heap.begin(), heap.end(), Below);
+
+    std::vector<TaskingAssignment> scheduled;
+    std::vector<Candidate> batch;
+    while (!heap.empty())
+    {
+        if (sc.Current(heap.front()))
+        {
+            std::pop_heap(heap.begin(), heap.end(), Below);
+            Candidate c = heap.back();
+            heap.pop_back();
+            const TaskingWindow &win = windows[c.window];
+            int o = sc.objectOf[c.window];
+            double end = c.start + sensors[win.sensor].slotSeconds;
+            sc.busy[win.sensor].Insert(c.start, end, c.window);
+            sc.custody[o].Insert(c.start, c.start + objects[o].revisitSeconds, c.window);
+            ++sc.version[o];
+            scheduled.push_back({c.start, end, c.score, win.objectId, win.sensor});
+
+            // The same window may still add custody later on, e.g. a long GEO pass.
+            Candidate again = sc.Score(c.window);
+            if (again.score > 0)
+            {
+                heap.push_back(again);
+                std::push_heap(heap.begin(), heap.end(), Below);
+            }
+            continue;
+        }
+
+        // The best entry is out of date: rescore it together with the entries just below it.
+        batch.clear();
+        while (!heap.empty() && (int)batch.size() < TASKING_RESCORE_BATCH)
+        {
+            std::pop_heap(heap.begin(), heap.end(), Below);
+            batch.push_back(heap.back());
+            heap.pop_back();
+        }
+        ParallelFor((int)batch.size(), [&](int k)
+        {
+            if (!sc.Current(batch[k]))
+                batch[k] = sc.Score(batch[k].window);
+        });
+        for (const Candidate &c : batch)
+        {
+            if (c.score <= 0)
+                continue;
+            heap.push_back(c);
+            std::push_heap(heap.begin(), heap.end(), Below);
+        }
+    }
+
+    if (custodyFraction)
+    {
+        ParallelFor(objectCount, [&](int o)
+        {
+            double covered = 0, reach = t0;
+            sc.custody[o].ForEachOverlap(t0, t1, [&](const IntervalTree::Interval &s)
+            {
+                double lo = std::max(s.lo, reach), hi = std::min(s.hi, t1);
+                if (hi > lo)
+                    covered += hi - lo;
+                reach = std::max(reach, hi);
+                return true;
+            });
+            custodyFraction[o] = covered / (t1 - t0);
+        });
+    }
+
+    std::sort(scheduled.begin(), scheduled.end(), [](const TaskingAssignment &a, const TaskingAssignment &b)
+              { return a.start != b.start ? a.start < b.start : a.sensor < b.sensor; });
+    int total = (int)scheduled.size();
+    if (assignments)
+        std::copy_n(scheduled.begin(), std::min(total, std::max(0, maxAssignments)), assignments);
+    return total;
+}
@@ -0,0 +1,135 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+namespace
+{
+    thread_local bool insideParallelFor = false;
+
+    /**
+     * @brief Fixed set of workers that cooperatively drain one ParallelFor job at a time.
+     */
+    class WorkerPool
+    {
+    public:
+        WorkerPool()
+        {
+            unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+            for (unsigned i = 0; i + 1 < hw; ++i)
+                workers.emplace_back([this]
+                                     { WorkerLoop(); });
+        }
+
+        int ThreadCount() const { return (int)workers.size() + 1; }
+
+        /** Runs the job; returns false if the pool is busy and the caller should run serially. */
+        bool TryRun(int count, const std::function<void(int)> &body)
+        {
+            std::unique_lock<std::mutex> submit(submitMutex, std::try_to_lock);
+            if (!submit.owns_lock())
+                return false;
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = &body;
+                jobCount = count;
+                next.store(0);
+                remaining.store(count);
+                generation++;
+            }
+            wake.notify_all();
+
+            Drain(&body);
+
+            // Workers register under the lock while the job is published, so once none are
+            // active no thread can still hold a pointer to this job.
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]
+                      { return remaining.load() == 0 && activeWorkers == 0; });
+            job = nullptr;
+            return true;
+        }
+
+    private:
+        void WorkerLoop()
+        {
+            insideParallelFor = true;
+            unsigned long seen = 0;
+            for (;;)
+            {
+                const std::function<void(int)> *body;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    wake.wait(lock, [&]
+                              { return generation != seen; });
+                    seen = generation;
+                    body = job;
+                    if (body == nullptr)
+                        continue;
+                    activeWorkers++;
+                }
+
+                Drain(body);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    activeWorkers--;
+                }
+                done.notify_all();
+            }
+        }
+
+        void Drain(const std::function<void(int)> *body)
+        {
+            bool wasInside = insideParallelFor;
+            insideParallelFor = true;
+            for (int i = next.fetch_add(1); i < jobCount; i = next.fetch_add(1))
+            {
+                (*body)(i);
+                remaining.fetch_sub(1);
+            }
+            insideParallelFor = wasInside;
+        }
+
+        std::vector<std::thread> workers;
+        std::mutex submitMutex;
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable done;
+        const std::function<void(int)> *job = nullptr;
+        int jobCount = 0;
+        int activeWorkers = 0;
+        std::atomic<int> next{0};
+        std::atomic<int> remaining{0};
+        unsigned long generation = 0;
+    };
+
+    WorkerPool &Pool()
+    {
+        // Intentionally leaked: joining workers during DLL unload can deadlock on Windows.
+        static WorkerPool *pool = new WorkerPool();
+        return *pool;
+    }
+}
+
+void ParallelFor(int count, const std::function<void(int)> &body)
+{
+    if (count <= 0)
+        return;
+
+    if (count == 1 || insideParallelFor || !Pool().TryRun(count, body))
+    {
+        for (int i = 0; i < count; ++i)
+            body(i);
+    }
+}
+
+int ParallelThreadCount()
+{
+    return Pool().ThreadCount();
+}
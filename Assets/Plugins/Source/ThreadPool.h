@@ -0,0 +1,25 @@
+#pragma once
+
+#include <functional>
+
+/**
+ * @file ThreadPool.h
+ * @brief Shared worker pool for the batch jobs of the physics plugin.
+ *
+ * The pool is created lazily on first use with one worker per hardware thread (minus the
+ * caller, which also takes work). ParallelFor calls issued from inside a worker, or while
+ * another ParallelFor is running, execute serially on the calling thread, so kernels can
+ * nest without deadlocking.
+ */
+
+/**
+ * @brief Runs body(i) for every i in [0, count) across the worker pool and waits for completion.
+ * @param count Number of iterations.
+ * @param body Work item; must be safe to run concurrently for different i.
+ */
+void ParallelFor(int count, const std::function<void(int)> &body);
+
+/**
+ * @brief Number of threads that participate in a ParallelFor (workers plus the caller).
+ */
+int ParallelThreadCount();
@@ -0,0 +1,311 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "Frames.h"
+#include "ThreadPool.h"
+#include "TimeScales.h"
+
+namespace
+{
+    const double NTP_EPOCH_MJD = 15020.0; ///< MJD of 1900-01-01, the origin of leap-seconds.list timestamps.
+    const int TIME_BLOCK = 1024;          ///< Dates per work item of the batch kernels.
+
+    /** Start of a TAI - UTC step: the UTC date (MJD) from which it applies. */
+    struct LeapSecond
+    {
+        double mjd;
+        double taiMinusUtc;
+        double ttMjd; ///< The same instant as a TT MJD, for lookups from the TT side.
+    };
+
+    std::vector<LeapSecond> MakeTable(const std::vector<std::pair<double, double>> &steps)
+    {
+        std::vector<LeapSecond> table;
+        for (const auto &s : steps)
+            table.push_back({s.first, s.second, s.first + (s.second + TT_MINUS_TAI) / SECONDS_PER_DAY});
+        return table;
+    }
+
+    /** Leap seconds through the 2017-01-01 step. */
+    std::vector<LeapSecond> &GetLeapTable()
+    {
+        static std::vector<LeapSecond> table = MakeTable({
+            {41317, 10}, {41499, 11}, {41683, 12}, {42048, 13}, {42413, 14}, {42778, 15}, {43144, 16},
+            {43509, 17}, {43874, 18}, {44239, 19}, {44786, 20}, {45151, 21}, {45516, 22}, {46247, 23},
+            {47161, 24}, {47892, 25}, {48257, 26}, {48804, 27}, {49169, 28}, {49534, 29}, {50083, 30},
+            {50630, 31}, {51179, 32}, {53736, 33}, {54832, 34}, {56109, 35}, {57204, 36}, {57754, 37},
+        });
+        return table;
+    }
+
+    JulianDate epoch{J2000_JD - 0.5, 0.5}; ///< TT date of simulation time 0.
+
+    double Mjd(const JulianDate &jd)
+    {
+        return (jd.day - MJD_ZERO) + jd.fraction;
+    }
+
+    /** TAI - UTC in effect at a TT date. */
+    double TaiMinusUtcAtTT(const JulianDate &tt)
+    {
+        const std::vector<LeapSecond> &table = GetLeapTable();
+        double mjd = Mjd(tt);
+        if (mjd >= table.back().ttMjd)
+            return table.back().taiMinusUtc;
+        auto it = std::upper_bound(table.begin(), table.end(), mjd,
+                                   [](double m, const LeapSecond &l) { return m < l.ttMjd; });
+        return it == table.begin() ? table.front().taiMinusUtc : std::prev(it)->taiMinusUtc;
+    }
+
+    JulianDate UtcToTai(const JulianDate &utc)
+    {
+        JulianDate d = NormalizeDate(utc.day, utc.fraction);
+        double dat0 = TaiMinusUtc({d.day, 0});
+        double dat24 = TaiMinusUtc({d.day + 1, 0});
+        // A leap second lengthens the UTC day; the fraction counts that longer day.
+        double fraction = d.fraction * (SECONDS_PER_DAY + dat24 - dat0) / SECONDS_PER_DAY;
+        return AddSeconds({d.day, fraction}, dat0);
+    }
+
+    JulianDate TaiToUtc(const JulianDate &tai)
+    {
+        JulianDate utc = AddSeconds(tai, -TaiMinusUtc(tai));
+        for (int iter = 0; iter < 3; ++iter)
+            utc = AddSeconds(utc, SecondsBetween(tai, UtcToTai(utc)));
+        return utc;
+    }
+
+    JulianDate ToTT(const JulianDate &jd, TimeScale from)
+    {
+        switch (from)
+        {
+        case SCALE_UTC:
+            return AddSeconds(UtcToTai(jd), TT_MINUS_TAI);
+        case SCALE_TAI:
+            return AddSeconds(jd, TT_MINUS_TAI);
+        case SCALE_TDB:
+            return AddSeconds(jd, -TdbMinusTT(jd));
+        default:
+            return NormalizeDate(jd.day, jd.fraction);
+        }
+    }
+
+    JulianDate FromTT(const JulianDate &tt, TimeScale to)
+    {
+        switch (to)
+        {
+        case SCALE_UTC:
+            return TaiToUtc(AddSeconds(tt, -TT_MINUS_TAI));
+        case SCALE_TAI:
+            return AddSeconds(tt, -TT_MINUS_TAI);
+        case SCALE_TDB:
+            return AddSeconds(tt, TdbMinusTT(tt));
+        default:
+            return NormalizeDate(tt.day, tt.fraction);
+        }
+    }
+
+    bool ValidScale(int scale)
+    {
+        return scale >= SCALE_UTC && scale <= SCALE_TDB;
+    }
+}
+
+JulianDate NormalizeDate(double day, double fraction)
+{
+    double whole = std::floor(day - 0.5) + 0.5;
+    fraction += day - whole;
+    double carry = std::floor(fraction);
+    return {whole + carry, fraction - carry};
+}
+
+JulianDate AddSeconds(const JulianDate &jd, double seconds)
+{
+    return NormalizeDate(jd.day, jd.fraction + seconds / SECONDS_PER_DAY);
+}
+
+double SecondsBetween(const JulianDate &a, const JulianDate &b)
+{
+    return ((a.day - b.day) + (a.fraction - b.fraction)) * SECONDS_PER_DAY;
+}
+
+double TaiMinusUtc(const JulianDate &utc)
+{
+    const std::vector<LeapSecond> &table = GetLeapTable();
+    double mjd = Mjd(utc);
+    auto it = std::upper_bound(table.begin(), table.end(), mjd,
+                               [](double m, const LeapSecond &l) { return m < l.mjd; });
+    return it == table.begin() ? table.front().taiMinusUtc : std::prev(it)->taiMinusUtc;
+}
+
+double TdbMinusTT(const JulianDate &tt)
+{
+    double t = ((tt.day - J2000_JD) + tt.fraction) / DAYS_PER_CENTURY;
+    return 0.001657 * std::sin(628.3076 * t + 6.2401) + 0.000022 * std::sin(575.3385 * t + 4.2970) +
+           0.000014 * std::sin(1256.6152 * t + 6.1969) + 0.000005 * std::sin(606.9777 * t + 4.0212) +
+           0.000005 * std::sin(52.9691 * t + 0.4444) + 0.000002 * std::sin(21.3299 * t + 5.5431) +
+           0.000010 * t * std::sin(628.3076 * t + 4.2490);
+}
+
+JulianDate ConvertTime(const JulianDate &jd, TimeScale from, TimeScale to)
+{
+    if (from == to)
+        return NormalizeDate(jd.day, jd.fraction);
+    return FromTT(ToTT(jd, from), to);
+}
+
+JulianDate SimulationEpoch()
+{
+    return epoch;
+}
+
+JulianDate SimulationToTT(double t)
+{
+    return AddSeconds(epoch, t);
+}
+
+double UtcMinusTT(double t)
+{
+    return -(TaiMinusUtcAtTT(SimulationToTT(t)) + TT_MINUS_TAI);
+}
+
+/**
+ * @brief Loads TAI - UTC steps from a leap-seconds.list file (IETF/IERS format).
+ * Data lines hold the NTP timestamp (s since 1900-01-01) of each step and the new TAI - UTC;
+ * lines starting with '#' are comments. The built-in table is kept if the file cannot be used.
+ * Not thread-safe; call before running conversions.
+ * @param path Path to the file.
+ * @return Number of steps loaded, or 0 on failure.
+ */
+extern "C" __attribute__((visibility("default"))) int TimeLoadLeapSeconds(const char *path)
+{
+    FILE *f = std::fopen(path, "r");
+    if (!f)
+    {
+        LogDebug(std::string("[TimeLoadLeapSeconds] Cannot open ") + path);
+        return 0;
+    }
+    std::vector<std::pair<double, double>> steps;
+    char line[256];
+    bool ok = true;
+    while (ok && std::fgets(line, sizeof(line), f))
+    {
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r')
+            continue;
+        double ntp, offset;
+        ok = std::sscanf(line, "%lf %lf", &ntp, &offset) == 2 &&
+             (steps.empty() || (ntp > steps.back().first && offset > steps.back().second));
+        if (ok)
+            steps.push_back({ntp, offset});
+    }
+    std::fclose(f);
+    if (!ok || steps.empty())
+    {
+        LogDebug(std::string("[TimeLoadLeapSeconds] Malformed leap-second file ") + path);
+        return 0;
+    }
+    for (auto &s : steps)
+        s.first = s.first / SECONDS_PER_DAY + NTP_EPOCH_MJD;
+    GetLeapTable() = MakeTable(steps);
+    ResetFrameGrid();
+    return (int)steps.size();
+}
+
+/**
+ * @brief Sets the date of simulation time 0 and discards cached frame data.
+ * @param scale Time scale of the date (TimeScale).
+ * @param date Two-part Julian date.
+ * @return 1 on success, 0 for an unknown time scale.
+ */
+extern "C" __attribute__((visibility("default"))) int TimeSetEpoch(int scale, JulianDate date)
+{
+    if (!ValidScale(scale))
+        return 0;
+    epoch = ToTT(date, (TimeScale)scale);
+    ResetFrameGrid();
+    return 1;
+}
+
+/**
+ * @brief Date of simulation time 0 in a given time scale.
+ * @param scale Time scale (TimeScale).
+ * @param date Output two-part Julian date.
+ * @return 1 on success, 0 for an unknown time scale.
+ */
+extern "C" __attribute__((visibility("default"))) int TimeGetEpoch(int scale, JulianDate *date)
+{
+    if (!ValidScale(scale))
+        return 0;
+    *date = FromTT(epoch, (TimeScale)scale);
+    return 1;
+}
+
+/**
+ * @brief Converts dates between time scales in parallel blocks.
+ * @param dates Input dates.
+ * @param count Number of dates.
+ * @param from Time scale of the input (TimeScale).
+ * @param to Time scale of the output (TimeScale).
+ * @param out Output dates, normalised; may alias dates.
+ * @return 1 on success, 0 for an unknown time scale.
+ */
+extern "C" __attribute__((visibility("default"))) int TimeConvertBatch(const JulianDate *dates, int count, int from, int to,
+                                                                       JulianDate *out)
+{
+    if (!ValidScale(from) || !ValidScale(to))
+        return 0;
+    ParallelFor((count + TIME_BLOCK - 1) / TIME_BLOCK, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * TIME_BLOCK);
+        for (int k = b * TIME_BLOCK; k < end; ++k)
+            out[k] = ConvertTime(dates[k], (TimeScale)from, (TimeScale)to);
+    });
+    return 1;
+}
+
+/**
+ * @brief Converts simulation times to dates in a given time scale.
+ * @param times Simulation times (s).
+ * @param count Number of times.
+ * @param scale Time scale of the output (TimeScale).
+ * @param out Output dates.
+ * @return 1 on success, 0 for an unknown time scale.
+ */
+extern "C" __attribute__((visibility("default"))) int TimeSimulationToDateBatch(const double *times, int count, int scale,
+                                                                                JulianDate *out)
+{
+    if (!ValidScale(scale))
+        return 0;
+    ParallelFor((count + TIME_BLOCK - 1) / TIME_BLOCK, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * TIME_BLOCK);
+        for (int k = b * TIME_BLOCK; k < end; ++k)
+            out[k] = FromTT(SimulationToTT(times[k]), (TimeScale)scale);
+    });
+    return 1;
+}
+
+/**
+ * @brief Converts dates in a given time scale to simulation times.
+ * @param dates Input dates.
+ * @param count Number of dates.
+ * @param scale Time scale of the input (TimeScale).
+ * @param times Output simulation times (s).
+ * @return 1 on success, 0 for an unknown time scale.
+ */
+extern "C" __attribute__((visibility("default"))) int TimeDateToSimulationBatch(const JulianDate *dates, int count, int scale,
+                                                                                double *times)
+{
+    if (!ValidScale(scale))
+        return 0;
+    ParallelFor((count + TIME_BLOCK - 1) / TIME_BLOCK, [&](int b)
+    {
+        int end = std::min(count, (b + 1) * TIME_BLOCK);
+        for (int k = b * TIME_BLOCK; k < end; ++k)
+            times[k] = SecondsBetween(ToTT(dates[k], (TimeScale)scale), epoch);
+    });
+    return 1;
+}
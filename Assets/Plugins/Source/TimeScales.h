@@ -0,0 +1,82 @@
+#pragma once
+
+#include "PhysicsCommon.h"
+
+/**
+ * @file TimeScales.h
+ * @brief Two-part Julian dates and conversions between UTC, TAI, TT and TDB.
+ *
+ * A date is carried as a whole-day part aligned to midnight (x.5) plus a fraction of the day in
+ * [0, 1), so the fraction resolves picoseconds and a UTC day containing a leap second can be
+ * stretched to 86401 s. TAI - UTC comes from a leap-second table (built in, replaceable from an
+ * IETF/IERS leap-seconds.list file); dates before 1972 use the 1972 offset. TDB - TT uses the
+ * leading periodic terms of Fairhead & Bretagnon (about 10 µs).
+ *
+ * Simulation time t (s) is measured in TT from the simulation epoch.
+ */
+
+const double J2000_JD = 2451545.0;   ///< Julian date of J2000.0 (TT).
+const double MJD_ZERO = 2400000.5;   ///< Julian date of MJD 0.
+const double SECONDS_PER_DAY = 86400.0;
+const double DAYS_PER_CENTURY = 36525.0;
+const double TT_MINUS_TAI = 32.184;  ///< TT - TAI (s).
+
+enum TimeScale
+{
+    SCALE_UTC = 0,
+    SCALE_TAI = 1,
+    SCALE_TT = 2,
+    SCALE_TDB = 3,
+};
+
+extern "C"
+{
+    /**
+     * @struct JulianDate
+     * @brief Two-part Julian date; layout must match NativePhysics.JulianDate.
+     */
+    struct JulianDate
+    {
+        double day;      ///< Whole-day part (midnight-aligned after normalisation).
+        double fraction; ///< Remaining days, in [0, 1) after normalisation.
+    };
+}
+
+/**
+ * @brief Splits a date so day is midnight-aligned and fraction lies in [0, 1).
+ */
+JulianDate NormalizeDate(double day, double fraction);
+
+/**
+ * @brief Adds seconds to a date without losing the fraction's precision.
+ */
+JulianDate AddSeconds(const JulianDate &jd, double seconds);
+
+/**
+ * @brief Difference a - b in seconds.
+ */
+double SecondsBetween(const JulianDate &a, const JulianDate &b);
+
+/**
+ * @brief TAI - UTC (s) in effect on a UTC date.
+ */
+double TaiMinusUtc(const JulianDate &utc);
+
+/**
+ * @brief TDB - TT (s) at a TT date.
+ */
+double TdbMinusTT(const JulianDate &tt);
+
+/**
+ * @brief Converts a date between time scales.
+ */
+JulianDate ConvertTime(const JulianDate &jd, TimeScale from, TimeScale to);
+
+/** TT date of simulation time 0. */
+JulianDate SimulationEpoch();
+
+/** TT date of simulation time t (s). */
+JulianDate SimulationToTT(double t);
+
+/** UTC - TT at simulation time t (s), from the leap-second table. */
+double UtcMinusTT(double t);
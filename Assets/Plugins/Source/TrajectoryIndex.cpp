@@ -0,0 +1,402 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "Bvh.h"
+#include "Catalog.h"
+#include "ThreadPool.h"
+
+/**
+ * @file TrajectoryIndex.cpp
+ * @brief Spatio-temporal index of propagated catalog trajectories for volume-transit queries.
+ *
+ * The catalog is propagated once over a span and stored as states at a fixed step (single
+ * precision, object-major). Consecutive states define cubic Hermite segments, whose Bézier
+ * control points bound the curve. Time is cut into buckets of several steps, and each bucket
+ * holds a BVH over one box per object enclosing all its segments in the bucket. A query visits
+ * only the buckets overlapping its window, collects candidates from their BVHs, and locates the
+ * first entry into the region by Bézier subdivision, without propagating again.
+ *
+ * The index is a snapshot of the catalog. After catalog edits, a refresh re-propagates only the
+ * entries whose revision changed (and appends new ones) before rebuilding the bucket BVHs. Memory
+ * is about 24 bytes per object and sample plus one BVH leaf per object and bucket.
+ */
+
+const double TRANSIT_TIME_TOLERANCE = 1.0; ///< Resolution of the reported entry times (s).
+
+enum TransitRegionType
+{
+    TRANSIT_BOX = 0,
+    TRANSIT_CORRIDOR = 1,
+};
+
+extern "C"
+{
+    /**
+     * @struct TransitRegion
+     * @brief Query volume; layout must match NativePhysics.TransitRegion.
+     * A box spans [a, b]; a corridor is every point within radius of the segment a-b
+     * (a sphere when a == b). Coordinates are inertial, relative to Earth (units).
+     */
+    struct TransitRegion
+    {
+        double3 a;
+        double3 b;
+        double radius; ///< Corridor radius (units).
+        int type;      ///< 0 box, 1 corridor.
+        int reserved;
+    };
+
+    /**
+     * @struct TransitHit
+     * @brief First entry of an object into a query region; layout must match NativePhysics.TransitHit.
+     */
+    struct TransitHit
+    {
+        double entryTime; ///< First time inside the region within the query window (s).
+        int objectId;
+        int reserved;
+    };
+}
+
+namespace
+{
+    struct Bucket
+    {
+        Bvh bvh;
+        std::vector<int> objects; ///< Object index of each BVH item.
+    };
+
+    struct TrajectoryIndex
+    {
+        double t0 = 0, step = 0;
+        int samples = 0, bucketSteps = 0;
+        std::vector<int> ids;
+        std::vector<int> validSamples; ///< Samples propagated before an object failed or decayed.
+        std::vector<Vector3> pos, vel; ///< Object-major samples.
+        std::vector<Bucket> buckets;
+        uint64_t synced = 0; ///< Catalog change counter the samples reflect.
+
+        double End() const { return t0 + (samples - 1) * step; }
+
+        /** Bézier control points of segment k of object o (times t0 + k·step to t0 + (k+1)·step). */
+        void ControlPoints(int o, int k, Vector3d c[4]) const
+        {
+            size_t s = (size_t)o * samples + k;
+            Vector3d p0 = ToVector3dFromVector3(pos[s]), p1 = ToVector3dFromVector3(pos[s + 1]);
+            c[0] = p0;
+            c[1] = p0 + (step / 3) * ToVector3dFromVector3(vel[s]);
+            c[2] = p1 - (step / 3) * ToVector3dFromVector3(vel[s + 1]);
+            c[3] = p1;
+        }
+    };
+
+    TrajectoryIndex &GetTrajectoryIndex()
+    {
+        static TrajectoryIndex index;
+        return index;
+    }
+
+    /** Samples object o from catalog entry i (i < 0 leaves it without samples). */
+    void SampleObject(TrajectoryIndex &index, const Catalog &catalog, int o, int i)
+    {
+        size_t base = (size_t)o * index.samples;
+        int k = 0;
+        for (; i >= 0 && k < index.samples; ++k)
+        {
+            Vector3d r, v;
+            if (!catalog.StateAt(i, index.t0 + k * index.step, r, v))
+                break;
+            index.pos[base + k] = {(float)r.x, (float)r.y, (float)r.z};
+            index.vel[base + k] = {(float)v.x, (float)v.y, (float)v.z};
+        }
+        index.validSamples[o] = k;
+    }
+
+    /** Builds one BVH per bucket over the objects' segment bounds. */
+    void BuildBuckets(TrajectoryIndex &index)
+    {
+        int n = (int)index.ids.size();
+        int segments = index.samples - 1;
+        index.buckets.assign((segments + index.bucketSteps - 1) / index.bucketSteps, Bucket{});
+        ParallelFor((int)index.buckets.size(), [&](int b)
+        {
+            Bucket &bucket = index.buckets[b];
+            std::vector<Aabb> boxes;
+            int k0 = b * index.bucketSteps, k1 = std::min(segments, k0 + index.bucketSteps);
+            for (int o = 0; o < n; ++o)
+            {
+                int last = std::min(k1, index.validSamples[o] - 1);
+                if (last <= k0)
+                    continue;
+                Aabb box;
+                Vector3d c[4];
+                for (int k = k0; k < last; ++k)
+                {
+                    index.ControlPoints(o, k, c);
+                    for (const Vector3d &p : c)
+                        box.Grow(p);
+                }
+                boxes.push_back(box);
+                bucket.objects.push_back(o);
+            }
+            bucket.bvh.Build(boxes);
+        });
+    }
+
+    /** De Casteljau split of a cubic at parameter u. */
+    void Split(const Vector3d c[4], double u, Vector3d left[4], Vector3d right[4])
+    {
+        Vector3d ab = c[0] + u * (c[1] - c[0]), bc = c[1] + u * (c[2] - c[1]), cd = c[2] + u * (c[3] - c[2]);
+        Vector3d abc = ab + u * (bc - ab), bcd = bc + u * (cd - bc);
+        Vector3d m = abc + u * (bcd - abc);
+        left[0] = c[0], left[1] = ab, left[2] = abc, left[3] = m;
+        right[0] = m, right[1] = bcd, right[2] = cd, right[3] = c[3];
+    }
+
+    struct Region
+    {
+        const TransitRegion &r;
+        Vector3d a, b;
+        Aabb bounds;
+
+        explicit Region(const TransitRegion &region)
+            : r(region), a(ToVector3dFromDouble3(region.a)), b(ToVector3dFromDouble3(region.b))
+        {
+            bounds.Grow(a);
+            bounds.Grow(b);
+            if (r.type == TRANSIT_CORRIDOR)
+                bounds.Pad(r.radius);
+        }
+
+        double SegmentDistance(const Vector3d &p) const
+        {
+            Vector3d ab = b - a;
+            double len2 = Dot(ab, ab);
+            double s = len2 > 0 ? std::clamp(Dot(p - a, ab) / len2, 0.0, 1.0) : 0.0;
+            return Norm(p - (a + s * ab));
+        }
+
+        bool Contains(const Vector3d &p) const
+        {
+            if (r.type == TRANSIT_CORRIDOR)
+                return SegmentDistance(p) <= r.radius;
+            return bounds.DistanceSq(p) == 0;
+        }
+
+        /** Conservative overlap test: false only if the box and region are disjoint. */
+        bool MayOverlap(const Aabb &box) const
+        {
+            if (!box.Overlaps(bounds))
+                return false;
+            if (r.type != TRANSIT_CORRIDOR)
+                return true;
+            double halfDiagonal = 0.5 * Norm(box.hi - box.lo);
+            return SegmentDistance(box.Center()) <= r.radius + halfDiagonal;
+        }
+    };
+
+    /** Earliest time in [ta, tb] at which the cubic is inside the region, to the time tolerance. */
+    bool FirstEntry(const Vector3d c[4], double ta, double tb, const Region &region, double &t)
+    {
+        if (region.Contains(c[0]))
+        {
+            t = ta;
+            return true;
+        }
+        Aabb hull;
+        for (int k = 0; k < 4; ++k)
+            hull.Grow(c[k]);
+        if (!region.MayOverlap(hull))
+            return false;
+
+        Vector3d left[4], right[4];
+        Split(c, 0.5, left, right);
+        double tm = 0.5 * (ta + tb);
+        if (tb - ta <= TRANSIT_TIME_TOLERANCE)
+        {
+            for (double u : {0.5, 1.0})
+            {
+                if (region.Contains(u < 1 ? left[3] : c[3]))
+                {
+                    t = u < 1 ? tm : tb;
+                    return true;
+                }
+            }
+            return false;
+        }
+        return FirstEntry(left, ta, tm, region, t) || FirstEntry(right, tm, tb, region, t);
+    }
+}
+
+/**
+ * @brief Propagates the catalog over a span and builds the trajectory index.
+ * @param t0 Start of the span (s).
+ * @param t1 End of the span (s).
+ * @param step Sample step (s); the Hermite segments are accurate to a few km at 60-120 s in LEO.
+ * @param bucketSteps Segments per time bucket (each bucket holds one BVH).
+ * @return Number of objects indexed, 0 on invalid arguments.
+ */
+extern "C" __attribute__((visibility("default"))) int TrajectoryIndexBuild(double t0, double t1, double step, int bucketSteps)
+{
+    TrajectoryIndex &index = GetTrajectoryIndex();
+    index = TrajectoryIndex{};
+    if (!(step > 0) || !(t1 > t0) || bucketSteps < 1)
+    {
+        LogDebug("[TrajectoryIndexBuild] Invalid span, step or bucket size.");
+        return 0;
+    }
+
+    const Catalog &catalog = GetCatalog();
+    int n = catalog.Count();
+    index.t0 = t0;
+    index.step = step;
+    index.samples = (int)std::ceil((t1 - t0) / step) + 1;
+    index.bucketSteps = bucketSteps;
+    index.ids = catalog.ids;
+    index.validSamples.assign(n, 0);
+    index.pos.resize((size_t)n * index.samples);
+    index.vel.resize((size_t)n * index.samples);
+    index.synced = catalog.changeCounter;
+
+    ParallelFor(n, [&](int o)
+                { SampleObject(index, catalog, o, o); });
+    BuildBuckets(index);
+    return n;
+}
+
+/**
+ * @brief Brings the trajectory index up to date with catalog edits made since it was built.
+ * Entries whose revision changed are re-propagated, new entries are appended and removed ones
+ * drop out; everything else keeps its samples. The bucket BVHs are then rebuilt.
+ * @return Number of objects whose samples changed, or -1 if there is no index.
+ */
+extern "C" __attribute__((visibility("default"))) int TrajectoryIndexRefresh()
+{
+    TrajectoryIndex &index = GetTrajectoryIndex();
+    const Catalog &catalog = GetCatalog();
+    if (index.samples < 2)
+        return -1;
+    if (catalog.changeCounter == index.synced)
+        return 0;
+
+    std::vector<int> entry(index.ids.size()), stale;
+    std::vector<char> indexed(catalog.Count(), 0);
+    for (int o = 0; o < (int)index.ids.size(); ++o)
+    {
+        entry[o] = catalog.Find(index.ids[o]);
+        if (entry[o] >= 0)
+            indexed[entry[o]] = 1;
+        if (entry[o] < 0 ? index.validSamples[o] > 0 : catalog.revision[entry[o]] > index.synced)
+            stale.push_back(o);
+    }
+    for (int i = 0; i < catalog.Count(); ++i)
+    {
+        if (indexed[i])
+            continue;
+        stale.push_back((int)index.ids.size());
+        entry.push_back(i);
+        index.ids.push_back(catalog.ids[i]);
+        index.validSamples.push_back(0);
+    }
+    index.pos.resize(index.ids.size() * index.samples);
+    index.vel.resize(index.ids.size() * index.samples);
+
+    ParallelFor((int)stale.size(), [&](int s)
+                { SampleObject(index, catalog, stale[s], entry[stale[s]]); });
+    BuildBuckets(index);
+    index.synced = catalog.changeCounter;
+    return (int)stale.size();
+}
+
+/**
+ * @brief Finds the indexed objects that pass through a region during a time window.
+ * @param region Box or corridor to test.
+ * @param ta Window start (s), clamped to the indexed span.
+ * @param tb Window end (s), clamped to the indexed span.
+ * @param hits Output first entries, sorted by entry time (capacity maxHits).
+ * @param maxHits Capacity of the output buffer.
+ * @return Number of objects that transit the region (may exceed maxHits).
+ */
+extern "C" __attribute__((visibility("default"))) int TrajectoryIndexQuery(const TransitRegion *region, double ta, double tb,
+                                                                           TransitHit *hits, int maxHits)
+{
+    const TrajectoryIndex &index = GetTrajectoryIndex();
+    if (index.samples < 2)
+        return 0;
+    ta = std::max(ta, index.t0);
+    tb = std::min(tb, index.End());
+    if (tb < ta)
+        return 0;
+
+    Region volume(*region);
+    double bucketSpan = index.bucketSteps * index.step;
+    int b0 = std::min((int)((ta - index.t0) / bucketSpan), (int)index.buckets.size() - 1);
+    int b1 = std::min((int)((tb - index.t0) / bucketSpan), (int)index.buckets.size() - 1);
+
+    // Buckets are visited in time order, so the first entry found for an object is its earliest.
+    std::vector<char> found(index.ids.size(), 0);
+    std::vector<TransitHit> out;
+    std::vector<int> candidates;
+    for (int b = b0; b <= b1; ++b)
+    {
+        const Bucket &bucket = index.buckets[b];
+        candidates.clear();
+        bucket.bvh.Traverse([&](const Aabb &box)
+                            { return volume.MayOverlap(box); },
+                            [&](int item)
+                            {
+                                if (!found[bucket.objects[item]])
+                                    candidates.push_back(bucket.objects[item]);
+                            });
+
+        int k0 = b * index.bucketSteps;
+        int k1 = std::min(index.samples - 1, k0 + index.bucketSteps);
+        for (int o : candidates)
+        {
+            int last = std::min(k1, index.validSamples[o] - 1);
+            for (int k = k0; k < last; ++k)
+            {
+                double s0 = index.t0 + k * index.step, s1 = s0 + index.step;
+                if (s1 < ta || s0 > tb)
+                    continue;
+
+                // Clip the segment to the query window.
+                Vector3d c[4], left[4], right[4];
+                index.ControlPoints(o, k, c);
+                double u0 = std::max(0.0, (ta - s0) / index.step), u1 = std::min(1.0, (tb - s0) / index.step);
+                if (u1 < 1)
+                {
+                    Split(c, u1, left, right);
+                    std::copy(left, left + 4, c);
+                }
+                if (u0 > 0)
+                {
+                    Split(c, u0 / u1, left, right);
+                    std::copy(right, right + 4, c);
+                }
+
+                double t;
+                if (FirstEntry(c, s0 + u0 * index.step, s0 + u1 * index.step, volume, t))
+                {
+                    found[o] = 1;
+                    out.push_back({t, index.ids[o], 0});
+                    break;
+                }
+            }
+        }
+    }
+
+    std::sort(out.begin(), out.end(), [](const TransitHit &a, const TransitHit &b)
+              { return a.entryTime < b.entryTime; });
+    std::copy(out.begin(), out.begin() + std::min((int)out.size(), maxHits), hits);
+    return (int)out.size();
+}
+
+/**
+ * @brief Releases the trajectory index.
+ */
+extern "C" __attribute__((visibility("default"))) void TrajectoryIndexClear()
+{
+    GetTrajectoryIndex() = TrajectoryIndex{};
+}
@@ -0,0 +1,354 @@
+#include <cmath>
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "PhysicsCommon.h"
+#include "Kepler.h"
+#include "ThreadPool.h"
+
+/**
+ * @file TransferSearch.cpp
+ * @brief Global search for multi-impulse rendezvous transfers with differential evolution.
+ *
+ * A candidate is a wait time, a number of free impulses each followed by a coast, and a
+ * final Lambert arc that closes onto the target:
+ *
+ *   x = [t_wait, dv_1 (3), coast_1, ..., dv_k (3), coast_k, tof]
+ *
+ * The chaser coasts for t_wait, applies each free impulse and coasts, then leaves on the
+ * Lambert arc to the target's position at arrival and matches its velocity there, so a
+ * candidate always describes k + 2 impulses. Cost is the total delta-v. Every generation
+ * of the DE/rand/1/bin search is evaluated in parallel on the worker pool; the random
+ * numbers are drawn serially, so results are reproducible for a given seed.
+ */
+
+const int TRANSFER_MAX_FREE_IMPULSES = 4;     ///< Free impulses before the closing Lambert arc.
+const double TRANSFER_PENALTY = 1e9;          ///< Cost of an infeasible candidate.
+const double TRANSFER_DE_CROSSOVER = 0.9;     ///< DE crossover probability.
+const double TRANSFER_DE_WEIGHT_MIN = 0.5;    ///< Dithered differential weight range.
+const double TRANSFER_DE_WEIGHT_MAX = 1.0;
+
+extern "C"
+{
+    /**
+     * @struct TransferSearchSettings
+     * @brief Bounds and DE parameters for TransferSearch. Layout must match NativePhysics.TransferSearchSettings.
+     */
+    struct TransferSearchSettings
+    {
+        double maxWait;         ///< Upper bound on the initial wait (s).
+        double minTimeOfFlight; ///< Lower bound on the closing Lambert arc (s).
+        double maxTimeOfFlight; ///< Upper bound on the closing Lambert arc (s).
+        double maxCoast;        ///< Upper bound on each coast after a free impulse (s).
+        double maxImpulse;      ///< Bound on each component of a free impulse (units/s).
+        double minRadius;       ///< Arcs whose periapsis passes below this radius are rejected (units).
+        int freeImpulses;       ///< Free impulses (0 gives a classic two-impulse transfer).
+        int populationSize;     ///< DE population size.
+        int generations;        ///< DE generations.
+        unsigned int seed;      ///< Random seed.
+    };
+
+    /**
+     * @struct TransferSolution
+     * @brief Best transfer found for one target. Layout must match NativePhysics.TransferSolution.
+     */
+    struct TransferSolution
+    {
+        double totalDeltaV; ///< Sum of impulse magnitudes (units/s).
+        double arrivalTime; ///< Time of rendezvous from the search epoch (s).
+        int numImpulses;    ///< Impulses written to the impulse arrays.
+        int feasible;       ///< Non-zero if a feasible transfer was found.
+    };
+}
+
+namespace
+{
+    /** Chaser, target and central body for one search. */
+    struct TransferProblem
+    {
+        Vector3d chaserPos, chaserVel, targetPos, targetVel;
+        double mu;
+        TransferSearchSettings settings;
+
+        int Dimension() const { return 2 + 4 * settings.freeImpulses; }
+
+        void Bounds(double *lo, double *hi) const
+        {
+            lo[0] = 0.0;
+            hi[0] = settings.maxWait;
+            for (int i = 0; i < settings.freeImpulses; ++i)
+            {
+                for (int j = 0; j < 3; ++j)
+                {
+                    lo[1 + 4 * i + j] = -settings.maxImpulse;
+                    hi[1 + 4 * i + j] = settings.maxImpulse;
+                }
+                lo[4 + 4 * i] = 0.0;
+                hi[4 + 4 * i] = settings.maxCoast;
+            }
+            lo[Dimension() - 1] = settings.minTimeOfFlight;
+            hi[Dimension() - 1] = settings.maxTimeOfFlight;
+        }
+
+        /**
+         * @brief True if the arc from (r, v) for dt, ending at (rEnd, vEnd), dips below minRadius
+         * at periapsis. On a bound orbit the arc reaches periapsis if its mean-anomaly span
+         * contains 0 mod 2 pi, so coasts over several revolutions are caught; an unbound orbit
+         * has a single periapsis, crossed if r.v changes sign from negative to positive.
+         */
+        bool PassesBelow(const Vector3d &r, const Vector3d &v, double dt, const Vector3d &rEnd, const Vector3d &vEnd) const
+        {
+            if (settings.minRadius <= 0.0)
+                return false;
+            double rNorm = Norm(r);
+            Vector3d h = Cross(r, v);
+            double energy = 0.5 * Dot(v, v) - mu / rNorm;
+            double p = Dot(h, h) / mu;
+            double e = std::sqrt(std::max(0.0, 1.0 + 2.0 * energy * p / mu));
+            if (p / (1.0 + e) >= settings.minRadius)
+                return false;
+            if (energy >= 0.0)
+                return Dot(r, v) <= 0.0 && Dot(rEnd, vEnd) >= 0.0;
+
+            double a = -mu / (2.0 * energy);
+            double eSinE = Dot(r, v) / std::sqrt(mu * a);
+            double eCosE = 1.0 - rNorm / a;
+            double M0 = std::atan2(eSinE, eCosE) - eSinE;
+            if (M0 < 0.0)
+                M0 += 2.0 * M_PI;
+            return M0 == 0.0 || M0 + std::sqrt(mu / (a * a * a)) * dt >= 2.0 * M_PI;
+        }
+
+        /**
+         * @brief Total delta-v of a candidate; optionally writes the impulses and their times.
+         * @return TRANSFER_PENALTY if any step is infeasible.
+         */
+        double Evaluate(const double *x, Vector3d *impulses = nullptr, double *times = nullptr, double *arrival = nullptr) const
+        {
+            Vector3d r, v;
+            double t = x[0];
+            if (!KeplerPropagate(chaserPos, chaserVel, mu, t, r, v))
+                return TRANSFER_PENALTY;
+            Vector3d normal = Cross(chaserPos, chaserVel);
+
+            double total = 0.0;
+            int count = 0;
+            for (int i = 0; i < settings.freeImpulses; ++i)
+            {
+                Vector3d dv{x[1 + 4 * i], x[2 + 4 * i], x[3 + 4 * i]};
+                v += dv;
+                total += Norm(dv);
+                if (impulses)
+                {
+                    impulses[count] = dv;
+                    times[count] = t;
+                }
+                count++;
+
+                double coast = x[4 + 4 * i];
+                Vector3d rn, vn;
+                if (!KeplerPropagate(r, v, mu, coast, rn, vn) || PassesBelow(r, v, coast, rn, vn))
+                    return TRANSFER_PENALTY;
+                r = rn;
+                v = vn;
+                t += coast;
+            }
+
+            double tof = x[Dimension() - 1];
+            Vector3d rt, vt;
+            if (!KeplerPropagate(targetPos, targetVel, mu, t + tof, rt, vt))
+                return TRANSFER_PENALTY;
+
+            Vector3d v1, v2;
+            if (!LambertSolve(r, rt, tof, mu, normal, v1, v2) || PassesBelow(r, v1, tof, rt, v2))
+                return TRANSFER_PENALTY;
+
+            Vector3d dep = v1 - v, arr = vt - v2;
+            total += Norm(dep) + Norm(arr);
+            if (impulses)
+            {
+                impulses[count] = dep;
+                times[count] = t;
+                impulses[count + 1] = arr;
+                times[count + 1] = t + tof;
+            }
+            if (arrival)
+                *arrival = t + tof;
+            return std::isfinite(total) ? total : TRANSFER_PENALTY;
+        }
+    };
+
+    /** DE/rand/1/bin with dithered weight and bounce-back bound handling. Returns the best vector. */
+    std::vector<double> DifferentialEvolution(const TransferProblem &problem, double &bestCost)
+    {
+        int D = problem.Dimension();
+        int NP = std::max(5, problem.settings.populationSize);
+        std::vector<double> lo(D), hi(D);
+        problem.Bounds(lo.data(), hi.data());
+
+        std::mt19937 rng(problem.settings.seed);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        std::vector<double> pop((size_t)NP * D), trial((size_t)NP * D);
+        std::vector<double> cost(NP), trialCost(NP);
+        for (int i = 0; i < NP; ++i)
+            for (int d = 0; d < D; ++d)
+                pop[(size_t)i * D + d] = lo[d] + unit(rng) * (hi[d] - lo[d]);
+
+        ParallelFor(NP, [&](int i)
+                    { cost[i] = problem.Evaluate(&pop[(size_t)i * D]); });
+
+        for (int gen = 0; gen < problem.settings.generations; ++gen)
+        {
+            double F = TRANSFER_DE_WEIGHT_MIN + unit(rng) * (TRANSFER_DE_WEIGHT_MAX - TRANSFER_DE_WEIGHT_MIN);
+            for (int i = 0; i < NP; ++i)
+            {
+                int a, b, c;
+                do
+                    a = (int)(unit(rng) * NP) % NP;
+                while (a == i);
+                do
+                    b = (int)(unit(rng) * NP) % NP;
+                while (b == i || b == a);
+                do
+                    c = (int)(unit(rng) * NP) % NP;
+                while (c == i || c == a || c == b);
+
+                int forced = (int)(unit(rng) * D) % D;
+                for (int d = 0; d < D; ++d)
+                {
+                    double base = pop[(size_t)i * D + d];
+                    double value = base;
+                    if (d == forced || unit(rng) < TRANSFER_DE_CROSSOVER)
+                    {
+                        value = pop[(size_t)a * D + d] + F * (pop[(size_t)b * D + d] - pop[(size_t)c * D + d]);
+                        if (value < lo[d])
+                            value = lo[d] + unit(rng) * (base - lo[d]);
+                        else if (value > hi[d])
+                            value = hi[d] - unit(rng) * (hi[d] - base);
+                    }
+                    trial[(size_t)i * D + d] = value;
+                }
+            }
+
+            ParallelFor(NP, [&](int i)
+                        { trialCost[i] = problem.Evaluate(&trial[(size_t)i * D]); });
+
+            for (int i = 0; i < NP; ++i)
+                if (trialCost[i] <= cost[i])
+                {
+                    cost[i] = trialCost[i];
+                    std::copy(&trial[(size_t)i * D], &trial[(size_t)i * D] + D, &pop[(size_t)i * D]);
+                }
+        }
+
+        int best = (int)(std::min_element(cost.begin(), cost.end()) - cost.begin());
+        bestCost = cost[best];
+        return std::vector<double>(&pop[(size_t)best * D], &pop[(size_t)best * D] + D);
+    }
+}
+
+/**
+ * @brief Batched Lambert solves, spread across the worker pool.
+ * @param r1 Departure positions.
+ * @param r2 Arrival positions.
+ * @param tof Times of flight (s).
+ * @param count Number of problems.
+ * @param mu Gravitational parameter (sim units).
+ * @param normal Reference orbit normal selecting the transfer direction.
+ * @param v1 Output departure velocities.
+ * @param v2 Output arrival velocities.
+ * @param ok Output per-problem success flags (may be null).
+ * @return Number of problems solved.
+ */
+extern "C" __attribute__((visibility("default"))) int LambertBatch(
+    const double3 *r1,
+    const double3 *r2,
+    const double *tof,
+    int count,
+    double mu,
+    double3 normal,
+    double3 *v1,
+    double3 *v2,
+    int *ok)
+{
+    std::vector<int> solved(std::max(count, 0));
+    Vector3d n = ToVector3dFromDouble3(normal);
+    ParallelFor(count, [&](int i)
+                {
+        Vector3d a, b;
+        solved[i] = LambertSolve(ToVector3dFromDouble3(r1[i]), ToVector3dFromDouble3(r2[i]), tof[i], mu, n, a, b) ? 1 : 0;
+        v1[i] = solved[i] ? ToDouble3(a) : double3{0, 0, 0};
+        v2[i] = solved[i] ? ToDouble3(b) : double3{0, 0, 0};
+        if (ok)
+            ok[i] = solved[i]; });
+
+    int total = 0;
+    for (int s : solved)
+        total += s;
+    return total;
+}
+
+/**
+ * @brief Searches for minimum delta-v multi-impulse rendezvous transfers to one or more targets.
+ * Each target gets an independent differential-evolution run whose population is evaluated
+ * in parallel.
+ *
+ * @param mu Gravitational parameter (sim units).
+ * @param chaserPos Chaser position relative to the central body at the search epoch.
+ * @param chaserVel Chaser velocity.
+ * @param targetPos Target positions at the search epoch.
+ * @param targetVel Target velocities.
+ * @param numTargets Number of targets.
+ * @param settings Bounds and DE parameters.
+ * @param solutions Output best transfer per target.
+ * @param impulses Output impulses, numTargets * (freeImpulses + 2), in order of application.
+ * @param impulseTimes Output impulse times from the search epoch (s), same layout.
+ * @return Number of targets for which a feasible transfer was found.
+ */
+extern "C" __attribute__((visibility("default"))) int TransferSearch(
+    double mu,
+    double3 chaserPos,
+    double3 chaserVel,
+    const double3 *targetPos,
+    const double3 *targetVel,
+    int numTargets,
+    TransferSearchSettings settings,
+    TransferSolution *solutions,
+    double3 *impulses,
+    double *impulseTimes)
+{
+    settings.freeImpulses = std::max(0, std::min(settings.freeImpulses, TRANSFER_MAX_FREE_IMPULSES));
+    int perTarget = settings.freeImpulses + 2;
+    int found = 0;
+
+    for (int k = 0; k < numTargets; ++k)
+    {
+        TransferProblem problem{ToVector3dFromDouble3(chaserPos), ToVector3dFromDouble3(chaserVel),
+                                ToVector3dFromDouble3(targetPos[k]), ToVector3dFromDouble3(targetVel[k]), mu, settings};
+        problem.settings.seed = settings.seed + (unsigned int)k;
+
+        double bestCost;
+        std::vector<double> best = DifferentialEvolution(problem, bestCost);
+
+        Vector3d dv[TRANSFER_MAX_FREE_IMPULSES + 2];
+        double times[TRANSFER_MAX_FREE_IMPULSES + 2];
+        double arrival = 0.0;
+        double total = problem.Evaluate(best.data(), dv, times, &arrival);
+        bool feasible = total < TRANSFER_PENALTY;
+
+        TransferSolution &s = solutions[k];
+        s.totalDeltaV = feasible ? total : 0.0;
+        s.arrivalTime = feasible ? arrival : 0.0;
+        s.numImpulses = feasible ? perTarget : 0;
+        s.feasible = feasible ? 1 : 0;
+        for (int i = 0; i < perTarget; ++i)
+        {
+            impulses[k * perTarget + i] = feasible ? ToDouble3(dv[i]) : double3{0, 0, 0};
+            impulseTimes[k * perTarget + i] = feasible ? times[i] : 0.0;
+        }
+        found += feasible ? 1 : 0;
+    }
+    return found;
+}
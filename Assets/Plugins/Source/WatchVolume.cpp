@@ -0,0 +1,271 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "Catalog.h"
+#include "ThreadPool.h"
+
+/**
+ * @file WatchVolume.cpp
+ * @brief Live proximity watch volumes around selected catalog objects.
+ *
+ * Each watch is an ellipsoid with semi-axes along the watched object's radial, along-track and
+ * cross-track directions. Every update propagates the catalog to the current time in parallel and
+ * files the positions into a uniform hash grid whose cell is as large as the biggest watch, so a
+ * watch only has to look at the 27 cells around its object. Between updates only objects that
+ * changed cell are moved, and the grid is rebuilt only when the cell size changes. Entries into
+ * and exits from each volume are reported as alerts.
+ */
+
+const double WATCH_MIN_CELL = 10.0; ///< Smallest grid cell (units).
+
+extern "C"
+{
+    /**
+     * @struct WatchAlert
+     * @brief An object entering or leaving a watch volume; layout must match NativePhysics.WatchAlert.
+     */
+    struct WatchAlert
+    {
+        double time;     ///< Update time at which the change was seen (s).
+        double distance; ///< Range from the watched object (units).
+        double3 offsetRtn; ///< Position relative to the watched object in its RTN frame (units).
+        int watchHandle;
+        int objectId;
+        int entered; ///< 1 on entry, 0 on exit.
+        int reserved;
+    };
+}
+
+namespace
+{
+    struct Watch
+    {
+        int objectId;
+        Vector3d semiAxes;           ///< Radial, along-track, cross-track (units).
+        std::vector<int> insideIds;  ///< Sorted ids currently inside.
+    };
+
+    struct ProximityGrid
+    {
+        double cell = 0;
+        std::vector<Vector3d> pos, vel;
+        std::vector<char> valid;
+        std::vector<int64_t> cellOf; ///< Cell key of each catalog index.
+        std::vector<int> slotOf;     ///< Position of each index in its cell list.
+        std::unordered_map<int64_t, std::vector<int>> cells;
+
+        std::map<int, Watch> watches;
+        int nextHandle = 1;
+
+        int64_t Key(const Vector3d &p) const
+        {
+            // 21 bits per axis covers ±10^6 cells.
+            auto q = [&](double x)
+            { return (int64_t)std::floor(x / cell) + (1 << 20); };
+            return (q(p.x) << 42) | (q(p.y) << 21) | q(p.z);
+        }
+
+        void Insert(int i, int64_t key)
+        {
+            std::vector<int> &list = cells[key];
+            cellOf[i] = key;
+            slotOf[i] = (int)list.size();
+            list.push_back(i);
+        }
+
+        void Erase(int i)
+        {
+            auto it = cells.find(cellOf[i]);
+            std::vector<int> &list = it->second;
+            int moved = list.back();
+            list[slotOf[i]] = moved;
+            slotOf[moved] = slotOf[i];
+            list.pop_back();
+            if (list.empty())
+                cells.erase(it);
+        }
+    };
+
+    ProximityGrid &GetProximityGrid()
+    {
+        static ProximityGrid grid;
+        return grid;
+    }
+
+    double RequiredCell(const ProximityGrid &grid)
+    {
+        double cell = WATCH_MIN_CELL;
+        for (const auto &kv : grid.watches)
+        {
+            const Vector3d &s = kv.second.semiAxes;
+            cell = std::max(cell, std::max({s.x, s.y, s.z}));
+        }
+        return cell;
+    }
+
+    /** Propagates the catalog and brings the grid up to date. */
+    void UpdateGrid(ProximityGrid &grid, const Catalog &catalog, double time)
+    {
+        int n = catalog.Count();
+        grid.pos.resize(n);
+        grid.vel.resize(n);
+        grid.valid.resize(n);
+        ParallelFor(n, [&](int i)
+                    { grid.valid[i] = catalog.StateAt(i, time, grid.pos[i], grid.vel[i]) ? 1 : 0; });
+
+        // The grid holds catalog indices, so edits, removals (swap with the last) and inserts
+        // only change which positions sit at an index; re-keying every index covers them.
+        double cell = RequiredCell(grid);
+        if (cell != grid.cell)
+        {
+            grid.cell = cell;
+            grid.cells.clear();
+            grid.cellOf.assign(n, -1);
+            grid.slotOf.assign(n, -1);
+            for (int i = 0; i < n; ++i)
+                if (grid.valid[i])
+                    grid.Insert(i, grid.Key(grid.pos[i]));
+            return;
+        }
+
+        for (int i = n; i < (int)grid.cellOf.size(); ++i)
+            if (grid.cellOf[i] >= 0)
+                grid.Erase(i);
+        grid.cellOf.resize(n, -1);
+        grid.slotOf.resize(n, -1);
+        for (int i = 0; i < n; ++i)
+        {
+            int64_t key = grid.valid[i] ? grid.Key(grid.pos[i]) : -1;
+            if (key == grid.cellOf[i])
+                continue;
+            if (grid.cellOf[i] >= 0)
+                grid.Erase(i);
+            if (key >= 0)
+                grid.Insert(i, key);
+            else
+                grid.cellOf[i] = -1;
+        }
+    }
+}
+
+/**
+ * @brief Starts watching an ellipsoid around a catalog object.
+ * @param objectId Watched object.
+ * @param semiAxesRtn Semi-axes along radial, along-track and cross-track (units).
+ * @return Watch handle, or 0 if the semi-axes are not positive.
+ */
+extern "C" __attribute__((visibility("default"))) int WatchVolumeAdd(int objectId, double3 semiAxesRtn)
+{
+    if (!(semiAxesRtn.x > 0 && semiAxesRtn.y > 0 && semiAxesRtn.z > 0))
+    {
+        LogDebug("[WatchVolumeAdd] Semi-axes must be positive.");
+        return 0;
+    }
+    ProximityGrid &grid = GetProximityGrid();
+    int handle = grid.nextHandle++;
+    grid.watches[handle] = {objectId, ToVector3dFromDouble3(semiAxesRtn), {}};
+    return handle;
+}
+
+/**
+ * @brief Stops a watch.
+ * @return 1 if the handle existed.
+ */
+extern "C" __attribute__((visibility("default"))) int WatchVolumeRemove(int handle)
+{
+    return GetProximityGrid().watches.erase(handle) > 0 ? 1 : 0;
+}
+
+/**
+ * @brief Advances the watch volumes to the current time and reports entries and exits.
+ * @param time Simulation time (s).
+ * @param alerts Output alerts (capacity maxAlerts), grouped by watch.
+ * @param maxAlerts Capacity of the output buffer.
+ * @return Number of alerts (may exceed maxAlerts; only the first maxAlerts are written).
+ */
+extern "C" __attribute__((visibility("default"))) int WatchVolumeUpdate(double time, WatchAlert *alerts, int maxAlerts)
+{
+    const Catalog &catalog = GetCatalog();
+    ProximityGrid &grid = GetProximityGrid();
+    if (grid.watches.empty())
+        return 0;
+    UpdateGrid(grid, catalog, time);
+
+    int count = 0;
+    auto emit = [&](const WatchAlert &a)
+    {
+        if (count < maxAlerts)
+            alerts[count] = a;
+        ++count;
+    };
+
+    for (auto &kv : grid.watches)
+    {
+        Watch &watch = kv.second;
+        int self = catalog.Find(watch.objectId);
+        std::vector<int> inside;
+        if (self < 0 || !grid.valid[self])
+        {
+            // The watched object is gone; everything inside leaves.
+            for (int id : watch.insideIds)
+                emit({time, 0, {0, 0, 0}, kv.first, id, 0, 0});
+            watch.insideIds.clear();
+            continue;
+        }
+
+        const Vector3d &r = grid.pos[self];
+        Vector3d rHat = r * (1.0 / Norm(r));
+        Vector3d h = Cross(r, grid.vel[self]);
+        Vector3d nHat = h * (1.0 / Norm(h));
+        Vector3d tHat = Cross(nHat, rHat);
+        auto alert = [&](int j, int entered)
+        {
+            Vector3d d = grid.valid[j] ? grid.pos[j] - r : Vector3d{0, 0, 0};
+            return WatchAlert{time, Norm(d), ToDouble3({Dot(d, rHat), Dot(d, tHat), Dot(d, nHat)}), kv.first,
+                              catalog.ids[j], entered, 0};
+        };
+
+        int64_t center = grid.Key(r);
+        for (int64_t dx = -1; dx <= 1; ++dx)
+            for (int64_t dy = -1; dy <= 1; ++dy)
+                for (int64_t dz = -1; dz <= 1; ++dz)
+                {
+                    auto it = grid.cells.find(center + dx * (int64_t(1) << 42) + dy * (int64_t(1) << 21) + dz);
+                    if (it == grid.cells.end())
+                        continue;
+                    for (int j : it->second)
+                    {
+                        Vector3d d = grid.pos[j] - r;
+                        double x = Dot(d, rHat) / watch.semiAxes.x;
+                        double y = Dot(d, tHat) / watch.semiAxes.y;
+                        double z = Dot(d, nHat) / watch.semiAxes.z;
+                        if (j != self && x * x + y * y + z * z <= 1)
+                            inside.push_back(catalog.ids[j]);
+                    }
+                }
+
+        // Alerts are the differences between the previous and current inside sets.
+        std::sort(inside.begin(), inside.end());
+        std::vector<int> &before = watch.insideIds;
+        size_t p = 0, q = 0;
+        while (p < before.size() || q < inside.size())
+        {
+            if (q == inside.size() || (p < before.size() && before[p] < inside[q]))
+            {
+                int j = catalog.Find(before[p]);
+                emit(j >= 0 ? alert(j, 0) : WatchAlert{time, 0, {0, 0, 0}, kv.first, before[p], 0, 0});
+                ++p;
+            }
+            else if (p == before.size() || inside[q] < before[p])
+                emit(alert(catalog.Find(inside[q++]), 1));
+            else
+                ++p, ++q;
+        }
+        watch.insideIds = std::move(inside);
+    }
+    return count;
+}
@@ -1,3 +1,5 @@
+using System;
+using System.IO;
 using UnityEngine;
 using UnityEngine.UI;
 using TMPro;
@@ -16,6 +18,61 @@ public class TimeController : MonoBehaviour
     public UIManager uIManager;
     private bool isPaused = false;
     private float previousTimeScale = 1.0f; // Store the previous time scale before pausing.
+    private static double epochFixedTime;
+
+    /// <summary>
+    /// Seconds of simulation time since the native epoch. Read from Unity's double-precision fixed
+    /// clock rather than summed from the float step, so long runs do not drift.
+    /// </summary>
+    public static double SimulationTime => Time.fixedTimeAsDouble - epochFixedTime;
+
+    /// <summary>
+    /// Loads the leap-second table and Earth orientation parameters, then starts the native simulation clock at the current UTC time,
+    /// before any body reads a date in Start.
+    /// </summary>
+    void Awake()
+    {
+        epochFixedTime = Time.fixedTimeAsDouble;
+        if (!NativePhysics.HasEntryPoint(nameof(NativePhysics.TimeSetEpoch)))
+        {
+            return; // Plugin predates the time scales: simulation time still counts from here.
+        }
+
+        string leapSecondsPath = Path.Combine(Application.streamingAssetsPath, "leap-seconds.list");
+        if (NativePhysics.TimeLoadLeapSeconds(leapSecondsPath) == 0)
+        {
+            Debug.LogWarning("[TIME CONTROLLER]: Leap-second file not loaded, using the built-in table.");
+        }
+
+        // Optional: without Earth orientation data the pole is fixed and UT1 is taken as UTC.
+        string eopPath = Path.Combine(Application.streamingAssetsPath, "finals2000A.all");
+        if (File.Exists(eopPath) && NativePhysics.HasEntryPoint(nameof(NativePhysics.EopLoad)))
+        {
+            int rows = NativePhysics.EopLoad(eopPath);
+            Debug.Log($"[TIME CONTROLLER]: Loaded {rows} days of Earth orientation parameters.");
+        }
+
+        NativePhysics.TimeSetEpoch(NativePhysics.TimeScale.UTC, ToJulianDate(DateTime.UtcNow));
+    }
+
+    /// <summary>
+    /// Converts a UTC date and time to a two-part Julian date without going through a single double.
+    /// The day part ends in .5 (midnight) and the fraction lies in [0, 1), also before 1970.
+    /// </summary>
+    /// <param name="utc">UTC date and time.</param>
+    public static NativePhysics.JulianDate ToJulianDate(DateTime utc)
+    {
+        const double UnixEpochJulianDate = 2440587.5;
+        TimeSpan sinceUnixEpoch = utc - DateTime.UnixEpoch;
+        long days = sinceUnixEpoch.Ticks / TimeSpan.TicksPerDay;
+        long remainder = sinceUnixEpoch.Ticks - days * TimeSpan.TicksPerDay;
+        if (remainder < 0)
+        {
+            days--;
+            remainder += TimeSpan.TicksPerDay;
+        }
+        return new NativePhysics.JulianDate(UnixEpochJulianDate + days, (double)remainder / TimeSpan.TicksPerDay);
+    }
 
 
     /// <summary>
@@ -48,10 +105,27 @@ public class TimeController : MonoBehaviour
     }
 
     /// <summary>
-    /// Checks for user input (reset time scale) and handles input lock during UI focus.
+    /// Advances the native per-frame work to the current simulation time, then checks for user input
+    /// (reset time scale) and handles input lock during UI focus.
     /// </summary>
     void Update()
     {
+        if (NativePhysics.HasEntryPoint(nameof(NativePhysics.BudgetEndFrame)))
+        {
+            NativePhysics.BudgetEndFrame(Time.unscaledDeltaTime * 1000.0);
+        }
+
+        // Station keeping also executes the maneuver schedule, including avoidance burns.
+        if (NativePhysics.HasEntryPoint(nameof(NativePhysics.StationKeepingUpdate)))
+        {
+            NativePhysics.StationKeepingUpdate(SimulationTime);
+        }
+
+        if (NativePhysics.HasEntryPoint(nameof(NativePhysics.MissionUpdate)))
+        {
+            NativePhysics.MissionUpdate(SimulationTime);
+        }
+
         if (EventSystem.current.currentSelectedGameObject != null &&
             EventSystem.current.currentSelectedGameObject.GetComponent<TMPro.TMP_InputField>() != null)
         {
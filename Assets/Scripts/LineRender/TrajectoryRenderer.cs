@@ -253,14 +253,31 @@ public class TrajectoryRenderer : MonoBehaviour
                 predictionSteps = 3000;
             }
 
-            trackedBody.CalculatePredictedTrajectoryGPU_Async(predictionSteps, predictionDeltaTime, (resultList) =>
+            // Under frame-time pressure the budget controller lowers the resolution, keeping the predicted span.
+            // A plugin without the budget exports always predicts at full resolution.
+            bool budgeted = NativePhysics.HasEntryPoint(nameof(NativePhysics.BudgetGetQuality));
+            float quality = budgeted ? (float)NativePhysics.BudgetGetQuality((int)NativePhysics.BudgetSubsystem.Prediction) : 1f;
+            int steps = Mathf.Max(1, Mathf.CeilToInt(predictionSteps * quality));
+            float stepDeltaTime = predictionDeltaTime * predictionSteps / steps;
+
+            var dispatchTimer = System.Diagnostics.Stopwatch.StartNew();
+            trackedBody.CalculatePredictedTrajectoryGPU_Async(steps, stepDeltaTime, (resultList) =>
             {
+                var callbackTimer = System.Diagnostics.Stopwatch.StartNew();
                 var fullTrajectory = resultList.ToArray();
 
                 var clippedPoints = ClipTrajectory(fullTrajectory);
 
                 predictionProceduralLine.UpdateLine(clippedPoints);
+                if (budgeted)
+                {
+                    NativePhysics.BudgetReport((int)NativePhysics.BudgetSubsystem.Prediction, callbackTimer.Elapsed.TotalMilliseconds);
+                }
             });
+            if (budgeted)
+            {
+                NativePhysics.BudgetReport((int)NativePhysics.BudgetSubsystem.Prediction, dispatchTimer.Elapsed.TotalMilliseconds);
+            }
 
             orbitIsDirty = false;
             isComputingPrediction = false;
@@ -324,16 +341,51 @@ public class TrajectoryRenderer : MonoBehaviour
 
                 if (apogeeText != null && perigeeText != null)
                 {
-                    float apogeeAltitude = (orbitalParams.apogeePosition.magnitude - 637.8f) * 10f; // Convert to kilometers
-                    float perigeeAltitude = (orbitalParams.perigeePosition.magnitude - 637.8f) * 10f; // Convert to kilometers
-
-                    UIManager.Instance.UpdateOrbitUI(apogeeAltitude, perigeeAltitude, orbitalParams.semiMajorAxis, orbitalParams.eccentricity,
-                        orbitalParams.orbitalPeriod, orbitalParams.inclination, orbitalParams.RAAN);
+                    // Prefer mean elements for the readout; osculating ones oscillate with J2 every orbit.
+                    if (TryGetMeanElements(out NativePhysics.OrbitalElements mean))
+                    {
+                        float apogeeAltitude = (float)((mean.a * (1.0 + mean.e) - 637.8) * 10.0);
+                        float perigeeAltitude = (float)((mean.a * (1.0 - mean.e) - 637.8) * 10.0);
+                        double mu = PhysicsConstants.G * (double)trackedBody.state.centralBodyMass;
+                        float period = (float)(2.0 * math.PI * math.sqrt(mean.a * mean.a * mean.a / mu));
+
+                        UIManager.Instance.UpdateOrbitUI(apogeeAltitude, perigeeAltitude, (float)mean.a, (float)mean.e,
+                            period, (float)math.degrees(mean.i), (float)math.degrees(mean.raan));
+                    }
+                    else
+                    {
+                        float apogeeAltitude = (orbitalParams.apogeePosition.magnitude - 637.8f) * 10f; // Convert to kilometers
+                        float perigeeAltitude = (orbitalParams.perigeePosition.magnitude - 637.8f) * 10f; // Convert to kilometers
+
+                        UIManager.Instance.UpdateOrbitUI(apogeeAltitude, perigeeAltitude, orbitalParams.semiMajorAxis, orbitalParams.eccentricity,
+                            orbitalParams.orbitalPeriod, orbitalParams.inclination, orbitalParams.RAAN);
+                    }
                 }
             }
         }
     }
 
+    /// <summary>
+    /// Converts the tracked body's state to Brouwer–Lyddane mean elements in the native plugin.
+    /// </summary>
+    /// <param name="mean">Mean elements (native frame, Z along Earth's axis).</param>
+    /// <returns>True if the orbit is bound and above the surface, false if the plugin cannot convert it.</returns>
+    private bool TryGetMeanElements(out NativePhysics.OrbitalElements mean)
+    {
+        if (!NativePhysics.HasEntryPoint(nameof(NativePhysics.OsculatingToMeanSingle)))
+        {
+            mean = default;
+            return false;
+        }
+
+        double3 p = trackedBody.state.position;
+        double3 v = trackedBody.state.velocity;
+        double mu = PhysicsConstants.G * (double)trackedBody.state.centralBodyMass;
+
+        // Unity is Y-up; the native frame has Z along Earth's rotation axis.
+        return NativePhysics.OsculatingToMeanSingle(new double3(p.x, p.z, p.y), new double3(v.x, v.z, v.y), mu, out mean) == 1;
+    }
+
     /// <summary>
     /// Toggles line visibility based on camera distance.
     /// </summary>
@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Generic;
 using System.IO;
 using System.Runtime.InteropServices;
 using UnityEngine;
@@ -13,6 +14,12 @@ public static class NativePhysics
     [DllImport("kernel32.dll", SetLastError = true)]
     private static extern IntPtr LoadLibrary(string dllToLoad);
 
+    [DllImport("kernel32.dll", CharSet = CharSet.Ansi, ExactSpelling = true, SetLastError = true)]
+    private static extern IntPtr GetProcAddress(IntPtr module, string procName);
+
+    private static IntPtr pluginHandle;
+    private static readonly Dictionary<string, bool> entryPoints = new Dictionary<string, bool>();
+
     /// <summary>
     /// Static constructor for NativePhysics.
     /// Attempts to load the native PhysicsPlugin DLL at runtime and logs success/failure.
@@ -34,6 +41,7 @@ public static class NativePhysics
         }
 
         IntPtr handle = LoadLibrary(unityPluginsPath);
+        pluginHandle = handle;
         if (handle == IntPtr.Zero)
         {
             Debug.LogError($"[NATIVE PHYSICS]: DLL load failed! Error Code: {Marshal.GetLastWin32Error()}");
@@ -44,6 +52,27 @@ public static class NativePhysics
         }
     }
 
+    /// <summary>
+    /// Checks whether the loaded plugin exports a function. A PhysicsPlugin.dll built from older sources
+    /// lacks newer exports, so callers check this and take their managed fallback instead of throwing
+    /// <see cref="EntryPointNotFoundException"/>. The result is cached; a missing export is logged once.
+    /// </summary>
+    /// <param name="entryPoint">Exported function name, e.g. <c>nameof(NativePhysics.EnckeSingle)</c>.</param>
+    /// <returns>True if the function can be called.</returns>
+    public static bool HasEntryPoint(string entryPoint)
+    {
+        if (!entryPoints.TryGetValue(entryPoint, out bool found))
+        {
+            found = pluginHandle != IntPtr.Zero && GetProcAddress(pluginHandle, entryPoint) != IntPtr.Zero;
+            entryPoints[entryPoint] = found;
+            if (!found)
+            {
+                Debug.LogWarning($"[NATIVE PHYSICS]: PhysicsPlugin does not export {entryPoint}, using fallback. Rebuild the plugin from Assets/Plugins/Source.");
+            }
+        }
+        return found;
+    }
+
     /// <summary>
     /// Calls a native C++ function to integrate the motion of a body using the Dormand-Prince (Runge-Kutta) method.
     /// </summary>
@@ -70,4 +99,1458 @@ public static class NativePhysics
         float dragCoeff,
         float areaUU
     );
+
+    /// <summary>
+    /// Per-body state for the Encke propagator. Owned by the caller and passed by reference every step.
+    /// Layout mirrors the native <c>EnckeState</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct EnckeState
+    {
+        public double3 referencePosition;
+        public double3 referenceVelocity;
+        public double3 deltaPosition;
+        public double3 deltaVelocity;
+        public double timeSinceRectification;
+        public double chi;
+        public int rectificationCount;
+        public int initialized;
+    }
+
+    /// <summary>
+    /// Calls a native C++ function to propagate a body with the Encke method.
+    /// Only the deviation from an analytic Kepler orbit about bodies[0] is integrated, which allows much larger timesteps.
+    /// </summary>
+    /// <param name="position">Reference to the current position (double precision).</param>
+    /// <param name="velocity">Reference to the current velocity (double precision).</param>
+    /// <param name="state">Reference to the persistent Encke state for this body.</param>
+    /// <param name="mass">Mass of the target body.</param>
+    /// <param name="bodies">Array of positions of all other bodies, primary first (single precision).</param>
+    /// <param name="masses">Array of masses of the other bodies (double precision).</param>
+    /// <param name="numBodies">Number of other bodies.</param>
+    /// <param name="deltaTime">Simulation timestep in seconds.</param>
+    /// <param name="thrustImpulse">Impulse force (e.g., from propulsion).</param>
+    [DllImport("PhysicsPlugin", EntryPoint = "EnckeSingle", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void EnckeSingle(
+        ref double3 position,
+        ref double3 velocity,
+        ref EnckeState state,
+        double mass,
+        Vector3[] bodies,
+        double[] masses,
+        int numBodies,
+        float deltaTime,
+        Vector3 thrustImpulse
+    );
+
+    /// <summary>
+    /// Calls a native C++ function that integrates a body relative to its current primary and switches
+    /// primary automatically when a sphere-of-influence boundary is crossed.
+    /// </summary>
+    /// <param name="position">Reference to the current absolute position (double precision).</param>
+    /// <param name="velocity">Reference to the current absolute velocity (double precision).</param>
+    /// <param name="primaryIndex">Reference to the index of the current primary in <paramref name="bodies"/>; negative to auto-select.</param>
+    /// <param name="mass">Mass of the target body.</param>
+    /// <param name="bodies">Positions of the massive bodies, central body first (double precision).</param>
+    /// <param name="bodyVelocities">Velocities of the massive bodies.</param>
+    /// <param name="masses">Masses of the massive bodies.</param>
+    /// <param name="numBodies">Number of massive bodies.</param>
+    /// <param name="deltaTime">Simulation timestep in seconds.</param>
+    /// <param name="thrustImpulse">Impulse force (e.g., from propulsion).</param>
+    /// <returns>1 if the primary changed during the step, otherwise 0.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "PatchedConicSingle", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int PatchedConicSingle(
+        ref double3 position,
+        ref double3 velocity,
+        ref int primaryIndex,
+        double mass,
+        double3[] bodies,
+        double3[] bodyVelocities,
+        double[] masses,
+        int numBodies,
+        float deltaTime,
+        Vector3 thrustImpulse
+    );
+
+    /// <summary>
+    /// A symmetric CR3BP periodic orbit, stored by its perpendicular x-z plane crossing (nondimensional rotating frame).
+    /// Layout mirrors the native <c>Cr3bpOrbit</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct Cr3bpOrbit
+    {
+        public double x0;
+        public double z0;
+        public double vy0;
+        public double period;
+        public double jacobi;
+        public double stability1;
+        public double stability2;
+        public int converged;
+    }
+
+    /// <summary>
+    /// Returns the x coordinate of a collinear libration point in the CR3BP rotating frame.
+    /// </summary>
+    /// <param name="mu">Mass ratio m2 / (m1 + m2).</param>
+    /// <param name="point">Libration point (1, 2 or 3).</param>
+    /// <returns>x coordinate, or NaN if <paramref name="point"/> is not 1, 2 or 3.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "Cr3bpLibrationPoint", CallingConvention = CallingConvention.Cdecl)]
+    public static extern double Cr3bpLibrationPoint(double mu, int point);
+
+    /// <summary>
+    /// Propagates a nondimensional CR3BP state, optionally returning the state transition matrix.
+    /// </summary>
+    /// <param name="mu">Mass ratio.</param>
+    /// <param name="state">6-element state, updated in place.</param>
+    /// <param name="time">Nondimensional propagation time (may be negative).</param>
+    /// <param name="stm">36-element row-major STM output, or null.</param>
+    /// <returns>1 on success.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "Cr3bpPropagate", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Cr3bpPropagate(double mu, double[] state, double time, double[] stm);
+
+    /// <summary>
+    /// Corrects a symmetric periodic orbit guess with single shooting.
+    /// </summary>
+    /// <param name="mu">Mass ratio.</param>
+    /// <param name="orbit">Initial guess, corrected in place.</param>
+    /// <param name="fixedVariable">0 to hold x0 fixed, 1 to hold z0 fixed.</param>
+    /// <returns>1 if converged.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "Cr3bpCorrectPeriodic", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Cr3bpCorrectPeriodic(double mu, ref Cr3bpOrbit orbit, int fixedVariable);
+
+    /// <summary>
+    /// Corrects a periodic orbit from patch points with multiple shooting (segments propagated in parallel).
+    /// </summary>
+    /// <param name="mu">Mass ratio.</param>
+    /// <param name="patchStates">6 * numPatches states, updated in place.</param>
+    /// <param name="segmentTimes">Segment durations, updated in place.</param>
+    /// <param name="numPatches">Number of patch points.</param>
+    /// <param name="maxIterations">Newton iteration limit.</param>
+    /// <param name="tolerance">Continuity tolerance.</param>
+    /// <returns>Iterations used, or -1 if not converged.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "Cr3bpMultipleShooting", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Cr3bpMultipleShooting(
+        double mu,
+        double[] patchStates,
+        double[] segmentTimes,
+        int numPatches,
+        int maxIterations,
+        double tolerance
+    );
+
+    /// <summary>
+    /// Generates a Lyapunov or halo (continuing into NRHO) family about a collinear libration point by
+    /// pseudo-arclength continuation.
+    /// </summary>
+    /// <param name="mu">Mass ratio.</param>
+    /// <param name="librationPoint">Libration point (1, 2 or 3).</param>
+    /// <param name="family">0 = planar Lyapunov, 1 = northern halo, 2 = southern halo.</param>
+    /// <param name="step">Arclength between members (nondimensional, e.g. 1e-3).</param>
+    /// <param name="maxMembers">Capacity of <paramref name="orbits"/>.</param>
+    /// <param name="orbits">Output family members.</param>
+    /// <returns>Number of members written, or -1 if the libration point or family is out of range.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "Cr3bpGenerateFamily", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Cr3bpGenerateFamily(
+        double mu,
+        int librationPoint,
+        int family,
+        double step,
+        int maxMembers,
+        [Out] Cr3bpOrbit[] orbits
+    );
+
+    /// <summary>
+    /// Samples one period of a CR3BP orbit for display.
+    /// </summary>
+    /// <param name="mu">Mass ratio.</param>
+    /// <param name="orbit">Orbit to sample.</param>
+    /// <param name="numPoints">Number of samples.</param>
+    /// <param name="points">Output rotating-frame positions.</param>
+    /// <returns>Number of samples written.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "Cr3bpSampleOrbit", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Cr3bpSampleOrbit(double mu, ref Cr3bpOrbit orbit, int numPoints, [Out] double3[] points);
+
+    /// <summary>
+    /// Generates the stable or unstable invariant manifold of a CR3BP periodic orbit (trajectories propagated in parallel)
+    /// and writes every crossing of the section plane to a compact binary file.
+    /// </summary>
+    /// <param name="mu">Mass ratio.</param>
+    /// <param name="orbit">Periodic orbit.</param>
+    /// <param name="numSeeds">Seed points along the orbit; both branches are propagated.</param>
+    /// <param name="stable">0 for the unstable manifold, 1 for the stable manifold.</param>
+    /// <param name="perturbation">Displacement along the eigenvector (nondimensional).</param>
+    /// <param name="maxTime">Propagation time per trajectory (nondimensional).</param>
+    /// <param name="sectionAxis">State component defining the section (0-2 position, 3-5 velocity).</param>
+    /// <param name="sectionValue">Section plane value.</param>
+    /// <param name="crossingDirection">+1 increasing, -1 decreasing, 0 both.</param>
+    /// <param name="maxCrossings">Crossings recorded per trajectory.</param>
+    /// <param name="primaryRadius">Larger primary's radius in units of the separation (about 0.0166 for Earth in Earth-Moon).</param>
+    /// <param name="secondaryRadius">Smaller primary's radius in units of the separation (about 0.0045 for the Moon); 0 for a point mass.</param>
+    /// <param name="outputPath">Section file path.</param>
+    /// <returns>Number of crossings written, or -1 on failure.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "Cr3bpManifoldSection", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int Cr3bpManifoldSection(
+        double mu,
+        ref Cr3bpOrbit orbit,
+        int numSeeds,
+        int stable,
+        double perturbation,
+        double maxTime,
+        int sectionAxis,
+        double sectionValue,
+        int crossingDirection,
+        int maxCrossings,
+        double primaryRadius,
+        double secondaryRadius,
+        string outputPath
+    );
+
+    /// <summary>
+    /// Summary of a collocation solve. Layout mirrors the native <c>CollocationResult</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CollocationResult
+    {
+        public double cost;
+        public double maxDefect;
+        public double maxThrustAccel;
+        public int iterations;
+        public int converged;
+    }
+
+    /// <summary>
+    /// Optimises a minimum-energy low-thrust transfer between two fixed states with Hermite-Simpson direct
+    /// collocation and a built-in sparse (banded) SQP solver.
+    /// </summary>
+    /// <param name="mu">Gravitational parameter of the central body (sim units).</param>
+    /// <param name="r0">Initial position relative to the central body.</param>
+    /// <param name="v0">Initial velocity.</param>
+    /// <param name="rf">Target position at arrival.</param>
+    /// <param name="vf">Target velocity at arrival.</param>
+    /// <param name="timeOfFlight">Transfer duration in seconds.</param>
+    /// <param name="numSegments">Number of collocation segments.</param>
+    /// <param name="maxIterations">SQP iteration limit.</param>
+    /// <param name="tolerance">Feasibility / optimality tolerance (canonical units).</param>
+    /// <param name="nodePositions">Output node positions (numSegments + 1), or null.</param>
+    /// <param name="nodeControls">Output node thrust accelerations (numSegments + 1), or null.</param>
+    /// <param name="result">Solve summary.</param>
+    /// <returns>1 if converged, otherwise 0.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "CollocationOptimize", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CollocationOptimize(
+        double mu,
+        double3 r0,
+        double3 v0,
+        double3 rf,
+        double3 vf,
+        double timeOfFlight,
+        int numSegments,
+        int maxIterations,
+        double tolerance,
+        [Out] double3[] nodePositions,
+        [Out] double3[] nodeControls,
+        out CollocationResult result
+    );
+
+    /// <summary>
+    /// Bounds and differential-evolution parameters for <see cref="TransferSearch"/>.
+    /// Layout mirrors the native <c>TransferSearchSettings</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TransferSearchSettings
+    {
+        public double maxWait;
+        public double minTimeOfFlight;
+        public double maxTimeOfFlight;
+        public double maxCoast;
+        public double maxImpulse;
+        public double minRadius;
+        public int freeImpulses;
+        public int populationSize;
+        public int generations;
+        public uint seed;
+    }
+
+    /// <summary>
+    /// Best transfer found for one target. Layout mirrors the native <c>TransferSolution</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TransferSolution
+    {
+        public double totalDeltaV;
+        public double arrivalTime;
+        public int numImpulses;
+        public int feasible;
+    }
+
+    /// <summary>
+    /// Solves a batch of single-revolution Lambert problems in parallel.
+    /// </summary>
+    /// <param name="r1">Departure positions.</param>
+    /// <param name="r2">Arrival positions.</param>
+    /// <param name="timeOfFlight">Times of flight in seconds.</param>
+    /// <param name="count">Number of problems.</param>
+    /// <param name="mu">Gravitational parameter (sim units).</param>
+    /// <param name="normal">Reference orbit normal selecting the transfer direction.</param>
+    /// <param name="v1">Output departure velocities.</param>
+    /// <param name="v2">Output arrival velocities.</param>
+    /// <param name="ok">Output success flags, or null.</param>
+    /// <returns>Number of problems solved.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "LambertBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int LambertBatch(
+        double3[] r1,
+        double3[] r2,
+        double[] timeOfFlight,
+        int count,
+        double mu,
+        double3 normal,
+        [Out] double3[] v1,
+        [Out] double3[] v2,
+        [Out] int[] ok
+    );
+
+    /// <summary>
+    /// Searches for minimum delta-v multi-impulse rendezvous transfers with differential evolution,
+    /// evaluating each population across the native thread pool.
+    /// </summary>
+    /// <param name="mu">Gravitational parameter (sim units).</param>
+    /// <param name="chaserPos">Chaser position relative to the central body.</param>
+    /// <param name="chaserVel">Chaser velocity.</param>
+    /// <param name="targetPos">Target positions at the search epoch.</param>
+    /// <param name="targetVel">Target velocities at the search epoch.</param>
+    /// <param name="numTargets">Number of targets.</param>
+    /// <param name="settings">Search bounds and parameters.</param>
+    /// <param name="solutions">Output best transfer per target.</param>
+    /// <param name="impulses">Output impulses, numTargets * (freeImpulses + 2).</param>
+    /// <param name="impulseTimes">Output impulse times in seconds from the search epoch.</param>
+    /// <returns>Number of targets with a feasible transfer.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "TransferSearch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TransferSearch(
+        double mu,
+        double3 chaserPos,
+        double3 chaserVel,
+        double3[] targetPos,
+        double3[] targetVel,
+        int numTargets,
+        TransferSearchSettings settings,
+        [Out] TransferSolution[] solutions,
+        [Out] double3[] impulses,
+        [Out] double[] impulseTimes
+    );
+
+    /// <summary>
+    /// Inserts or updates an object in the native catalog.
+    /// </summary>
+    /// <param name="id">Caller-chosen object id.</param>
+    /// <param name="position">Position relative to Earth (inertial, Z = rotation axis, sim units).</param>
+    /// <param name="velocity">Velocity (units/s).</param>
+    /// <param name="epoch">Simulation time of the state (s).</param>
+    /// <param name="hardBodyRadius">Hard-body radius used for collision probability (units).</param>
+    /// <returns>Catalog index of the object.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogUpsert", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogUpsert(int id, double3 position, double3 velocity, double epoch, double hardBodyRadius);
+
+    /// <summary>
+    /// Removes an object from the native catalog. Returns 1 if it existed.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogRemove", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogRemove(int id);
+
+    /// <summary>
+    /// Removes every object from the native catalog.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogClear", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void CatalogClear();
+
+    /// <summary>
+    /// Number of objects in the native catalog.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogCount", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogCount();
+
+    /// <summary>
+    /// Propagates a catalog object to a given time. Returns 0 if the id is unknown.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogGetState", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogGetState(int id, double time, out double3 position, out double3 velocity);
+
+    /// <summary>
+    /// Sets the ballistic coefficient (Cd·A/m in m²/kg) used for drag decay; 0 disables drag.
+    /// Returns 1 if the object exists.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogSetBallisticCoefficient", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogSetBallisticCoefficient(int id, double ballisticCoefficient);
+
+    /// <summary>
+    /// Mean elements of a catalog object at a given time. Returns 0 if the id is unknown.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogGetMeanElements", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogGetMeanElements(int id, double time, out OrbitalElements elements);
+
+    /// <summary>
+    /// Propagates every catalog object to a given time in parallel.
+    /// </summary>
+    /// <param name="time">Simulation time (s).</param>
+    /// <param name="ids">Output ids.</param>
+    /// <param name="positions">Output positions.</param>
+    /// <param name="velocities">Output velocities.</param>
+    /// <param name="valid">Output flags, 0 where propagation failed (e.g. decayed), or null.</param>
+    /// <param name="maxCount">Capacity of the output arrays.</param>
+    /// <returns>Number of objects written.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogGetStates", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogGetStates(
+        double time,
+        [Out] int[] ids,
+        [Out] double3[] positions,
+        [Out] double3[] velocities,
+        [Out] int[] valid,
+        int maxCount
+    );
+
+    /// <summary>
+    /// A close approach found by <see cref="CatalogScreen"/>. Layout mirrors the native <c>ConjunctionEvent</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct ConjunctionEvent
+    {
+        public double tca;
+        public double missDistance;
+        public double relativeSpeed;
+        public double pc;
+        public int objectId;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// Screens a state against the native catalog over a time span.
+    /// </summary>
+    /// <param name="position">State position at startTime (inertial, Z = rotation axis, sim units).</param>
+    /// <param name="velocity">State velocity (units/s).</param>
+    /// <param name="startTime">Simulation time of the state and start of the span (s).</param>
+    /// <param name="endTime">End of the span (s).</param>
+    /// <param name="step">Sampling step (s).</param>
+    /// <param name="threshold">Miss distance below which a conjunction is reported (units).</param>
+    /// <param name="sigmaRtn">Combined 1-sigma position uncertainty along R, T, N (units).</param>
+    /// <param name="hardBodyRadius">Hard-body radius of the screened object (units).</param>
+    /// <param name="excludeId">Catalog id of the screened object itself, or -1.</param>
+    /// <param name="conjunctions">Output conjunctions sorted by TCA.</param>
+    /// <param name="maxConjunctions">Capacity of the output array.</param>
+    /// <returns>Number of conjunctions found (only the first maxConjunctions are written).</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogScreen", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogScreen(
+        double3 position,
+        double3 velocity,
+        double startTime,
+        double endTime,
+        double step,
+        double threshold,
+        double3 sigmaRtn,
+        double hardBodyRadius,
+        int excludeId,
+        [Out] ConjunctionEvent[] conjunctions,
+        int maxConjunctions
+    );
+
+    /// <summary>
+    /// Settings for <see cref="PlanCollisionAvoidance"/>. Layout mirrors the native <c>AvoidanceSettings</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AvoidanceSettings
+    {
+        public double earliestBurn;
+        public double latestBurn;
+        public double pcThreshold;
+        public double maxDeltaV;
+        public double screenThreshold;
+        public double screenStep;
+        public double screenEnd;
+        public double hardBodyRadius;
+        public double3 sigmaRtn;
+        public int numBurnTimes;
+        public int maxRescreens;
+    }
+
+    /// <summary>
+    /// One candidate avoidance maneuver. Layout mirrors the native <c>AvoidanceOption</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AvoidanceOption
+    {
+        public double burnTime;
+        public double3 deltaV;
+        public double3 deltaVRtn;
+        public double magnitude;
+        public double targetPc;
+        public double targetMiss;
+        public double maxOtherPc;
+        public int otherConjunctions;
+        public int feasible;
+    }
+
+    /// <summary>
+    /// Searches burn time and direction for the cheapest impulse that brings a conjunction's
+    /// probability of collision under the threshold, and re-screens each option against the catalog.
+    /// </summary>
+    /// <param name="position">State of the maneuvering object at epoch (inertial, Z = rotation axis, sim units).</param>
+    /// <param name="velocity">Velocity at epoch (units/s).</param>
+    /// <param name="epoch">Simulation time of the state (s).</param>
+    /// <param name="selfId">Catalog id of the maneuvering object, or -1.</param>
+    /// <param name="secondaryId">Catalog id of the conjunction's other object.</param>
+    /// <param name="tca">Time of closest approach (s).</param>
+    /// <param name="settings">Search settings.</param>
+    /// <param name="options">Output options, feasible first, each group by increasing delta-v.</param>
+    /// <param name="maxOptions">Capacity of the output array.</param>
+    /// <returns>Number of options written, or -1 if the conjunction could not be located.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "PlanCollisionAvoidance", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int PlanCollisionAvoidance(
+        double3 position,
+        double3 velocity,
+        double epoch,
+        int selfId,
+        int secondaryId,
+        double tca,
+        ref AvoidanceSettings settings,
+        [Out] AvoidanceOption[] options,
+        int maxOptions
+    );
+
+    /// <summary>
+    /// Queues an impulsive maneuver for a catalog object.
+    /// </summary>
+    /// <param name="id">Object id.</param>
+    /// <param name="time">Burn time (s).</param>
+    /// <param name="deltaV">Impulse in the inertial frame (units/s).</param>
+    /// <returns>Handle of the maneuver.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "ManeuverScheduleAdd", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ManeuverScheduleAdd(int id, double time, double3 deltaV);
+
+    /// <summary>
+    /// Cancels a queued maneuver. Returns 1 if it was pending.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ManeuverScheduleCancel", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ManeuverScheduleCancel(int handle);
+
+    /// <summary>
+    /// Cancels every queued maneuver of an object. Returns the number removed.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ManeuverScheduleCancelObject", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ManeuverScheduleCancelObject(int id);
+
+    /// <summary>
+    /// Number of queued maneuvers across all objects.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ManeuverSchedulePendingCount", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ManeuverSchedulePendingCount();
+
+    /// <summary>
+    /// Applies every maneuver due at or before the given time. Returns the number applied.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ManeuverScheduleExecute", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ManeuverScheduleExecute(double time);
+
+    /// <summary>
+    /// Dead-band box for <see cref="StationKeepingAssign"/>. Layout mirrors the native <c>StationKeepingBox</c> struct.
+    /// regime 0 is GEO (longitude/inclination), 1 is LEO (along-track/altitude).
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct StationKeepingBox
+    {
+        public int regime;
+        public int reserved;
+        public double longitude;
+        public double longitudeHalfWidth;
+        public double inclinationMax;
+        public double semiMajorAxis;
+        public double altitudeHalfWidth;
+        public double referenceEpoch;
+        public double argumentOfLatitude;
+        public double alongTrackHalfWidth;
+        public double driftTime;
+        public double minBurnSpacing;
+        public double maxBurn;
+    }
+
+    /// <summary>
+    /// Controller state of a station-kept object. Layout mirrors the native <c>StationKeepingStatus</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct StationKeepingStatus
+    {
+        public double alongTrackError;
+        public double alongTrackRate;
+        public double semiMajorAxisError;
+        public double inclination;
+        public double totalDeltaV;
+        public double lastBurnTime;
+        public int burns;
+        public int pending;
+    }
+
+    /// <summary>
+    /// Places a catalog object under station keeping, or replaces its box.
+    /// Returns 0 if the id is not in the catalog.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "StationKeepingAssign", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int StationKeepingAssign(int id, ref StationKeepingBox box);
+
+    /// <summary>
+    /// Removes an object from station keeping and cancels its pending maneuvers.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "StationKeepingRemove", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int StationKeepingRemove(int id);
+
+    /// <summary>
+    /// Advances every station-keeping controller to the given time, planning and executing burns
+    /// through the maneuver schedule. Safe to call once per frame at any warp.
+    /// </summary>
+    /// <param name="time">Simulation time (s).</param>
+    /// <returns>Number of maneuvers executed.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "StationKeepingUpdate", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int StationKeepingUpdate(double time);
+
+    /// <summary>
+    /// Reads the controller state of a station-kept object. Returns 0 if it is not controlled.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "StationKeepingGetStatus", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int StationKeepingGetStatus(int id, out StationKeepingStatus status);
+
+    /// <summary>
+    /// Classical elements (radians, sim units) in the native frame. Layout mirrors the native <c>OrbitalElements</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct OrbitalElements
+    {
+        public double a;
+        public double e;
+        public double i;
+        public double raan;
+        public double argp;
+        public double meanAnomaly;
+    }
+
+    /// <summary>
+    /// Converts one osculating state to Brouwer–Lyddane mean elements.
+    /// </summary>
+    /// <param name="position">Position relative to Earth (Z along the rotation axis, sim units).</param>
+    /// <param name="velocity">Velocity (units/s).</param>
+    /// <param name="mu">Gravitational parameter (sim units).</param>
+    /// <param name="mean">Output mean elements.</param>
+    /// <returns>1 on success, 0 for unbound or sub-surface orbits.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "OsculatingToMeanSingle", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int OsculatingToMeanSingle(double3 position, double3 velocity, double mu, out OrbitalElements mean);
+
+    /// <summary>
+    /// Converts a batch of osculating states to mean elements in parallel.
+    /// </summary>
+    /// <param name="positions">Positions relative to Earth.</param>
+    /// <param name="velocities">Velocities.</param>
+    /// <param name="count">Number of states.</param>
+    /// <param name="mu">Gravitational parameter (sim units).</param>
+    /// <param name="mean">Output mean elements.</param>
+    /// <param name="ok">Output success flags, or null.</param>
+    /// <returns>Number of states converted.</returns>
+    [DllImport("PhysicsPlugin", EntryPoint = "OsculatingToMeanBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int OsculatingToMeanBatch(
+        double3[] positions,
+        double3[] velocities,
+        int count,
+        double mu,
+        [Out] OrbitalElements[] mean,
+        [Out] int[] ok
+    );
+
+    /// <summary>
+    /// Converts a batch of mean elements to osculating states in parallel.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "MeanToOsculatingBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void MeanToOsculatingBatch(
+        OrbitalElements[] mean,
+        int count,
+        double mu,
+        [Out] double3[] positions,
+        [Out] double3[] velocities
+    );
+
+    /// <summary>
+    /// Compound range query on catalog mean elements. Altitudes are above Earth's radius (sim units),
+    /// angles in radians; a RAAN range with raanMin &gt; raanMax wraps through zero.
+    /// Layout mirrors the native <c>RegimeQuery</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct RegimeQuery
+    {
+        public double perigeeMin;
+        public double perigeeMax;
+        public double apogeeMin;
+        public double apogeeMax;
+        public double inclinationMin;
+        public double inclinationMax;
+        public double raanMin;
+        public double raanMax;
+        /// <summary>Active ranges: 1 perigee, 2 apogee, 4 inclination, 8 RAAN.</summary>
+        public int filters;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// Finds catalog objects whose mean elements at <paramref name="time"/> satisfy every active range.
+    /// Returns the number of matches, which may exceed <paramref name="maxIds"/>.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogQuery", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogQuery(double time, ref RegimeQuery query, [Out] int[] ids, int maxIds);
+
+    /// <summary>
+    /// Query volume for trajectory-index transits. Type 0 is the box [a, b]; type 1 is a corridor of
+    /// the given radius around the segment a-b. Inertial coordinates relative to Earth (sim units).
+    /// Layout mirrors the native <c>TransitRegion</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TransitRegion
+    {
+        public double3 a;
+        public double3 b;
+        public double radius;
+        public int type;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// First entry of an object into a query region. Layout mirrors the native <c>TransitHit</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TransitHit
+    {
+        public double entryTime;
+        public int objectId;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// Propagates the catalog over [t0, t1] and builds the spatio-temporal trajectory index.
+    /// Returns the number of objects indexed.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TrajectoryIndexBuild", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TrajectoryIndexBuild(double t0, double t1, double step, int bucketSteps);
+
+    /// <summary>
+    /// Objects passing through a region during [ta, tb], sorted by entry time.
+    /// Returns the number of transiting objects, which may exceed <paramref name="maxHits"/>.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TrajectoryIndexQuery", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TrajectoryIndexQuery(ref TransitRegion region, double ta, double tb, [Out] TransitHit[] hits, int maxHits);
+
+    /// <summary>
+    /// Releases the trajectory index.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TrajectoryIndexClear", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void TrajectoryIndexClear();
+
+    /// <summary>
+    /// Re-propagates only the catalog entries changed since the trajectory index was built. Returns the number refreshed, or -1 without an index.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TrajectoryIndexRefresh", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TrajectoryIndexRefresh();
+
+    /// <summary>
+    /// An object entering or leaving a watch volume. Layout mirrors the native <c>WatchAlert</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct WatchAlert
+    {
+        public double time;
+        public double distance;
+        public double3 offsetRtn;
+        public int watchHandle;
+        public int objectId;
+        public int entered;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// Watches an ellipsoid (semi-axes along radial, along-track, cross-track, in sim units) around a
+    /// catalog object. Returns the watch handle, or 0 for invalid semi-axes.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "WatchVolumeAdd", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int WatchVolumeAdd(int objectId, double3 semiAxesRtn);
+
+    /// <summary>
+    /// Stops a watch. Returns 1 if the handle existed.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "WatchVolumeRemove", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int WatchVolumeRemove(int handle);
+
+    /// <summary>
+    /// Updates every watch volume to <paramref name="time"/> and writes entry/exit alerts.
+    /// Returns the number of alerts, which may exceed <paramref name="maxAlerts"/>.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "WatchVolumeUpdate", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int WatchVolumeUpdate(double time, [Out] WatchAlert[] alerts, int maxAlerts);
+
+    /// <summary>
+    /// Result of a screen-ray pick. Layout mirrors the native <c>PickHit</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct PickHit
+    {
+        public double distance;
+        public double offset;
+        public int id;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// Sets this frame's render positions of the pickable objects. The native BVH is refitted while
+    /// the ids are unchanged and rebuilt otherwise.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "PickSetPositions", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void PickSetPositions(int[] ids, double3[] positions, int count);
+
+    /// <summary>
+    /// Picks the object closest to a ray in screen space. <paramref name="tanTolerance"/> is the tangent of
+    /// the pick tolerance (pixels times the angle per pixel). Returns 1 on a hit.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "PickRay", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int PickRay(double3 origin, double3 direction, double tanTolerance, double minRadius, out PickHit hit);
+
+    /// <summary>
+    /// Camera and styling for <see cref="CatalogFillInstances"/>. Colours are packed RGBA per regime
+    /// (LEO, MEO, GEO, HEO, other). Layout mirrors the native <c>InstanceSettings</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InstanceSettings
+    {
+        public double3 camera;
+        public double angularSize;
+        public double minSize;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 5)]
+        public uint[] regimeColors;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// One instance of the packed render buffer: camera-relative position in Unity axes, size (0 when
+    /// the object could not be propagated), packed RGBA colour and catalog id.
+    /// Layout mirrors the native <c>InstanceData</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct InstanceData
+    {
+        public float x;
+        public float y;
+        public float z;
+        public float size;
+        public uint color;
+        public int id;
+    }
+
+    /// <summary>
+    /// Writes one instance per catalog object at <paramref name="time"/>, in catalog order, ready for an
+    /// instanced draw call. Returns the number of instances written.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogFillInstances", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogFillInstances(double time, ref InstanceSettings settings, [Out] InstanceData[] instances, int maxInstances);
+
+    /// <summary>
+    /// Geodetic coordinates on the WGS-84 ellipsoid (radians, km). Layout mirrors the native <c>GeodeticPoint</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct GeodeticPoint
+    {
+        public double latitude;
+        public double longitude;
+        public double altitudeKm;
+    }
+
+    /// <summary>
+    /// Converts inertial positions (native frame, sim units) at the given times to geodetic coordinates.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "InertialToGeodeticBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InertialToGeodeticBatch(double[] times, double3[] positions, int count, [Out] GeodeticPoint[] geodetic);
+
+    /// <summary>
+    /// Converts Earth-fixed positions (sim units) to geodetic coordinates.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "EarthFixedToGeodeticBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void EarthFixedToGeodeticBatch(double3[] positions, int count, [Out] GeodeticPoint[] geodetic);
+
+    /// <summary>
+    /// Ground tracks of catalog objects, <paramref name="samples"/> points each over [t0, t1], object-major.
+    /// Points are NaN where an object is unknown or decayed. Returns the number of tracks computed.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogGroundTracks", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogGroundTracks(int[] ids, int idCount, double t0, double t1, int samples, [Out] GeodeticPoint[] tracks);
+
+    /// <summary>
+    /// Greenwich apparent sidereal time (radians) at a simulation time.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "FrameGetSiderealAngle", CallingConvention = CallingConvention.Cdecl)]
+    public static extern double FrameGetSiderealAngle(double time);
+
+    /// <summary>
+    /// GCRF-to-ITRF rotation at a simulation time as a row-major 3x3 matrix (9 doubles, native axes).
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "FrameGetCelestialToTerrestrial", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void FrameGetCelestialToTerrestrial(double time, [Out] double[] matrix);
+
+    /// <summary>
+    /// Transforms inertial positions (native axes) at the given times to Earth-fixed positions.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "InertialToEarthFixedBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void InertialToEarthFixedBatch(double[] times, double3[] positions, int count, [Out] double3[] earthFixed);
+
+    /// <summary>
+    /// Time scales understood by the native time conversions.
+    /// </summary>
+    public enum TimeScale
+    {
+        UTC = 0,
+        TAI = 1,
+        TT = 2,
+        TDB = 3,
+    }
+
+    /// <summary>
+    /// Two-part Julian date. Layout mirrors the native <c>JulianDate</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct JulianDate
+    {
+        public double day;
+        public double fraction;
+
+        public JulianDate(double day, double fraction)
+        {
+            this.day = day;
+            this.fraction = fraction;
+        }
+    }
+
+    /// <summary>
+    /// Loads TAI - UTC steps from a leap-seconds.list file. Returns the number of steps, or 0 if the built-in table was kept.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TimeLoadLeapSeconds", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TimeLoadLeapSeconds(string path);
+
+    /// <summary>
+    /// Sets the date of simulation time 0. Simulation time counts TT seconds from it.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TimeSetEpoch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TimeSetEpoch(TimeScale scale, JulianDate date);
+
+    /// <summary>
+    /// Date of simulation time 0 in the given time scale.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TimeGetEpoch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TimeGetEpoch(TimeScale scale, out JulianDate date);
+
+    /// <summary>
+    /// Converts dates between time scales.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TimeConvertBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TimeConvertBatch(JulianDate[] dates, int count, TimeScale from, TimeScale to, [Out] JulianDate[] output);
+
+    /// <summary>
+    /// Converts simulation times (seconds) to dates in the given time scale.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TimeSimulationToDateBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TimeSimulationToDateBatch(double[] times, int count, TimeScale scale, [Out] JulianDate[] dates);
+
+    /// <summary>
+    /// Converts dates in the given time scale to simulation times (seconds).
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TimeDateToSimulationBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TimeDateToSimulationBatch(JulianDate[] dates, int count, TimeScale scale, [Out] double[] times);
+
+    /// <summary>
+    /// Loads Earth orientation parameters (polar motion, UT1 - UTC) from an IERS finals file. Returns the number of daily rows, or 0 on failure.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "EopLoad", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int EopLoad(string path);
+
+    /// <summary>
+    /// Pole coordinates (arcsec) and UT1 - UTC (seconds) at a simulation time. Returns 0 outside the loaded table.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "EopGet", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int EopGet(double time, out double xp, out double yp, out double ut1MinusUtc);
+
+    /// <summary>
+    /// Outcome of a catalog update file. Layout mirrors the native <c>CatalogUpdateStats</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct CatalogUpdateStats
+    {
+        public int added;
+        public int updated;
+        public int unchanged;
+        public int tombstoned;
+        public int rejected;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// Applies a TLE update file to the catalog in place, keyed by NORAD number ("DECAY n" lines tombstone objects).
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "CatalogApplyUpdateFile", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int CatalogApplyUpdateFile(string path, out CatalogUpdateStats stats);
+
+    /// <summary>
+    /// Opens (or creates) an append-only element-set history file and indexes it by object and epoch.
+    /// Returns the number of records, or -1 on failure.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ElementHistoryOpen", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ElementHistoryOpen(string path);
+
+    /// <summary>
+    /// Closes the open element-set history.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ElementHistoryClose", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void ElementHistoryClose();
+
+    /// <summary>
+    /// Appends the element sets of a TLE file to the open history, skipping ones already stored.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ElementHistoryAppendTleFile", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ElementHistoryAppendTleFile(string path);
+
+    /// <summary>
+    /// Number of element sets stored for an object.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ElementHistoryCount", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ElementHistoryCount(int id);
+
+    /// <summary>
+    /// States of objects at past or future simulation times, each propagated with SGP4 from the nearest
+    /// element set at or before its time. <paramref name="valid"/> is 0 where no such set exists.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "ElementHistoryStateBatch", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int ElementHistoryStateBatch(
+        int[] ids,
+        double[] times,
+        int count,
+        [Out] double3[] positions,
+        [Out] double3[] velocities,
+        [Out] int[] valid);
+
+    /// <summary>
+    /// One stage of a launch vehicle. Layout mirrors the native <c>AscentStage</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AscentStage
+    {
+        public double dryMass;
+        public double propellantMass;
+        public double thrustVacuum;
+        public double ispVacuum;
+        public double ispSeaLevel;
+        public double ignitionDelay;
+    }
+
+    /// <summary>
+    /// Launch site, vehicle and target orbit (angles in radians, altitudes in km).
+    /// Layout mirrors the native <c>AscentVehicle</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AscentVehicle
+    {
+        public double payloadMass;
+        public double referenceArea;
+        public double dragCoefficient;
+        public double latitude;
+        public double longitude;
+        public double altitudeKm;
+        public double launchAzimuth;
+        public double targetApogeeKm;
+        public double targetPerigeeKm;
+    }
+
+    /// <summary>
+    /// Final state of a simulated ascent.
+    /// </summary>
+    public enum AscentStatus
+    {
+        Invalid = 0,
+        Inserted = 1,
+        PropellantExhausted = 2,
+        Impact = 3,
+        Timeout = 4,
+    }
+
+    /// <summary>
+    /// Outcome of one ascent. Layout mirrors the native <c>AscentResult</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct AscentResult
+    {
+        public int status;
+        public int stage;
+        public double endTime;
+        public double3 position;
+        public double3 velocity;
+        public double apogeeKm;
+        public double perigeeKm;
+        public double inclination;
+        public double raan;
+        public double propellantRemaining;
+        public double maxDynamicPressure;
+    }
+
+    /// <summary>
+    /// Flies a launch ascent from liftoff at <paramref name="launchTime"/> to orbit insertion.
+    /// <paramref name="pitchProgram"/> holds (seconds since liftoff, pitch from vertical in radians) pairs.
+    /// On insertion the object is added to the catalog as <paramref name="catalogId"/> (0 to skip).
+    /// Returns the number of track samples written, or -1 for invalid input.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "AscentSimulate", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int AscentSimulate(
+        ref AscentVehicle vehicle,
+        AscentStage[] stages,
+        int stageCount,
+        double[] pitchProgram,
+        int pitchCount,
+        double launchTime,
+        int catalogId,
+        out AscentResult result,
+        [Out] double3[] track,
+        int maxTrack);
+
+    /// <summary>
+    /// Flies the same ascent at each launch time in parallel. Returns the number of insertions, or -1 for invalid input.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "AscentSweep", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int AscentSweep(
+        ref AscentVehicle vehicle,
+        AscentStage[] stages,
+        int stageCount,
+        double[] pitchProgram,
+        int pitchCount,
+        double[] launchTimes,
+        int count,
+        [Out] AscentResult[] results);
+
+    /// <summary>
+    /// Kind of ground sensor.
+    /// </summary>
+    public enum SensorType
+    {
+        Fence = 0,
+        Optical = 1,
+    }
+
+    /// <summary>
+    /// A ground radar fence or optical sensor. Angles in radians, azimuths clockwise from north.
+    /// Layout mirrors the native <c>SensorSpec</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SensorSpec
+    {
+        public double latitude;
+        public double longitude;
+        public double altitudeKm;
+        public double azimuth;
+        public double elevation;
+        public double halfAngle;
+        public double minElevation;
+        public double maxRangeKm;
+        public int type;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// One sensor detection. Layout mirrors the native <c>SensorDetection</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct SensorDetection
+    {
+        public double time;
+        public double rangeKm;
+        public double azimuth;
+        public double elevation;
+        public int objectId;
+        public int sensor;
+    }
+
+    /// <summary>
+    /// Detects every catalog object crossing a fence or passing through an optical field of view
+    /// between <paramref name="t0"/> and <paramref name="t1"/>, sorted by time. Returns the total
+    /// number of detections, which may exceed <paramref name="maxDetections"/>.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "SensorDetectCrossings", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int SensorDetectCrossings(
+        SensorSpec[] sensors,
+        int sensorCount,
+        double t0,
+        double t1,
+        [Out] SensorDetection[] detections,
+        int maxDetections);
+
+    /// <summary>
+    /// Observation timing of one sensor. Layout mirrors the native <c>TaskingSensor</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TaskingSensor
+    {
+        public double slotSeconds;
+        public double settleSeconds;
+    }
+
+    /// <summary>
+    /// Custody requirement of one object; <c>lastObserved</c> is negative infinity if never observed.
+    /// Layout mirrors the native <c>TaskingObject</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TaskingObject
+    {
+        public double priority;
+        public double revisitSeconds;
+        public double lastObserved;
+        public int objectId;
+        public int reserved;
+    }
+
+    /// <summary>
+    /// Interval in which a sensor can observe an object. Layout mirrors the native <c>TaskingWindow</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TaskingWindow
+    {
+        public double start;
+        public double end;
+        public int objectId;
+        public int sensor;
+    }
+
+    /// <summary>
+    /// One scheduled observation. Layout mirrors the native <c>TaskingAssignment</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct TaskingAssignment
+    {
+        public double start;
+        public double end;
+        public double gain;
+        public int objectId;
+        public int sensor;
+    }
+
+    /// <summary>
+    /// Schedules observations over access windows between <paramref name="t0"/> and <paramref name="t1"/>,
+    /// greedily maximising priority-weighted custody. Assignments are sorted by start time.
+    /// <paramref name="custodyFraction"/> receives each object's fraction of the horizon in custody and may be null.
+    /// Returns the total number of observations, which may exceed <paramref name="maxAssignments"/>, or -1 for invalid input.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "TaskingSchedule", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int TaskingSchedule(
+        TaskingSensor[] sensors,
+        int sensorCount,
+        TaskingObject[] objects,
+        int objectCount,
+        TaskingWindow[] windows,
+        int windowCount,
+        double t0,
+        double t1,
+        [Out] TaskingAssignment[] assignments,
+        int maxAssignments,
+        [Out] double[] custodyFraction);
+
+    /// <summary>
+    /// Operation of a mission sequence step.
+    /// </summary>
+    public enum MissionOp
+    {
+        Wait = 0,
+        WaitUntil = 1,
+        WaitOrbits = 2,
+        WaitEvent = 3,
+        Impulse = 4,
+        Burn = 5,
+        Circularize = 6,
+    }
+
+    /// <summary>
+    /// Orbit event a mission step can wait for.
+    /// </summary>
+    public enum MissionEvent
+    {
+        Time = 0,
+        Apoapsis = 1,
+        Periapsis = 2,
+        AscendingNode = 3,
+        DescendingNode = 4,
+        Altitude = 5,
+    }
+
+    /// <summary>
+    /// State of an object's mission script.
+    /// </summary>
+    public enum MissionState
+    {
+        None = 0,
+        Waiting = 1,
+        Finished = 2,
+        Failed = 3,
+    }
+
+    /// <summary>
+    /// One mission sequence step. <c>value</c> is seconds, an absolute time, revolutions, an altitude (km)
+    /// or a burn duration (s), depending on <c>op</c>. <c>vector</c> is an impulse (units/s) or an
+    /// acceleration (units/s²) as (prograde, normal, radial-out).
+    /// Layout mirrors the native <c>MissionStep</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MissionStep
+    {
+        public int op;
+        public int missionEvent;
+        public int direction;
+        public int reserved;
+        public double value;
+        public double3 vector;
+    }
+
+    /// <summary>
+    /// State of one object's mission script. Layout mirrors the native <c>MissionStatus</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct MissionStatus
+    {
+        public int state;
+        public int step;
+        public int waitEvent;
+        public int burns;
+        public double nextEventTime;
+        public double lastEventTime;
+        public double totalDeltaV;
+    }
+
+    /// <summary>
+    /// Starts a mission sequence on a catalog object, replacing any running script. It runs up to its first wait immediately.
+    /// Returns 1 if started, 0 if the object is not in the catalog, -1 for invalid input.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "MissionLoadSequence", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int MissionLoadSequence(int id, MissionStep[] steps, int count, double time);
+
+    /// <summary>
+    /// Stops an object's mission script. Returns 1 if it had one.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "MissionCancel", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int MissionCancel(int id);
+
+    /// <summary>
+    /// Resumes every mission script whose awaited event has occurred by <paramref name="time"/>.
+    /// Returns the number of events delivered.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "MissionUpdate", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int MissionUpdate(double time);
+
+    /// <summary>
+    /// Reads the script state of an object. Returns 1 if the object has or had a script.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "MissionGetStatus", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int MissionGetStatus(int id, out MissionStatus status);
+
+    /// <summary>
+    /// Per-frame work measured by the frame-time budget controller.
+    /// </summary>
+    public enum BudgetSubsystem
+    {
+        Physics = 0,
+        Prediction = 1,
+        Trails = 2,
+        Catalog = 3,
+    }
+
+    /// <summary>
+    /// Frame-time budget controller state; times in ms. Level 0 is full quality, each level halves the work.
+    /// Layout mirrors the native <c>BudgetStats</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BudgetStats
+    {
+        public double targetMs;
+        public double frameMs;
+        public double lastFrameMs;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)]
+        public double[] costMs;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)]
+        public double[] lastCostMs;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)]
+        public int[] level;
+        [MarshalAs(UnmanagedType.ByValArray, SizeConst = 4)]
+        public int[] maxLevel;
+        public int frames;
+        public int degradations;
+        public int restorations;
+        public int overloaded;
+    }
+
+    /// <summary>
+    /// One quality level change. <c>reason</c> is 0 degraded, 1 restored, 2 clamped by <see cref="BudgetSetMaxLevel"/>.
+    /// Layout mirrors the native <c>BudgetDecision</c> struct.
+    /// </summary>
+    [StructLayout(LayoutKind.Sequential)]
+    public struct BudgetDecision
+    {
+        public int frame;
+        public int subsystem;
+        public int level;
+        public int reason;
+        public double frameMs;
+        public double costMs;
+    }
+
+    /// <summary>
+    /// Books managed-side work (ms) against a subsystem for the current frame.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetReport", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void BudgetReport(int subsystem, double milliseconds);
+
+    /// <summary>
+    /// Closes a frame and may shed or restore one quality level. Call once per frame.
+    /// Returns a bitmask of the subsystems whose level changed.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetEndFrame", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int BudgetEndFrame(double frameMs);
+
+    /// <summary>
+    /// Sets the frame-time target (ms).
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetSetTarget", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void BudgetSetTarget(double targetMs);
+
+    /// <summary>
+    /// Limits how far a subsystem may be degraded; 0 pins it at full quality.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetSetMaxLevel", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void BudgetSetMaxLevel(int subsystem, int maxLevel);
+
+    /// <summary>
+    /// Quality level of a subsystem; 0 is full quality.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetGetLevel", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int BudgetGetLevel(int subsystem);
+
+    /// <summary>
+    /// Work fraction of a subsystem (1, 1/2, 1/4, ...); scale sample counts or resolution by it.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetGetQuality", CallingConvention = CallingConvention.Cdecl)]
+    public static extern double BudgetGetQuality(int subsystem);
+
+    /// <summary>
+    /// Reads the controller state.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetGetStats", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void BudgetGetStats(out BudgetStats stats);
+
+    /// <summary>
+    /// Copies the most recent level changes, oldest first. Returns the number written.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetGetDecisions", CallingConvention = CallingConvention.Cdecl)]
+    public static extern int BudgetGetDecisions([Out] BudgetDecision[] decisions, int maxDecisions);
+
+    /// <summary>
+    /// Restores full quality everywhere and clears the statistics; the target and the limits set with
+    /// <see cref="BudgetSetMaxLevel"/> are kept.
+    /// </summary>
+    [DllImport("PhysicsPlugin", EntryPoint = "BudgetReset", CallingConvention = CallingConvention.Cdecl)]
+    public static extern void BudgetReset();
 }
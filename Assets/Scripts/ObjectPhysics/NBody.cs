@@ -19,6 +19,10 @@ public class NBody : MonoBehaviour
     public float cameraDistanceRadius = 637f;
     public double trueMass = 5.0e21;
 
+    [Header("Integrator")]
+    [Tooltip("Propagation scheme used for this body")]
+    public IntegratorMode integratorMode = IntegratorMode.DormandPrince;
+
     [Header("Trajectory Prediction Settings")]
     public float predictionDeltaTime = .5f;
 
@@ -37,14 +41,21 @@ public class NBody : MonoBehaviour
     public float dragCoefficient = 2.2f;
 
     [Header("Constants")]
-    private const float EarthRotationRate = 360f / (24f * 60f * 60f);
     private const float EarthRadiusKm = 637.8137f;
+    private const float EarthRotationRate = 360f / (24f * 60f * 60f);
 
     public OrbitalState state;
+    private NativePhysics.EnckeState enckeState;
+    private int primaryBodyIndex = -1;
 
     private GravityManager gravityManager;
     private List<NBody> relevantBodies;
 
+    // Central body: rotation and sidereal angle at simulation time 0, so the Earth model follows
+    // the native sidereal angle instead of accumulating a per-step rotation.
+    private Quaternion initialRotation;
+    private double initialSiderealAngle;
+
     /// <summary>
     /// Initializes trajectory data and sets the body to static if it's the central body.
     /// </summary>
@@ -53,6 +64,11 @@ public class NBody : MonoBehaviour
         if (isCentralBody)
         {
             velocity = Vector3.zero;
+            initialRotation = transform.rotation;
+            if (NativePhysics.HasEntryPoint(nameof(NativePhysics.FrameGetSiderealAngle)))
+            {
+                initialSiderealAngle = NativePhysics.FrameGetSiderealAngle(0.0);
+            }
             Debug.Log($"[NBODY]: {gameObject.name} is the central body and will not move.");
         }
 
@@ -81,8 +97,10 @@ public class NBody : MonoBehaviour
             Vector3.zero
         );
 
+        // Central body first: the native propagators treat bodies[0] as the primary.
         relevantBodies = gravityManager.Bodies
        .Where(b => b != this && (b.isCentralBody || b.name == "Moon"))
+       .OrderByDescending(b => b.isCentralBody)
        .ToList();
     }
 
@@ -126,11 +144,16 @@ public class NBody : MonoBehaviour
     }
 
     /// <summary>
-    /// Simulates Earth-like rotation for the central body.
+    /// Rotates the central body to the native sidereal angle (IAU 2006/2000B), so the rendered Earth
+    /// matches the Earth-fixed frame used by drag, ground tracks and station keeping.
     /// </summary>
     void RotateCentralBody()
     {
-        transform.Rotate(Vector3.up, -EarthRotationRate * Time.fixedDeltaTime);
+        // A plugin without the frame exports falls back to a constant rotation rate.
+        double angle = NativePhysics.HasEntryPoint(nameof(NativePhysics.FrameGetSiderealAngle))
+            ? (NativePhysics.FrameGetSiderealAngle(TimeController.SimulationTime) - initialSiderealAngle) * Mathf.Rad2Deg
+            : EarthRotationRate * TimeController.SimulationTime;
+        transform.rotation = initialRotation * Quaternion.AngleAxis(-(float)(angle % 360.0), Vector3.up);
     }
 
     /// <summary>
@@ -151,12 +174,37 @@ public class NBody : MonoBehaviour
             masses[i] = relevantBodies[i].trueMass;
         }
 
-        const float dtMax = 0.002f;
+        if (integratorMode == IntegratorMode.PatchedConic && NativePhysics.HasEntryPoint(nameof(NativePhysics.PatchedConicSingle)))
+        {
+            SimulatePatchedConicMotion(masses);
+            return;
+        }
+
+        // Encke only integrates the small deviation from a Kepler reference, so it tolerates far larger steps.
+        // A plugin without the Encke export falls back to Dormand-Prince.
+        bool encke = integratorMode == IntegratorMode.Encke && NativePhysics.HasEntryPoint(nameof(NativePhysics.EnckeSingle));
+        float dtMax = encke ? 0.02f : 0.002f;
         int substeps = Mathf.CeilToInt(Time.fixedDeltaTime / dtMax);
         float dt = Time.fixedDeltaTime / substeps;
 
         for (int s = 0; s < substeps; s++)
         {
+            if (encke)
+            {
+                NativePhysics.EnckeSingle(
+                    ref state.position,
+                    ref state.velocity,
+                    ref enckeState,
+                    state.mass,
+                    positions,
+                    masses,
+                    numBodies,
+                    dt,
+                    state.force
+                );
+                continue;
+            }
+
             NativePhysics.DormandPrinceSingle(
                 ref state.position,
                 ref state.velocity,
@@ -177,6 +225,61 @@ public class NBody : MonoBehaviour
         CheckCollisionWithEarth();
     }
 
+    /// <summary>
+    /// Integrates relative to the body whose sphere of influence currently contains this body.
+    /// The native step switches the integration origin at SOI boundaries, so lunar arcs are integrated Moon-relative.
+    /// </summary>
+    /// <param name="masses">Masses of relevantBodies, central body first.</param>
+    void SimulatePatchedConicMotion(double[] masses)
+    {
+        int numBodies = relevantBodies.Count;
+        var bodyPositions = new double3[numBodies];
+        var bodyVelocities = new double3[numBodies];
+
+        for (int i = 0; i < numBodies; i++)
+        {
+            bodyPositions[i] = relevantBodies[i].state.position;
+            bodyVelocities[i] = relevantBodies[i].state.velocity;
+        }
+
+        // Inside a secondary's sphere of influence the step is Moon-relative and the primary's field dominates,
+        // so it tolerates the same larger steps as Encke. Earth-relative arcs keep the Dormand-Prince limit.
+        float dtMax = primaryBodyIndex > 0 ? 0.02f : 0.002f;
+        int substeps = Mathf.CeilToInt(Time.fixedDeltaTime / dtMax);
+        float dt = Time.fixedDeltaTime / substeps;
+
+        for (int s = 0; s < substeps; s++)
+        {
+            int switched = NativePhysics.PatchedConicSingle(
+                ref state.position,
+                ref state.velocity,
+                ref primaryBodyIndex,
+                state.mass,
+                bodyPositions,
+                bodyVelocities,
+                masses,
+                numBodies,
+                dt,
+                state.force
+            );
+
+            if (switched != 0)
+            {
+                Debug.Log($"[NBODY]: {name} entered sphere of influence of {relevantBodies[primaryBodyIndex].name}");
+            }
+
+            for (int i = 0; i < numBodies; i++)
+            {
+                bodyPositions[i] += bodyVelocities[i] * dt;
+            }
+        }
+
+        transform.position = state.position.ToVector3();
+        velocity = state.velocity.ToVector3();
+
+        CheckCollisionWithEarth();
+    }
+
     /// <summary>
     /// Checks for collision with the central body and triggers a removal event if detected.
     /// </summary>
@@ -295,6 +398,16 @@ public class NBody : MonoBehaviour
         }
     }
 
+    /// <summary>
+    /// Selects how SimulateOrbitalMotion advances the body.
+    /// </summary>
+    public enum IntegratorMode
+    {
+        DormandPrince, // Full acceleration integrated with DOPRI5 substeps
+        Encke,         // Deviation from an osculating Kepler reference
+        PatchedConic   // Primary-relative integration with sphere-of-influence switching
+    }
+
     /// <summary>
     /// Represents the state of an orbit (position and velocity).
     /// Used for physics calculations.
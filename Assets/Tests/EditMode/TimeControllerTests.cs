@@ -0,0 +1,60 @@
+using System;
+using NUnit.Framework;
+
+/// <summary>
+/// Unit tests for TimeController.ToJulianDate.
+/// Checks known UTC to Julian date pairs and that the split keeps the day fraction in [0, 1).
+/// </summary>
+public class TimeControllerTests
+{
+    private const double Tolerance = 1e-12;
+
+    private static void AssertJulianDate(DateTime utc, double expectedDay, double expectedFraction)
+    {
+        NativePhysics.JulianDate jd = TimeController.ToJulianDate(utc);
+
+        Assert.AreEqual(expectedDay, jd.day, Tolerance);
+        Assert.AreEqual(expectedFraction, jd.fraction, Tolerance);
+        Assert.That(jd.fraction, Is.GreaterThanOrEqualTo(0.0).And.LessThan(1.0));
+    }
+
+    [Test]
+    public void ToJulianDate_UnixEpoch()
+    {
+        AssertJulianDate(new DateTime(1970, 1, 1, 0, 0, 0, DateTimeKind.Utc), 2440587.5, 0.0);
+    }
+
+    [Test]
+    public void ToJulianDate_J2000()
+    {
+        AssertJulianDate(new DateTime(2000, 1, 1, 12, 0, 0, DateTimeKind.Utc), 2451544.5, 0.5);
+    }
+
+    [Test]
+    public void ToJulianDate_LeapDay()
+    {
+        AssertJulianDate(new DateTime(2024, 2, 29, 6, 0, 0, DateTimeKind.Utc), 2460369.5, 0.25);
+    }
+
+    [Test]
+    public void ToJulianDate_BeforeUnixEpoch_FractionStaysPositive()
+    {
+        // Apollo 11 landing: JD 2440423.345601852.
+        AssertJulianDate(new DateTime(1969, 7, 20, 20, 17, 40, DateTimeKind.Utc), 2440422.5, 73060.0 / 86400.0);
+    }
+
+    [Test]
+    public void ToJulianDate_ModifiedJulianDateOrigin()
+    {
+        AssertJulianDate(new DateTime(1858, 11, 17, 0, 0, 0, DateTimeKind.Utc), 2400000.5, 0.0);
+    }
+
+    [Test]
+    public void ToJulianDate_KeepsSubMillisecondPrecision()
+    {
+        DateTime utc = new DateTime(2024, 2, 29, 6, 0, 0, DateTimeKind.Utc).AddTicks(1234);
+        NativePhysics.JulianDate jd = TimeController.ToJulianDate(utc);
+
+        Assert.AreEqual(0.25 + 1234.0 / TimeSpan.TicksPerDay, jd.fraction, 1e-15);
+    }
+}